@@ -0,0 +1,261 @@
+// Measures SimDataRefs (binding table, ranged array reads, coalesced writes) against one XPLMGetData / XPLMSetData
+// call per value, the sequence SimData used before the table. The XPLM accessors are stubbed here, so the numbers
+// are the plugin side cost per cycle plus a plain function call per accessor; X-Plane's own accessor cost comes on
+// top of every call and is what the lower call count saves in the simulator (inav_xitl/debug/dataRefTimeUs).
+// With the stubs, a HITL frame takes 0.06 - 0.1 us either way, the table is about 0.01 - 0.02 us slower and makes
+// 6 calls less, so it only pays off when an X-Plane accessor costs more than a few ns.
+// Build with -DBUILD_BENCHMARKS=ON, run ./dataref_benchmark [cycles] [replies per frame]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <string>
+
+#include "SimDataRefs.h"
+
+struct TStubDataRef
+{
+    std::string name;
+    double values[64];
+};
+
+static std::deque<TStubDataRef> stubDataRefs;
+static long accessorCalls = 0;
+
+XPLMDataRef XPLMFindDataRef(const char *inDataRefName)
+{
+    for (TStubDataRef &dataRef : stubDataRefs)
+    {
+        if (dataRef.name == inDataRefName)
+        {
+            return &dataRef;
+        }
+    }
+
+    TStubDataRef &dataRef = stubDataRefs.emplace_back();
+    dataRef.name = inDataRefName;
+    for (int i = 0; i < 64; i++)
+    {
+        dataRef.values[i] = static_cast<double>(stubDataRefs.size() * 100 + i);
+    }
+    return &dataRef;
+}
+
+// noinline: the stubs must not be inlined into the individual calls, the table reads call them from another unit
+[[gnu::noinline]] int XPLMGetDatai(XPLMDataRef inDataRef)
+{
+    accessorCalls++;
+    return static_cast<int>(static_cast<TStubDataRef *>(inDataRef)->values[0]);
+}
+
+[[gnu::noinline]] float XPLMGetDataf(XPLMDataRef inDataRef)
+{
+    accessorCalls++;
+    return static_cast<float>(static_cast<TStubDataRef *>(inDataRef)->values[0]);
+}
+
+[[gnu::noinline]] double XPLMGetDatad(XPLMDataRef inDataRef)
+{
+    accessorCalls++;
+    return static_cast<TStubDataRef *>(inDataRef)->values[0];
+}
+
+[[gnu::noinline]] int XPLMGetDatavf(XPLMDataRef inDataRef, float *outValues, int inOffset, int inMax)
+{
+    accessorCalls++;
+    const TStubDataRef *dataRef = static_cast<TStubDataRef *>(inDataRef);
+    for (int i = 0; i < inMax; i++)
+    {
+        outValues[i] = static_cast<float>(dataRef->values[inOffset + i]);
+    }
+    return inMax;
+}
+
+[[gnu::noinline]] void XPLMSetDatai(XPLMDataRef inDataRef, int inValue)
+{
+    accessorCalls++;
+    static_cast<TStubDataRef *>(inDataRef)->values[0] = inValue;
+}
+
+[[gnu::noinline]] void XPLMSetDataf(XPLMDataRef inDataRef, float inValue)
+{
+    accessorCalls++;
+    static_cast<TStubDataRef *>(inDataRef)->values[0] = inValue;
+}
+
+void XPLMDebugString(const char *inString)
+{
+    fputs(inString, stderr);
+}
+
+// The former call sequence: one call per value, every joystick axis read on its own
+class IndividualDataRefs
+{
+public:
+    IndividualDataRefs()
+    {
+        this->heartbeat = XPLMFindDataRef("inav_xitl/plugin/heartbeat");
+        this->paused = XPLMFindDataRef("sim/time/paused");
+        this->simSpeed = XPLMFindDataRef("sim/time/sim_speed_actual");
+        this->latitude = XPLMFindDataRef("sim/flightmodel/position/latitude");
+        this->longitude = XPLMFindDataRef("sim/flightmodel/position/longitude");
+        this->elevation = XPLMFindDataRef("sim/flightmodel/position/elevation");
+        this->local_vx = XPLMFindDataRef("sim/flightmodel/position/local_vx");
+        this->local_vy = XPLMFindDataRef("sim/flightmodel/position/local_vy");
+        this->local_vz = XPLMFindDataRef("sim/flightmodel/position/local_vz");
+        this->groundspeed = XPLMFindDataRef("sim/flightmodel/position/groundspeed");
+        this->airspeed = XPLMFindDataRef("sim/flightmodel/position/true_airspeed");
+        this->hpath = XPLMFindDataRef("sim/flightmodel/position/hpath");
+        this->roll = XPLMFindDataRef("sim/flightmodel/position/phi");
+        this->pitch = XPLMFindDataRef("sim/flightmodel/position/theta");
+        this->yaw = XPLMFindDataRef("sim/flightmodel/position/psi");
+        this->accel_x = XPLMFindDataRef("sim/flightmodel/forces/g_axil");
+        this->accel_y = XPLMFindDataRef("sim/flightmodel/forces/g_side");
+        this->accel_z = XPLMFindDataRef("sim/flightmodel/forces/g_nrml");
+        this->gyro_p = XPLMFindDataRef("sim/flightmodel/position/P");
+        this->gyro_q = XPLMFindDataRef("sim/flightmodel/position/Q");
+        this->gyro_r = XPLMFindDataRef("sim/flightmodel/position/R");
+        this->baro = XPLMFindDataRef("sim/weather/barometer_current_inhg");
+        this->hasJoystick = XPLMFindDataRef("sim/joystick/has_joystick");
+        this->joyAxis = XPLMFindDataRef("sim/joystick/joy_mapped_axis_value");
+        this->overrideJoystick = XPLMFindDataRef("sim/operation/override/override_joystick");
+        this->throttle = XPLMFindDataRef("sim/cockpit2/engine/actuators/throttle_ratio_all");
+        this->yokeRoll = XPLMFindDataRef("sim/joystick/yoke_roll_ratio");
+        this->yokePitch = XPLMFindDataRef("sim/joystick/yoke_pitch_ratio");
+        this->yokeHeading = XPLMFindDataRef("sim/joystick/yoke_heading_ratio");
+    }
+
+    void read(TXPlaneSnapshot &snapshot, uint32_t groups) const
+    {
+        snapshot.heartbeat = XPLMGetDatai(this->heartbeat);
+        snapshot.paused = XPLMGetDatai(this->paused);
+        snapshot.simSpeed = XPLMGetDataf(this->simSpeed);
+
+        if (groups & DATAREF_GROUP_GPS)
+        {
+            snapshot.latitude = XPLMGetDatad(this->latitude);
+            snapshot.longitude = XPLMGetDatad(this->longitude);
+            snapshot.elevation = XPLMGetDatad(this->elevation);
+            snapshot.local_vx = XPLMGetDataf(this->local_vx);
+            snapshot.local_vy = XPLMGetDataf(this->local_vy);
+            snapshot.local_vz = XPLMGetDataf(this->local_vz);
+            snapshot.groundspeed = XPLMGetDataf(this->groundspeed);
+            snapshot.airspeed = XPLMGetDataf(this->airspeed);
+            snapshot.hpath = XPLMGetDataf(this->hpath);
+        }
+
+        snapshot.roll = XPLMGetDataf(this->roll);
+        snapshot.pitch = XPLMGetDataf(this->pitch);
+        snapshot.yaw = XPLMGetDataf(this->yaw);
+        snapshot.accel_x = XPLMGetDataf(this->accel_x);
+        snapshot.accel_y = XPLMGetDataf(this->accel_y);
+        snapshot.accel_z = XPLMGetDataf(this->accel_z);
+        snapshot.gyro_p = XPLMGetDataf(this->gyro_p);
+        snapshot.gyro_q = XPLMGetDataf(this->gyro_q);
+        snapshot.gyro_r = XPLMGetDataf(this->gyro_r);
+        snapshot.baro = XPLMGetDataf(this->baro);
+
+        if (groups & DATAREF_GROUP_RC)
+        {
+            snapshot.hasJoystick = XPLMGetDatai(this->hasJoystick);
+            XPLMGetDatavf(this->joyAxis, &snapshot.joyAttitude[0], 1, 1);
+            XPLMGetDatavf(this->joyAxis, &snapshot.joyAttitude[1], 2, 1);
+            XPLMGetDatavf(this->joyAxis, &snapshot.joyAttitude[2], 3, 1);
+            XPLMGetDatavf(this->joyAxis, &snapshot.joyThrottleAux[0], 57, 1);
+            XPLMGetDatavf(this->joyAxis, &snapshot.joyThrottleAux[1], 58, 1);
+            XPLMGetDatavf(this->joyAxis, &snapshot.joyThrottleAux[2], 59, 1);
+            XPLMGetDatavf(this->joyAxis, &snapshot.joyThrottleAux[3], 60, 1);
+            XPLMGetDatavf(this->joyAxis, &snapshot.joyThrottleAux[4], 61, 1);
+        }
+    }
+
+    // Written on every MSP reply
+    void writeControls(float value) const
+    {
+        XPLMSetDatai(this->overrideJoystick, 1);
+        XPLMSetDataf(this->throttle, value);
+        XPLMSetDataf(this->yokeRoll, value);
+        XPLMSetDataf(this->yokePitch, -value);
+        XPLMSetDataf(this->yokeHeading, -value);
+    }
+
+private:
+    XPLMDataRef heartbeat, paused, simSpeed;
+    XPLMDataRef latitude, longitude, elevation, local_vx, local_vy, local_vz, groundspeed, airspeed, hpath;
+    XPLMDataRef roll, pitch, yaw, accel_x, accel_y, accel_z, gyro_p, gyro_q, gyro_r, baro;
+    XPLMDataRef hasJoystick, joyAxis;
+    XPLMDataRef overrideJoystick, throttle, yokeRoll, yokePitch, yokeHeading;
+};
+
+template <typename Function>
+static void run(const char *name, long cycles, Function function)
+{
+    float sum = 0.0f;
+    const long callsBefore = accessorCalls;
+    const auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < cycles; i++)
+    {
+        sum += function(i);
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("%-40s %8.3f us/cycle  %5.1f calls/cycle  (checksum %.1f)\n", name, seconds * 1e6 / cycles,
+           static_cast<double>(accessorCalls - callsBefore) / cycles, sum);
+}
+
+int main(int argc, char **argv)
+{
+    const long cycles = argc > 1 ? atol(argv[1]) : 2000000L;
+    const int repliesPerFrame = argc > 2 ? atoi(argv[2]) : 1;
+
+    SimDataRefs table;
+    IndividualDataRefs individual;
+
+    // Both must read the same values
+    const uint32_t allGroups = DATAREF_GROUP_FRAME | DATAREF_GROUP_GPS | DATAREF_GROUP_RC;
+    TXPlaneSnapshot tableSnapshot, individualSnapshot;
+    memset(&tableSnapshot, 0, sizeof(tableSnapshot));
+    memset(&individualSnapshot, 0, sizeof(individualSnapshot));
+    table.read(tableSnapshot, allGroups);
+    individual.read(individualSnapshot, allGroups);
+    const bool identical = memcmp(&tableSnapshot, &individualSnapshot, sizeof(TXPlaneSnapshot)) == 0;
+    printf("Snapshots %s\n", identical ? "identical" : "DIFFER");
+
+    TXPlaneSnapshot snapshot;
+    memset(&snapshot, 0, sizeof(snapshot));
+
+    const uint32_t sitl = DATAREF_GROUP_FRAME;
+    const uint32_t hitl = DATAREF_GROUP_FRAME | DATAREF_GROUP_RC;
+    run("SITL frame, individual calls", cycles, [&](long i) { individual.read(snapshot, sitl); return snapshot.roll; });
+    run("SITL frame, binding table", cycles, [&](long i) { table.read(snapshot, sitl); return snapshot.roll; });
+    run("HITL frame, individual calls", cycles, [&](long i) { individual.read(snapshot, hitl); return snapshot.joyThrottleAux[4]; });
+    run("HITL frame, binding table", cycles, [&](long i) { table.read(snapshot, hitl); return snapshot.joyThrottleAux[4]; });
+    run("HITL GPS frame, individual calls", cycles, [&](long i) { individual.read(snapshot, hitl | DATAREF_GROUP_GPS); return snapshot.hpath; });
+    run("HITL GPS frame, binding table", cycles, [&](long i) { table.read(snapshot, hitl | DATAREF_GROUP_GPS); return snapshot.hpath; });
+
+    run("HITL controls, written per reply", cycles, [&](long i)
+    {
+        for (int reply = 0; reply < repliesPerFrame; reply++)
+        {
+            individual.writeControls(static_cast<float>(reply));
+        }
+        return 0.0f;
+    });
+    run("HITL controls, flushed per frame", cycles, [&](long i)
+    {
+        for (int reply = 0; reply < repliesPerFrame; reply++)
+        {
+            const float value = static_cast<float>(reply);
+            table.setInt(DATAREF_WRITE_OVERRIDE_JOYSTICK, 1);
+            table.setFloat(DATAREF_WRITE_THROTTLE, value);
+            table.setFloat(DATAREF_WRITE_ROLL, value);
+            table.setFloat(DATAREF_WRITE_PITCH, -value);
+            table.setFloat(DATAREF_WRITE_YAW, -value);
+        }
+        table.flush();
+        return 0.0f;
+    });
+
+    return identical ? 0 : 1;
+}
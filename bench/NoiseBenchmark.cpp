@@ -0,0 +1,73 @@
+// Compares the ziggurat normal generator of RandomStream with std::normal_distribution.
+// Build with -DBUILD_BENCHMARKS=ON, run ./noise_benchmark [samples]
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+#include "core/RandomStream.h"
+
+template <typename Generator>
+static double run(const char *name, long samples, Generator generate)
+{
+    double sum = 0.0;
+    double sumSquared = 0.0;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < samples; i++)
+    {
+        const double value = generate();
+        sum += value;
+        sumSquared += value * value;
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const double mean = sum / samples;
+    const double sigma = std::sqrt(sumSquared / samples - mean * mean);
+    printf("%-40s %8.2f ns/sample  mean %+.5f  sigma %.5f\n", name, seconds * 1e9 / samples, mean, sigma);
+    return seconds;
+}
+
+int main(int argc, char **argv)
+{
+    const long samples = argc > 1 ? atol(argv[1]) : 50000000L;
+
+    {
+        std::mt19937 engine(1);
+        std::normal_distribution<float> normal(0.0f, 1.0f);
+        run("std::normal_distribution + mt19937", samples, [&]() { return normal(engine); });
+    }
+
+    {
+        std::mt19937_64 engine(1);
+        std::normal_distribution<float> normal(0.0f, 1.0f);
+        run("std::normal_distribution + mt19937_64", samples, [&]() { return normal(engine); });
+    }
+
+    {
+        RandomStream stream(1);
+        std::normal_distribution<float> normal(0.0f, 1.0f);
+        run("std::normal_distribution + RandomStream", samples, [&]() { return normal(stream); });
+    }
+
+    {
+        RandomStream stream(1);
+        run("RandomStream::normal (ziggurat)", samples, [&]() { return stream.normal(); });
+    }
+
+    // Same seed and stream must give the same sequence
+    RandomStream a(42, 3);
+    RandomStream b(42, 3);
+    for (int i = 0; i < 1000; i++)
+    {
+        if (a.normal() != b.normal())
+        {
+            printf("Streams with the same seed differ\n");
+            return 1;
+        }
+    }
+
+    return 0;
+}
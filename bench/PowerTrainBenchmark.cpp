@@ -0,0 +1,115 @@
+// Measures PowerTrain::update and BatteryPack::update, compares the curve lookup tables with a linear scan of the curves.
+// On the short built-in curves both take a few ns and the difference is within the noise; the table cost
+// just doesn't grow with the number of curve points, which matters for long catalog curves.
+// Build with -DBUILD_BENCHMARKS=ON, run ./powertrain_benchmark [updates]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include "PowerTrain.h"
+
+// The former implementation: linear scan of the curve points on every call
+static double scanDischargeCurve(double capacityPercent)
+{
+    const auto &curve = PowerTrainConstants::LIPO_DISCHARGE_CURVE;
+    if (capacityPercent >= 100.0)
+    {
+        return curve.front().voltage;
+    }
+    else if (capacityPercent <= 0.0)
+    {
+        return curve.back().voltage;
+    }
+
+    for (size_t i = 1; i < curve.size(); ++i)
+    {
+        if (capacityPercent >= curve[i].capacityPercent)
+        {
+            const BatteryValues &upper = curve[i - 1];
+            const BatteryValues &lower = curve[i];
+            const double slope = (upper.voltage - lower.voltage) / (upper.capacityPercent - lower.capacityPercent);
+            return lower.voltage + slope * (capacityPercent - lower.capacityPercent);
+        }
+    }
+    return 0.0;
+}
+
+static double scanMotorCurrent(double throttlePercent)
+{
+    const auto &curve = PowerTrainConstants::MOTOR_PERFORMANCE_CURVE;
+    throttlePercent = std::clamp(throttlePercent, 0.0, 100.0);
+    for (size_t i = 1; i < curve.size(); ++i)
+    {
+        if (throttlePercent <= curve[i].throttlePercent)
+        {
+            const MotorValues &upper = curve[i - 1];
+            const MotorValues &lower = curve[i];
+            const double slope = (throttlePercent - lower.throttlePercent) / (upper.throttlePercent - lower.throttlePercent);
+            return lower.current + slope * (upper.current - lower.current);
+        }
+    }
+    return 0.0;
+}
+
+template <typename Function>
+static double run(const char *name, long iterations, Function function)
+{
+    double sum = 0.0;
+    const auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < iterations; i++)
+    {
+        sum += function(i);
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("%-40s %8.2f ns/call  (checksum %.3f)\n", name, seconds * 1e9 / iterations, sum);
+    return seconds;
+}
+
+// Throttle / capacity sweep over 0..100 %, not a multiple of the table step
+static double percentAt(long i)
+{
+    return static_cast<double>((i * 7919) % 100003) / 1000.03;
+}
+
+int main(int argc, char **argv)
+{
+    const long updates = argc > 1 ? atol(argv[1]) : 20000000L;
+
+    // Tables must reproduce the curves
+    PowerTrain lipo(Lipo);
+    double maxVoltageError = 0.0;
+    double maxCurrentError = 0.0;
+    for (int i = 0; i <= 100000; i++)
+    {
+        const double percent = i / 1000.0;
+        maxVoltageError = std::max(maxVoltageError, std::fabs(lipo.getBatteryBaseVoltagePerCell(percent) - scanDischargeCurve(percent)));
+        maxCurrentError = std::max(maxCurrentError, std::fabs(lipo.interpolateMotorPerformance(percent).current - scanMotorCurrent(percent)));
+    }
+    printf("Max table error: voltage %.3g V, current %.3g A\n", maxVoltageError, maxCurrentError);
+
+    run("Discharge curve, linear scan", updates, [](long i) { return scanDischargeCurve(percentAt(i)); });
+    run("Discharge curve, table", updates, [&](long i) { return lipo.getBatteryBaseVoltagePerCell(percentAt(i)); });
+    run("Motor curve, linear scan", updates, [](long i) { return scanMotorCurrent(percentAt(i)); });
+    run("Motor curve, table", updates, [&](long i) { return lipo.interpolateMotorPerformance(percentAt(i)).current; });
+
+    // Large capacity so the battery doesn't run empty during the run
+    PowerTrain powerTrain(Lipo, 1e12);
+    run("PowerTrain::update", updates, [&](long i)
+    {
+        powerTrain.update(percentAt(i) / 100.0, 10.0, 0.01);
+        return powerTrain.getCurrentMotorAmps();
+    });
+
+    // Cell state update alone, 0..50 A
+    BatteryPack pack(PowerTrain::getBuiltInChemistry(Lipo), 1e12, 12);
+    run("BatteryPack::update, 12S", updates, [&](long i)
+    {
+        pack.update(percentAt(i) / 2.0, 0.01);
+        return pack.getVoltage();
+    });
+
+    return (maxVoltageError > 1e-9 || maxCurrentError > 1e-9) ? 1 : 0;
+}
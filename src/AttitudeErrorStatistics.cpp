@@ -0,0 +1,91 @@
+#include "AttitudeErrorStatistics.h"
+
+#include <algorithm>
+#include <cmath>
+
+AttitudeErrorStatistics::AttitudeErrorStatistics()
+{
+    this->reset();
+}
+
+void AttitudeErrorStatistics::reset()
+{
+    for (TAxis &axis : this->axes)
+    {
+        axis.sum = 0.0;
+        axis.sumSquares = 0.0;
+        axis.max = 0.0f;
+        axis.histogram.fill(0);
+    }
+    this->samples = 0;
+}
+
+float AttitudeErrorStatistics::wrapDecidegrees(float value)
+{
+    value = fmodf(value + 1800.0f, 3600.0f);
+    if (value < 0.0f)
+    {
+        value += 3600.0f;
+    }
+    return value - 1800.0f;
+}
+
+void AttitudeErrorStatistics::add(float realRoll, float realPitch, float realYaw, int16_t estimatedRoll, int16_t estimatedPitch, int16_t estimatedYaw)
+{
+    // INAV pitch is positive nose down
+    this->addAxis(0, AttitudeErrorStatistics::wrapDecidegrees(estimatedRoll - realRoll * 10.0f));
+    this->addAxis(1, AttitudeErrorStatistics::wrapDecidegrees(estimatedPitch + realPitch * 10.0f));
+    this->addAxis(2, AttitudeErrorStatistics::wrapDecidegrees(estimatedYaw - realYaw * 10.0f));
+    this->samples++;
+}
+
+void AttitudeErrorStatistics::addAxis(int index, float errorDecidegrees)
+{
+    TAxis &axis = this->axes[index];
+    const float error = fabsf(errorDecidegrees);
+
+    axis.sum += error;
+    axis.sumSquares += static_cast<double>(error) * error;
+    axis.max = std::max(axis.max, error);
+
+    const int bin = std::min(static_cast<int>(lroundf(error)), AttitudeErrorStatisticsConstants::HISTOGRAM_BINS - 1);
+    axis.histogram[bin]++;
+}
+
+float AttitudeErrorStatistics::percentileDeg(const TAxis &axis, float fraction) const
+{
+    // Smallest error that at least this fraction of the samples doesn't exceed
+    const uint64_t rank = static_cast<uint64_t>(ceil(fraction * this->samples));
+    uint64_t count = 0;
+    for (int bin = 0; bin < AttitudeErrorStatisticsConstants::HISTOGRAM_BINS; bin++)
+    {
+        count += axis.histogram[bin];
+        if (count >= rank)
+        {
+            return bin / 10.0f;
+        }
+    }
+    return (AttitudeErrorStatisticsConstants::HISTOGRAM_BINS - 1) / 10.0f;
+}
+
+TAttitudeErrorSummary AttitudeErrorStatistics::summarize() const
+{
+    TAttitudeErrorSummary summary = {};
+    summary.samples = this->samples;
+    if (this->samples == 0)
+    {
+        return summary;
+    }
+
+    for (int i = 0; i < AttitudeErrorStatisticsConstants::AXES; i++)
+    {
+        const TAxis &axis = this->axes[i];
+        summary.meanDeg[i] = static_cast<float>(axis.sum / this->samples) / 10.0f;
+        summary.rmsDeg[i] = static_cast<float>(sqrt(axis.sumSquares / this->samples)) / 10.0f;
+        summary.maxDeg[i] = axis.max / 10.0f;
+        summary.p50Deg[i] = this->percentileDeg(axis, 0.50f);
+        summary.p95Deg[i] = this->percentileDeg(axis, 0.95f);
+        summary.p99Deg[i] = this->percentileDeg(axis, 0.99f);
+    }
+    return summary;
+}
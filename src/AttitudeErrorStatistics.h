@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace AttitudeErrorStatisticsConstants
+{
+    static constexpr int AXES = 3; // roll, pitch, yaw
+    // One bin per decidegree, INAV's attitude resolution, 0 to 180 degrees
+    static constexpr int HISTOGRAM_BINS = 1801;
+}
+
+// Absolute real vs. INAV estimated attitude error in degrees, per axis roll, pitch, yaw
+struct TAttitudeErrorSummary
+{
+    int samples;
+    std::array<float, AttitudeErrorStatisticsConstants::AXES> meanDeg;
+    std::array<float, AttitudeErrorStatisticsConstants::AXES> rmsDeg;
+    std::array<float, AttitudeErrorStatisticsConstants::AXES> maxDeg;
+    std::array<float, AttitudeErrorStatisticsConstants::AXES> p50Deg;
+    std::array<float, AttitudeErrorStatisticsConstants::AXES> p95Deg;
+    std::array<float, AttitudeErrorStatisticsConstants::AXES> p99Deg;
+};
+
+/**
+ * @brief Streaming attitude estimation error statistics.
+ *
+ * add() is O(1): sums for mean and RMS, the maximum, and a histogram with one decidegree bins
+ * for the percentiles, which are exact at INAV's resolution. summarize() walks the histogram.
+ */
+class AttitudeErrorStatistics
+{
+public:
+    AttitudeErrorStatistics();
+
+    void reset();
+
+    // Real attitude in degrees as X-Plane reports it, estimated attitude in decidegrees as INAV sends it
+    void add(float realRoll, float realPitch, float realYaw, int16_t estimatedRoll, int16_t estimatedPitch, int16_t estimatedYaw);
+
+    int getSamples() const { return this->samples; }
+    TAttitudeErrorSummary summarize() const;
+
+    // Difference of two angles in decidegrees to -1800..1800, so 359 vs. 1 degree yaw is 2 degrees
+    static float wrapDecidegrees(float value);
+
+private:
+    struct TAxis
+    {
+        double sum;
+        double sumSquares;
+        float max;
+        std::array<uint32_t, AttitudeErrorStatisticsConstants::HISTOGRAM_BINS> histogram;
+    };
+
+    std::array<TAxis, AttitudeErrorStatisticsConstants::AXES> axes;
+    int samples = 0;
+
+    void addAxis(int axis, float errorDecidegrees);
+    float percentileDeg(const TAxis &axis, float fraction) const;
+};
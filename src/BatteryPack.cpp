@@ -0,0 +1,111 @@
+#include "BatteryPack.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace BatteryPackConstants;
+
+BatteryPack::BatteryPack(const TBatteryChemistry &chemistry, double capacityMah, int cells, double imbalancePercent, double ambientTemperatureC) : chemistry(&chemistry),
+                                                                                                                                                   cells(std::clamp(cells, 1, MAX_CELLS)),
+                                                                                                                                                   ambientTemperatureC(ambientTemperatureC)
+{
+    this->ohmicResistance = chemistry.internalResistancePerCell * OHMIC_RESISTANCE_SHARE;
+    this->polarizationResistance = chemistry.internalResistancePerCell * (1.0 - OHMIC_RESISTANCE_SHARE);
+    this->heatCapacity = CELL_HEAT_CAPACITY_J_PER_K_AH * capacityMah / 1000.0;
+
+    // Unused cells stay at neutral values, so the loops may run over all of them
+    this->capacityMah.fill(capacityMah);
+    this->remainingMah.fill(capacityMah);
+    this->stateOfChargePercent.fill(100.0);
+    this->polarizationVoltage.fill(0.0);
+    this->temperatureC.fill(ambientTemperatureC);
+    this->cellVoltage.fill(0.0);
+
+    for (int i = 1; i < this->cells; i++)
+    {
+        const double factor = 1.0 - imbalancePercent / 100.0 * i / (this->cells - 1);
+        this->capacityMah[i] = capacityMah * factor;
+        this->remainingMah[i] = capacityMah * factor;
+    }
+
+    this->update(0.0, 0.0);
+}
+
+void BatteryPack::update(double currentAmps, double dtSec)
+{
+    const int n = this->cells;
+    const double chargeMah = currentAmps * dtSec / 3.6;
+
+    // Exact discretization of the RC element, dt is mostly the same from call to call
+    if (dtSec != this->lastDtSec)
+    {
+        this->polarizationDecay = std::exp(-dtSec / POLARIZATION_TIME_CONSTANT_S);
+        this->lastDtSec = dtSec;
+    }
+    const double decay = this->polarizationDecay;
+    const double polarizationTarget = currentAmps * this->polarizationResistance;
+    const double heatFactor = dtSec / this->heatCapacity;
+    const double coolingFactor = 1.0 / CELL_THERMAL_RESISTANCE_K_PER_W;
+    const double ohmicResistance = this->ohmicResistance;
+    const double ambientTemperature = this->ambientTemperatureC;
+
+    // Members of the same object, so the compiler knows they don't overlap
+    TCellValues &remaining = this->remainingMah;
+    const TCellValues &capacity = this->capacityMah;
+    TCellValues &stateOfCharge = this->stateOfChargePercent;
+    TCellValues &polarization = this->polarizationVoltage;
+    TCellValues &temperature = this->temperatureC;
+    TCellValues &voltage = this->cellVoltage;
+
+    // Branch free, vectorized
+    for (int i = 0; i < n; i++)
+    {
+        remaining[i] = std::max(remaining[i] - chargeMah, 0.0);
+        stateOfCharge[i] = remaining[i] / capacity[i] * 100.0;
+        polarization[i] = polarizationTarget + (polarization[i] - polarizationTarget) * decay;
+
+        const double resistanceFactor = std::max(MIN_RESISTANCE_FACTOR, 1.0 + RESISTANCE_TEMPERATURE_COEFFICIENT * (REFERENCE_TEMPERATURE_C - temperature[i]));
+        const double ohmicDrop = currentAmps * ohmicResistance * resistanceFactor;
+        const double heatWatts = currentAmps * (ohmicDrop + polarization[i]);
+        temperature[i] += (heatWatts - (temperature[i] - ambientTemperature) * coolingFactor) * heatFactor;
+        voltage[i] = -ohmicDrop - polarization[i];
+    }
+
+    // Open circuit voltage, table lookup per cell
+    const TDischargeTable &table = this->chemistry->dischargeTable;
+    for (int i = 0; i < n; i++)
+    {
+        double t;
+        const int index = PowerTrainTables::tableIndex(stateOfCharge[i], t);
+        voltage[i] += PowerTrainTables::lerp(table[index], table[index + 1], t);
+    }
+
+    double packVoltage = 0.0;
+    double minVoltage = voltage[0];
+    double minRemaining = remaining[0];
+    double maxTemperature = temperature[0];
+    for (int i = 0; i < n; i++)
+    {
+        packVoltage += voltage[i];
+        minVoltage = std::min(minVoltage, voltage[i]);
+        minRemaining = std::min(minRemaining, remaining[i]);
+        maxTemperature = std::max(maxTemperature, temperature[i]);
+    }
+
+    this->minRemainingMah = minRemaining;
+    this->maxTemperatureC = maxTemperature;
+    if (minRemaining <= 0.0)
+    {
+        this->discharged = true;
+        this->packVoltage = 0.0;
+        this->minCellVoltage = 0.0;
+        return;
+    }
+
+    this->packVoltage = packVoltage;
+    this->minCellVoltage = minVoltage;
+    if (minVoltage <= this->chemistry->cutOffVoltagePerCell)
+    {
+        this->discharged = true;
+    }
+}
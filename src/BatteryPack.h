@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+
+#include "PowerTrainTables.h"
+
+namespace BatteryPackConstants
+{
+    static constexpr int MAX_CELLS = 16;
+    // Internal resistance of the chemistry, split into the ohmic part (instant sag) and the polarization
+    // RC element (slow sag and recovery). The steady state sag stays the same as with the ohmic part only.
+    static constexpr double OHMIC_RESISTANCE_SHARE = 0.6;
+    static constexpr double POLARIZATION_TIME_CONSTANT_S = 20.0;
+    // Ohmic resistance rises by 1.5 % per K below 25 °C, at most halves when warm
+    static constexpr double REFERENCE_TEMPERATURE_C = 25.0;
+    static constexpr double RESISTANCE_TEMPERATURE_COEFFICIENT = 0.015; // 1/K
+    static constexpr double MIN_RESISTANCE_FACTOR = 0.5;
+    static constexpr double AMBIENT_TEMPERATURE_C = 25.0;
+    // ~22 g per Ah and cell, 1 J/(g K); cooling to the ambient in the airstream
+    static constexpr double CELL_HEAT_CAPACITY_J_PER_K_AH = 22.0;
+    static constexpr double CELL_THERMAL_RESISTANCE_K_PER_W = 8.0;
+    // Capacity of the weakest cell is this much lower, the others are spread evenly in between
+    static constexpr double DEFAULT_IMBALANCE_PERCENT = 2.0;
+}
+
+/**
+ * @brief Battery pack as cells in series, each with its own capacity, state of charge, polarization
+ * and temperature.
+ *
+ * Cell voltage = open circuit voltage(state of charge) - I * R0(temperature) - polarization voltage,
+ * with the polarization as a single RC element. The voltage sags further under sustained load and
+ * recovers after it. The weakest cell decides when the pack is discharged.
+ *
+ * Cell state is stored as structure of arrays and updated in plain loops over the cells without
+ * branches, which the compiler vectorizes; the open circuit voltage lookup is a separate loop.
+ */
+class BatteryPack
+{
+public:
+    // The chemistry must outlive the pack
+    BatteryPack(const TBatteryChemistry &chemistry, double capacityMah, int cells,
+                double imbalancePercent = BatteryPackConstants::DEFAULT_IMBALANCE_PERCENT,
+                double ambientTemperatureC = BatteryPackConstants::AMBIENT_TEMPERATURE_C);
+
+    void update(double currentAmps, double dtSec);
+
+    int getCells() const { return this->cells; }
+    double getVoltage() const { return this->packVoltage; }
+    double getMinCellVoltage() const { return this->minCellVoltage; }
+    // Weakest cell, the usable capacity of the pack
+    double getRemainingCapacityMah() const { return this->minRemainingMah; }
+    double getMaxTemperature() const { return this->maxTemperatureC; }
+    bool isDischarged() const { return this->discharged; }
+
+    double getCellVoltage(int cell) const { return this->cellVoltage[cell]; }
+    double getCellTemperature(int cell) const { return this->temperatureC[cell]; }
+    double getCellPolarizationVoltage(int cell) const { return this->polarizationVoltage[cell]; }
+
+private:
+    typedef std::array<double, BatteryPackConstants::MAX_CELLS> TCellValues;
+
+    const TBatteryChemistry *chemistry;
+    int cells;
+    double ohmicResistance;       // at the reference temperature
+    double polarizationResistance;
+    double heatCapacity;          // J/K per cell
+    double ambientTemperatureC;
+    double lastDtSec = -1.0;
+    double polarizationDecay = 0.0;
+
+    alignas(32) TCellValues capacityMah;
+    alignas(32) TCellValues remainingMah;
+    alignas(32) TCellValues stateOfChargePercent;
+    alignas(32) TCellValues polarizationVoltage;
+    alignas(32) TCellValues temperatureC;
+    alignas(32) TCellValues cellVoltage;
+
+    double packVoltage = 0.0;
+    double minCellVoltage = 0.0;
+    double minRemainingMah = 0.0;
+    double maxTemperatureC = 0.0;
+    bool discharged = false;
+};
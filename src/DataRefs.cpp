@@ -7,6 +7,7 @@
 #include "core/EventBus.h"
 
 #include "Utils.h"
+#include "core/Clock.h"
 
 namespace DataRefsConstants {
     static constexpr uint32_t MSG_ADD_DATAREF = 0x01000000;  //  Add dataref to DRE message
@@ -24,22 +25,23 @@ static void writeSingleValue(void *inRefcon, T inValue)
     *reinterpret_cast<T *>(inRefcon) = inValue;
 }
 
-static int vector3ReadDataRef(void *inRefcon, float *outValues, int inOffset, int inMax)
+template <int N>
+static int floatArrayReadDataRef(void *inRefcon, float *outValues, int inOffset, int inMax)
 {
     if (inRefcon != nullptr && outValues == nullptr)
     {
-        return 3;
+        return N;
     }
     
-    if (inRefcon == nullptr || inMax <= 0 || inOffset < 0 || inMax > 3 || inOffset >= 3)
+    if (inRefcon == nullptr || inMax <= 0 || inOffset < 0 || inOffset >= N)
     {
         return 0;
     }
 
     float *vec = reinterpret_cast<float *>(inRefcon);
-    if (inOffset + inMax > 3)
+    if (inOffset + inMax > N)
     {
-        inMax = 3 - inOffset;
+        inMax = N - inOffset;
     }
     for (int i = 0; i < inMax; i++)
     {
@@ -98,6 +100,11 @@ XPLMDataRef DataRefs::registerFloatDataRef(const char *pName, float *pValue, boo
 }
 
 XPLMDataRef DataRefs::registerVector3DataRef(const char *pName, float *pValue)
+{
+    return this->registerFloatArrayDataRef(pName, pValue, floatArrayReadDataRef<3>);
+}
+
+XPLMDataRef DataRefs::registerFloatArrayDataRef(const char *pName, float *pValue, XPLMGetDatavf_f pReader)
 {
     XPLMDataRef res = XPLMRegisterDataAccessor
     (
@@ -108,7 +115,7 @@ XPLMDataRef DataRefs::registerVector3DataRef(const char *pName, float *pValue)
         NULL, NULL,     // Float accessors
         NULL, NULL, // Doubles accessors
         NULL, NULL, // Int array accessors
-        vector3ReadDataRef, NULL, // Float array accessors
+        pReader, NULL, // Float array accessors
         NULL, NULL, // Raw data accessors
         pValue, NULL
     );
@@ -124,7 +131,7 @@ XPLMDataRef DataRefs::registerVector3DataRef(const char *pName, float *pValue)
 
 DataRefs::DataRefs()
 {
-    this->lastUpdate = Utils::GetTicks();
+    this->lastUpdateUs = Clock::NowUs();
     auto eventBus = Plugin()->GetEventBus();
 
     this->df_serialPacketsSent = this->registerIntDataRef("inav_xitl/serial/packetsSent", &this->serialPacketsSent);
@@ -136,7 +143,33 @@ DataRefs::DataRefs()
     this->df_serialBytesReceived = this->registerIntDataRef("inav_xitl/serial/bytesReceived", &this->serialBytesReceived);
     this->df_serialBytesReceivedPerSecond = this->registerIntDataRef("inav_xitl/serial/bytesReceivedPerSecond", &this->serialBytesReceivedPerSecond);
     this->df_cyclesPerSecond = this->registerIntDataRef("inav_xitl/debug/cyclesPerSecond", &this->cyclesPerSecond);
-    this->df_cyclesPerSecond = this->registerIntDataRef("inav_xitl/debug/OSDUpdatesPerSecond", &this->OSDUpdatesPerSecond);
+    this->df_OSDUpdatesPerSecond = this->registerIntDataRef("inav_xitl/debug/OSDUpdatesPerSecond", &this->OSDUpdatesPerSecond);
+    this->df_OSDChangedCellsPerSecond = this->registerIntDataRef("inav_xitl/debug/OSDChangedCellsPerSecond", &this->OSDChangedCellsPerSecond);
+    this->df_OSDChangedCellsPerFrame = this->registerIntDataRef("inav_xitl/debug/OSDChangedCellsPerFrame", &this->OSDChangedCellsPerFrame);
+    this->df_OSDFramesTornPerSecond = this->registerIntDataRef("inav_xitl/debug/OSDFramesTornPerSecond", &this->OSDFramesTornPerSecond);
+    this->df_OSDTearsPreventedPerSecond = this->registerIntDataRef("inav_xitl/debug/OSDTearsPreventedPerSecond", &this->OSDTearsPreventedPerSecond);
+    this->df_OSDLatencyMeanMs = this->registerFloatArrayDataRef("inav_xitl/debug/OSDLatencyMeanMs", this->OSDLatencyMeanMs, floatArrayReadDataRef<OSD_LATENCY_STAGES>);
+    this->df_OSDLatencyP50Ms = this->registerFloatArrayDataRef("inav_xitl/debug/OSDLatencyP50Ms", this->OSDLatencyP50Ms, floatArrayReadDataRef<OSD_LATENCY_STAGES>);
+    this->df_OSDLatencyP95Ms = this->registerFloatArrayDataRef("inav_xitl/debug/OSDLatencyP95Ms", this->OSDLatencyP95Ms, floatArrayReadDataRef<OSD_LATENCY_STAGES>);
+    this->df_OSDLatencyP99Ms = this->registerFloatArrayDataRef("inav_xitl/debug/OSDLatencyP99Ms", this->OSDLatencyP99Ms, floatArrayReadDataRef<OSD_LATENCY_STAGES>);
+    this->df_OSDLatencyMaxMs = this->registerFloatArrayDataRef("inav_xitl/debug/OSDLatencyMaxMs", this->OSDLatencyMaxMs, floatArrayReadDataRef<OSD_LATENCY_STAGES>);
+    this->df_OSDFrameRateHz = this->registerFloatDataRef("inav_xitl/debug/OSDFrameRateHz", &this->OSDFrameRateHz);
+    this->df_dataRefTimeUs = this->registerFloatDataRef("inav_xitl/debug/dataRefTimeUs", &this->dataRefTimeUs);
+    this->df_dataRefCallsPerCycle = this->registerIntDataRef("inav_xitl/debug/dataRefCallsPerCycle", &this->dataRefCallsPerCycle);
+
+    this->df_senderRateHz = this->registerIntDataRef("inav_xitl/sender/rateHz", &this->senderRateHz);
+    this->df_senderJitterMeanUs = this->registerFloatDataRef("inav_xitl/sender/jitterMeanUs", &this->senderJitterMeanUs);
+    this->df_senderJitterStdDevUs = this->registerFloatDataRef("inav_xitl/sender/jitterStdDevUs", &this->senderJitterStdDevUs);
+    this->df_senderJitterMaxUs = this->registerFloatDataRef("inav_xitl/sender/jitterMaxUs", &this->senderJitterMaxUs);
+    this->df_senderOverruns = this->registerIntDataRef("inav_xitl/sender/overruns", &this->senderOverruns);
+    this->df_lockstepStepsPerSecond = this->registerIntDataRef("inav_xitl/lockstep/stepsPerSecond", &this->lockstepStepsPerSecond);
+    this->df_lockstepRealtimeFactor = this->registerFloatDataRef("inav_xitl/lockstep/realtimeFactor", &this->lockstepRealtimeFactor);
+    this->df_lockstepTimeouts = this->registerIntDataRef("inav_xitl/lockstep/timeouts", &this->lockstepTimeouts);
+    this->df_attitudeErrorDeg = this->registerVector3DataRef("inav_xitl/debug/attitudeErrorDeg", this->attitudeErrorDeg);
+    this->df_attitudeErrorRmsDeg = this->registerVector3DataRef("inav_xitl/debug/attitudeErrorRmsDeg", this->attitudeErrorRmsDeg);
+    this->df_attitudeErrorMaxDeg = this->registerVector3DataRef("inav_xitl/debug/attitudeErrorMaxDeg", this->attitudeErrorMaxDeg);
+    this->df_attitudeErrorP95Deg = this->registerVector3DataRef("inav_xitl/debug/attitudeErrorP95Deg", this->attitudeErrorP95Deg);
+    this->df_attitudeErrorSamples = this->registerIntDataRef("inav_xitl/debug/attitudeErrorSamples", &this->attitudeErrorSamples);
 
     this->df_eulerAngles = this->registerVector3DataRef("inav_xitl/inav/attitude.euler", this->dbg_eulerAngles);
     this->df_acc = this->registerVector3DataRef("inav_xitl/inav/acc.accADCf", this->dbg_acc);
@@ -155,15 +188,22 @@ DataRefs::DataRefs()
     this->df_gps_elevation = this->registerFloatDataRef("inav_xitl/gps/elevation", &this->gps_elevation);
     this->df_groundspeed = this->registerFloatDataRef("inav_xitl/gps/groundspeed", &this->groundspeed);
     this->df_gps_velocitys = this->registerVector3DataRef("inav_xitl/gps/velocities", this->gps_velocitys);
+    this->df_gps_hdop = this->registerFloatDataRef("inav_xitl/gps/hdop", &this->gps_hdop);
 
     this->df_magnetometer = this->registerVector3DataRef("inav_xitl/sensors/magnetometer", this->magnetometer);
+    this->df_magDeclination = this->registerFloatDataRef("inav_xitl/sensors/magDeclination", &this->magDeclination);
     this->df_rangefinder = this->registerIntDataRef("inav_xitl/sensors/rangefinder", &this->rangefinder_distance_cm);
     this->df_airspeed = this->registerFloatDataRef("inav_xitl/sensors/airspeed", &this->airspeed);
     this->df_current = this->registerFloatDataRef("inav_xitl/sensors/battery_current", &this->current);
     this->df_voltage = this->registerFloatDataRef("inav_xitl/sensors/battery_voltage", &this->voltage);
+    this->df_minCellVoltage = this->registerFloatDataRef("inav_xitl/sensors/battery_min_cell_voltage", &this->minCellVoltage);
+    this->df_batteryTemperature = this->registerFloatDataRef("inav_xitl/sensors/battery_temperature", &this->batteryTemperature);
+    this->df_predictedTimeRemaining = this->registerFloatDataRef("inav_xitl/sensors/battery_time_remaining", &this->predictedTimeRemaining);
+    this->df_predictedMinVoltage = this->registerFloatDataRef("inav_xitl/sensors/battery_min_voltage_predicted", &this->predictedMinVoltage);
 
     this->df_rssi = this->registerIntDataRef("inav_xitl/rc/rssi", &this->rssi);
     this->df_failsafe = this->registerIntDataRef("inav_xitl/rc/failsafe", &this->isFailsafe);
+    this->df_rssiTerrainLossDb = this->registerFloatDataRef("inav_xitl/rc/terrainLossDb", &this->rssiTerrainLossDb);
 
     // Use custom dataref accessors for arrays to support length query
     auto readDebugDataRef = []( void *inRefcon, int *outValues, int inOffset, int inCount)
@@ -209,13 +249,34 @@ DataRefs::DataRefs()
 
     eventBus->Subscribe<FlightLoopEventArg>("FlightLoop", [this](const FlightLoopEventArg &event)
     { 
-        this->loop(); 
         this->cycles++; 
     });
 
-    eventBus->Subscribe("OSDFrameUpdated", [this]()
+    eventBus->Subscribe<FlightLoopEventArg>("StatisticsLoop", [this](const FlightLoopEventArg &event)
+    { 
+        this->loop(); 
+    });
+
+    eventBus->Subscribe<OsdFrameUpdatedEventArg>("OSDFrameUpdated", [this](const OsdFrameUpdatedEventArg &event)
     { 
         this->OSDUpdates++; 
+        this->OSDChangedCells += event.changedCells;
+        this->OSDChangedCellsPerFrame = event.changedCells;
+        this->OSDFramesTorn += event.tornDraws;
+        this->OSDTearsPrevented += event.tearsPrevented;
+    });
+
+    eventBus->Subscribe<OsdLatencySummaryEventArg>("OSDLatencySummary", [this](const OsdLatencySummaryEventArg &event)
+    {
+        for (int i = 0; i < OSD_LATENCY_STAGES; i++)
+        {
+            this->OSDLatencyMeanMs[i] = event.summary.meanMs[i];
+            this->OSDLatencyP50Ms[i] = event.summary.p50Ms[i];
+            this->OSDLatencyP95Ms[i] = event.summary.p95Ms[i];
+            this->OSDLatencyP99Ms[i] = event.summary.p99Ms[i];
+            this->OSDLatencyMaxMs[i] = event.summary.maxMs[i];
+        }
+        this->OSDFrameRateHz = event.summary.frameRateHz;
     });
 
     eventBus->Subscribe<EulerAnglesEventArgs>("AddAttitudeYPR", [this](const EulerAnglesEventArgs &event)
@@ -239,24 +300,66 @@ DataRefs::DataRefs()
         this->dbg_acc[2] = event.vector.z;
     });
 
-    eventBus->Subscribe<AddDebugEventArg>("AddDebug", [this](const AddDebugEventArg &event)
+    eventBus->Subscribe<DebugFrameEventArg>("DebugFrame", [this](const DebugFrameEventArg &event)
     {
-        if (event.index >= 0 && event.index < DataRefsConstants::DEBUG_U32_COUNT)
+        for (int i = 0; i < DataRefsConstants::DEBUG_U32_COUNT; i++)
         {
-            this->debug[event.index] = event.value;
+            this->debug[i] = static_cast<int>(lroundf(event.frame.values[i]));
         }
     });
 
+    eventBus->Subscribe<SimDataCycleEventArg>("SimDataCycle", [this](const SimDataCycleEventArg &event)
+    {
+        this->dataRefTimeUsSum += event.dataRefTimeUs;
+        this->dataRefTimeSamples++;
+        this->dataRefCallsPerCycle = event.dataRefReads + event.dataRefWrites;
+    });
+
     eventBus->Subscribe<IntEventArg>("SerialBytesReceived", [this](const IntEventArg &event)    
     {
         this->serialBytesReceived += event.value;
         this->serialPacketsReceived++; 
     });
 
-    eventBus->Subscribe<IntEventArg>("SerialBytesSent", [this](const IntEventArg &event)
+    eventBus->Subscribe<SensorSenderStatisticsEventArg>("SensorSenderStatistics", [this](const SensorSenderStatisticsEventArg &event)
+    {
+        this->senderRateHz = event.rateHz;
+        this->senderJitterMeanUs = event.jitterMeanUs;
+        this->senderJitterStdDevUs = event.jitterStdDevUs;
+        this->senderJitterMaxUs = event.jitterMaxUs;
+        this->senderOverruns += event.overruns;
+    });
+
+    eventBus->Subscribe<LockstepStatisticsEventArg>("LockstepStatistics", [this](const LockstepStatisticsEventArg &event)
+    {
+        this->lockstepStepsPerSecond = event.stepsPerSecond;
+        this->lockstepRealtimeFactor = event.realtimeFactor;
+        // Per statistics window like the other two, a reset publishes 0
+        this->lockstepTimeouts = event.timeouts;
+    });
+
+    eventBus->Subscribe<Vector3EventArgs>("AttitudeEstimationError", [this](const Vector3EventArgs &event)
+    {
+        this->attitudeErrorDeg[0] = event.vector.x;
+        this->attitudeErrorDeg[1] = event.vector.y;
+        this->attitudeErrorDeg[2] = event.vector.z;
+    });
+
+    eventBus->Subscribe<AttitudeErrorSummaryEventArg>("AttitudeErrorSummary", [this](const AttitudeErrorSummaryEventArg &event)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            this->attitudeErrorRmsDeg[i] = event.summary.rmsDeg[i];
+            this->attitudeErrorMaxDeg[i] = event.summary.maxDeg[i];
+            this->attitudeErrorP95Deg[i] = event.summary.p95Deg[i];
+        }
+        this->attitudeErrorSamples = event.summary.samples;
+    });
+
+    eventBus->Subscribe<SerialTrafficEventArg>("SerialBytesSent", [this](const SerialTrafficEventArg &event)
     {
-        this->serialBytesSent += event.value;
-        this->serialPacketsSent++; 
+        this->serialBytesSent += event.bytes;
+        this->serialPacketsSent += event.packets;
     });
 
     eventBus->Subscribe<UpdateDataRefEventArg>("UpdateDataRef", [this](const UpdateDataRefEventArg &event)
@@ -270,43 +373,71 @@ DataRefs::DataRefs()
         this->gps_velocitys[0] = event.gpsVelocities.x;
         this->gps_velocitys[1] = event.gpsVelocities.y;
         this->gps_velocitys[2] = event.gpsVelocities.z;
+        this->gps_hdop = event.gpsHdop;
         this->magnetometer[0] = event.magnetometer.x;
         this->magnetometer[1] = event.magnetometer.y;
         this->magnetometer[2] = event.magnetometer.z;
+        this->magDeclination = event.magDeclination;
         this->rangefinder_distance_cm = event.rangefinderDistanceCm;
         this->airspeed = event.airspeed;
         this->current = event.currentConsumption;
         this->voltage = event.batteryVoltage;
+        this->minCellVoltage = event.minCellVoltage;
+        this->batteryTemperature = event.batteryTemperature;
+        this->predictedTimeRemaining = event.predictedTimeRemainingS;
+        this->predictedMinVoltage = event.predictedMinVoltage;
         this->rssi = event.rssi;
         this->isFailsafe = event.isFailsafe ? 1 : 0;
+        this->rssiTerrainLossDb = event.rssiTerrainLossDb;
     });
 }
 
+// Called by the statistics flight loop, once per second by default
 void DataRefs::loop()
 {
-    uint32_t delta = Utils::GetTicks() - this->lastUpdate;
-    if (delta >= 1000)
+    const int64_t now = Clock::NowUs();
+    const int64_t delta = now - this->lastUpdateUs;
+    this->lastUpdateUs = now;
+    if (delta <= 0 || delta > 10 * ClockConstants::US_PER_S)
     {
-        this->serialBytesSentPerSecond = this->serialBytesSent - this->serialBytesSentLast;
+        // First call or after a long stall (loading, debugger break), just restart the window
         this->serialBytesSentLast = this->serialBytesSent;
-
-        this->serialPacketsSentPerSecond = this->serialPacketsSent - this->serialPacketsSentLast;
         this->serialPacketsSentLast = this->serialPacketsSent;
-
-        this->serialBytesReceivedPerSecond = this->serialBytesReceived - this->serialBytesReceivedLast;
         this->serialBytesReceivedLast = this->serialBytesReceived;
-
-        this->serialPacketsReceivedPerSecond = this->serialPacketsReceived - this->serialPacketsReceivedLast;
         this->serialPacketsReceivedLast = this->serialPacketsReceived;
-
-        this->cyclesPerSecond = this->cycles - this->cyclesLast;
         this->cyclesLast = this->cycles;
-
-        this->OSDUpdatesPerSecond = this->OSDUpdates - this->OSDUpdatesLast;
         this->OSDUpdatesLast = this->OSDUpdates;
-
-        this->lastUpdate = Utils::GetTicks();
+        this->OSDChangedCellsLast = this->OSDChangedCells;
+        this->OSDFramesTornLast = this->OSDFramesTorn;
+        this->OSDTearsPreventedLast = this->OSDTearsPrevented;
+        this->dataRefTimeUsSum = 0.0f;
+        this->dataRefTimeSamples = 0;
+        return;
     }
+
+    // The slot interval is configurable and only kept to the frame, so scale the counts to one second
+    const double scale = static_cast<double>(ClockConstants::US_PER_S) / delta;
+    auto perSecond = [scale](int count, int &last)
+    {
+        const int rate = static_cast<int>(lround((count - last) * scale));
+        last = count;
+        return rate;
+    };
+
+    this->serialBytesSentPerSecond = perSecond(this->serialBytesSent, this->serialBytesSentLast);
+    this->serialPacketsSentPerSecond = perSecond(this->serialPacketsSent, this->serialPacketsSentLast);
+    this->serialBytesReceivedPerSecond = perSecond(this->serialBytesReceived, this->serialBytesReceivedLast);
+    this->serialPacketsReceivedPerSecond = perSecond(this->serialPacketsReceived, this->serialPacketsReceivedLast);
+    this->cyclesPerSecond = perSecond(this->cycles, this->cyclesLast);
+    this->OSDUpdatesPerSecond = perSecond(this->OSDUpdates, this->OSDUpdatesLast);
+    this->OSDChangedCellsPerSecond = perSecond(this->OSDChangedCells, this->OSDChangedCellsLast);
+    this->OSDFramesTornPerSecond = perSecond(this->OSDFramesTorn, this->OSDFramesTornLast);
+    this->OSDTearsPreventedPerSecond = perSecond(this->OSDTearsPrevented, this->OSDTearsPreventedLast);
+
+    // Average cost of dataref access per SimData cycle
+    this->dataRefTimeUs = this->dataRefTimeSamples > 0 ? this->dataRefTimeUsSum / this->dataRefTimeSamples : 0.0f;
+    this->dataRefTimeUsSum = 0.0f;
+    this->dataRefTimeSamples = 0;
 }
 
 DataRefs::~DataRefs()
@@ -320,6 +451,16 @@ DataRefs::~DataRefs()
     XPLMUnregisterDataAccessor(this->df_serialBytesReceived);
     XPLMUnregisterDataAccessor(this->df_serialBytesReceivedPerSecond);
     XPLMUnregisterDataAccessor(this->df_OSDUpdatesPerSecond);
+    XPLMUnregisterDataAccessor(this->df_OSDChangedCellsPerSecond);
+    XPLMUnregisterDataAccessor(this->df_OSDChangedCellsPerFrame);
+    XPLMUnregisterDataAccessor(this->df_OSDFramesTornPerSecond);
+    XPLMUnregisterDataAccessor(this->df_OSDTearsPreventedPerSecond);
+    XPLMUnregisterDataAccessor(this->df_OSDLatencyMeanMs);
+    XPLMUnregisterDataAccessor(this->df_OSDLatencyP50Ms);
+    XPLMUnregisterDataAccessor(this->df_OSDLatencyP95Ms);
+    XPLMUnregisterDataAccessor(this->df_OSDLatencyP99Ms);
+    XPLMUnregisterDataAccessor(this->df_OSDLatencyMaxMs);
+    XPLMUnregisterDataAccessor(this->df_OSDFrameRateHz);
     
     XPLMUnregisterDataAccessor(this->df_eulerAngles);
     XPLMUnregisterDataAccessor(this->df_acc);
@@ -327,6 +468,22 @@ DataRefs::~DataRefs()
 
     XPLMUnregisterDataAccessor(this->df_debug);
     XPLMUnregisterDataAccessor(this->df_cyclesPerSecond);
+    XPLMUnregisterDataAccessor(this->df_dataRefTimeUs);
+    XPLMUnregisterDataAccessor(this->df_dataRefCallsPerCycle);
+
+    XPLMUnregisterDataAccessor(this->df_senderRateHz);
+    XPLMUnregisterDataAccessor(this->df_senderJitterMeanUs);
+    XPLMUnregisterDataAccessor(this->df_senderJitterStdDevUs);
+    XPLMUnregisterDataAccessor(this->df_senderJitterMaxUs);
+    XPLMUnregisterDataAccessor(this->df_senderOverruns);
+    XPLMUnregisterDataAccessor(this->df_lockstepStepsPerSecond);
+    XPLMUnregisterDataAccessor(this->df_lockstepRealtimeFactor);
+    XPLMUnregisterDataAccessor(this->df_lockstepTimeouts);
+    XPLMUnregisterDataAccessor(this->df_attitudeErrorDeg);
+    XPLMUnregisterDataAccessor(this->df_attitudeErrorRmsDeg);
+    XPLMUnregisterDataAccessor(this->df_attitudeErrorMaxDeg);
+    XPLMUnregisterDataAccessor(this->df_attitudeErrorP95Deg);
+    XPLMUnregisterDataAccessor(this->df_attitudeErrorSamples);
 
     XPLMUnregisterDataAccessor(this->df_XitlVersion);
     XPLMUnregisterDataAccessor(this->df_sitl_heartbeat);
@@ -338,13 +495,20 @@ DataRefs::~DataRefs()
     XPLMUnregisterDataAccessor(this->df_gps_elevation);
     XPLMUnregisterDataAccessor(this->df_groundspeed);
     XPLMUnregisterDataAccessor(this->df_gps_velocitys);
+    XPLMUnregisterDataAccessor(this->df_gps_hdop);
     XPLMUnregisterDataAccessor(this->df_magnetometer);
+    XPLMUnregisterDataAccessor(this->df_magDeclination);
     XPLMUnregisterDataAccessor(this->df_rangefinder);
     XPLMUnregisterDataAccessor(this->df_airspeed);
     XPLMUnregisterDataAccessor(this->df_current);
+    XPLMUnregisterDataAccessor(this->df_minCellVoltage);
+    XPLMUnregisterDataAccessor(this->df_batteryTemperature);
+    XPLMUnregisterDataAccessor(this->df_predictedTimeRemaining);
+    XPLMUnregisterDataAccessor(this->df_predictedMinVoltage);
     XPLMUnregisterDataAccessor(this->df_voltage);
     XPLMUnregisterDataAccessor(this->df_rssi);
     XPLMUnregisterDataAccessor(this->df_failsafe);
+    XPLMUnregisterDataAccessor(this->df_rssiTerrainLossDb);
 
     XPLMUnregisterDataAccessor(this->df_control_throttle);
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <XPLMDataAccess.h>
 
 #include "MathUtils.h"
+#include "OsdLatencyStatistics.h"
 
 using namespace MathUtils;
 
@@ -53,6 +54,33 @@ private:
     int OSDUpdates = 0;
     int OSDUpdatesLast = 0;
     int OSDUpdatesPerSecond = 0;
+    XPLMDataRef df_OSDChangedCellsPerSecond;
+    int OSDChangedCells = 0;
+    int OSDChangedCellsLast = 0;
+    int OSDChangedCellsPerSecond = 0;
+    XPLMDataRef df_OSDChangedCellsPerFrame;
+    int OSDChangedCellsPerFrame = 0;
+    XPLMDataRef df_OSDFramesTornPerSecond;
+    int OSDFramesTorn = 0;
+    int OSDFramesTornLast = 0;
+    int OSDFramesTornPerSecond = 0;
+    XPLMDataRef df_OSDTearsPreventedPerSecond;
+    int OSDTearsPrevented = 0;
+    int OSDTearsPreventedLast = 0;
+    int OSDTearsPreventedPerSecond = 0;
+    // Per TOsdLatencyStage
+    XPLMDataRef df_OSDLatencyMeanMs;
+    float OSDLatencyMeanMs[OSD_LATENCY_STAGES] = {};
+    XPLMDataRef df_OSDLatencyP50Ms;
+    float OSDLatencyP50Ms[OSD_LATENCY_STAGES] = {};
+    XPLMDataRef df_OSDLatencyP95Ms;
+    float OSDLatencyP95Ms[OSD_LATENCY_STAGES] = {};
+    XPLMDataRef df_OSDLatencyP99Ms;
+    float OSDLatencyP99Ms[OSD_LATENCY_STAGES] = {};
+    XPLMDataRef df_OSDLatencyMaxMs;
+    float OSDLatencyMaxMs[OSD_LATENCY_STAGES] = {};
+    XPLMDataRef df_OSDFrameRateHz;
+    float OSDFrameRateHz = 0.0f;
 
     XPLMDataRef df_eulerAngles;
     float dbg_eulerAngles[3] = {0, 0, 0};
@@ -70,10 +98,51 @@ private:
     int cycles = 0;
     int cyclesLast = 0;
 
+    XPLMDataRef df_dataRefTimeUs;
+    float dataRefTimeUs = 0.0f;
+    float dataRefTimeUsSum = 0.0f;
+    int dataRefTimeSamples = 0;
+
+    XPLMDataRef df_dataRefCallsPerCycle;
+    int dataRefCallsPerCycle = 0;
+
+    // Sensor sender thread
+    XPLMDataRef df_senderRateHz;
+    int senderRateHz = 0;
+    XPLMDataRef df_senderJitterMeanUs;
+    float senderJitterMeanUs = 0.0f;
+    XPLMDataRef df_senderJitterStdDevUs;
+    float senderJitterStdDevUs = 0.0f;
+    XPLMDataRef df_senderJitterMaxUs;
+    float senderJitterMaxUs = 0.0f;
+    XPLMDataRef df_senderOverruns;
+    int senderOverruns = 0;
+
+    // Lockstep mode
+    XPLMDataRef df_lockstepStepsPerSecond;
+    int lockstepStepsPerSecond = 0;
+    XPLMDataRef df_lockstepRealtimeFactor;
+    float lockstepRealtimeFactor = 0.0f;
+    XPLMDataRef df_lockstepTimeouts;
+    int lockstepTimeouts = 0;
+
+    // Mean absolute real vs. INAV estimated attitude error over the last second, roll, pitch, yaw in degrees
+    XPLMDataRef df_attitudeErrorDeg;
+    float attitudeErrorDeg[3] = {0, 0, 0};
+    // Same error since the last arm (or connection), updated every second
+    XPLMDataRef df_attitudeErrorRmsDeg;
+    float attitudeErrorRmsDeg[3] = {0, 0, 0};
+    XPLMDataRef df_attitudeErrorMaxDeg;
+    float attitudeErrorMaxDeg[3] = {0, 0, 0};
+    XPLMDataRef df_attitudeErrorP95Deg;
+    float attitudeErrorP95Deg[3] = {0, 0, 0};
+    XPLMDataRef df_attitudeErrorSamples;
+    int attitudeErrorSamples = 0;
+
     XPLMDataRef df_XitlVersion;
     int xitlVersion = DataRefsConstants::XITL_DATAREF_VERSION; 
 
-    uint32_t lastUpdate = 0;
+    int64_t lastUpdateUs = 0;
 
     // SITL datarefs
     XPLMDataRef df_sitl_heartbeat;
@@ -93,9 +162,13 @@ private:
     float groundspeed = 0.0f;
     XPLMDataRef df_gps_velocitys;
     float gps_velocitys[3] = {0, 0, 0};
+    XPLMDataRef df_gps_hdop;
+    float gps_hdop = 0.0f;
 
     XPLMDataRef df_magnetometer;
     float magnetometer[3] = {0, 0, 0};
+    XPLMDataRef df_magDeclination;
+    float magDeclination = 0.0f;
 
     XPLMDataRef df_rangefinder;
     int rangefinder_distance_cm = 0.0f;
@@ -108,6 +181,14 @@ private:
 
     XPLMDataRef df_voltage;
     float voltage = 0.0f;
+    XPLMDataRef df_minCellVoltage;
+    float minCellVoltage = 0.0f;
+    XPLMDataRef df_batteryTemperature;
+    float batteryTemperature = 0.0f; // °C, hottest cell
+    XPLMDataRef df_predictedTimeRemaining;
+    float predictedTimeRemaining = -1.0f; // seconds, -1 if not available
+    XPLMDataRef df_predictedMinVoltage;
+    float predictedMinVoltage = 0.0f;
 
     // RC
     XPLMDataRef df_control_throttle;
@@ -119,9 +200,13 @@ private:
     XPLMDataRef df_failsafe;
     int isFailsafe = 0;
 
+    XPLMDataRef df_rssiTerrainLossDb;
+    float rssiTerrainLossDb = 0.0f;
+
     void loop();
 
     XPLMDataRef registerIntDataRef(const char *pName, int *pValue, bool pIsReadOnly = true);
     XPLMDataRef registerFloatDataRef(const char *pName, float *pValue, bool pIsReadOnly = true);
     XPLMDataRef registerVector3DataRef(const char *pName, float *pValue);
+    XPLMDataRef registerFloatArrayDataRef(const char *pName, float *pValue, XPLMGetDatavf_f pReader);
 };
@@ -0,0 +1,71 @@
+#include "DebugAssembler.h"
+
+#include <algorithm>
+
+DebugAssembler::DebugAssembler()
+{
+    this->reset();
+}
+
+void DebugAssembler::reset()
+{
+    this->channels.fill({0.0f, 0.0f, 0, 0});
+    this->replyTimesUs.fill(0);
+    this->sequence = 0;
+}
+
+bool DebugAssembler::add(int channel, float value, int64_t timeUs, TDebugFrame &frame)
+{
+    using namespace DebugAssemblerConstants;
+
+    if (channel < 0 || channel >= CHANNELS)
+    {
+        return false;
+    }
+
+    this->sequence++;
+    this->replyTimesUs[this->sequence % STALE_REPLIES] = timeUs;
+
+    TChannel &updated = this->channels[channel];
+    updated.previousValue = updated.value;
+    updated.previousSequence = updated.sequence;
+    updated.value = value;
+    updated.sequence = this->sequence;
+
+    // Also excludes channels without a value yet
+    const int64_t staleSequence = std::max<int64_t>(this->sequence - STALE_REPLIES, 0);
+
+    // Newest reply every live channel has a value at or after
+    int64_t alignSequence = this->sequence;
+    if (this->mode == DEBUG_ASSEMBLY_INTERPOLATE)
+    {
+        for (const TChannel &c : this->channels)
+        {
+            if (c.sequence > staleSequence)
+            {
+                alignSequence = std::min(alignSequence, c.sequence);
+            }
+        }
+    }
+
+    frame.timeUs = this->replyTimesUs[alignSequence % STALE_REPLIES];
+    for (int i = 0; i < CHANNELS; i++)
+    {
+        const TChannel &c = this->channels[i];
+        if (c.sequence <= staleSequence || c.previousSequence <= staleSequence || alignSequence >= c.sequence)
+        {
+            frame.values[i] = c.value;
+        }
+        else if (alignSequence <= c.previousSequence)
+        {
+            frame.values[i] = c.previousValue;
+        }
+        else
+        {
+            const float t = static_cast<float>(alignSequence - c.previousSequence) / static_cast<float>(c.sequence - c.previousSequence);
+            frame.values[i] = c.previousValue + (c.value - c.previousValue) * t;
+        }
+    }
+
+    return true;
+}
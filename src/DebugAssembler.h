@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace DebugAssemblerConstants
+{
+    // INAV debug[] channels, one of them per MSP_SIMULATOR reply
+    static constexpr int CHANNELS = 8;
+    // Channels without a value for this many replies are held, not interpolated
+    static constexpr int STALE_REPLIES = 32;
+}
+
+typedef enum
+{
+    DEBUG_ASSEMBLY_HOLD = 0,        // latest value of every channel, frame at the newest reply
+    DEBUG_ASSEMBLY_INTERPOLATE = 1, // all channels interpolated to one common reply, ~7 replies delay
+} TDebugAssembly;
+
+struct TDebugFrame
+{
+    int64_t timeUs; // receive time of the reply the values are aligned to
+    std::array<float, DebugAssemblerConstants::CHANNELS> values;
+};
+
+/**
+ * @brief Assembles the round robin debug values of the MSP_SIMULATOR replies into complete frames.
+ *
+ * Every reply carries one of the eight debug[] channels, so each channel alone updates at 1/8 of
+ * the link rate, and the latest values of two channels are up to seven replies apart. The assembler
+ * emits a frame for every reply. In interpolate mode the values are linearly interpolated to the
+ * newest reply for which every channel has a value at or after it, which makes the frame coherent.
+ * Interpolation runs over the reply count, not the receive time, because replies processed in
+ * the same flight loop cycle share almost the same receive time.
+ */
+class DebugAssembler
+{
+public:
+    DebugAssembler();
+
+    void setMode(TDebugAssembly mode) { this->mode = mode; }
+    void reset();
+
+    // One reply, fills frame and returns true if there is a frame to publish
+    bool add(int channel, float value, int64_t timeUs, TDebugFrame &frame);
+
+private:
+    struct TChannel
+    {
+        float value;
+        float previousValue;
+        int64_t sequence; // reply number of value, 0 = no value yet
+        int64_t previousSequence;
+    };
+
+    TDebugAssembly mode = DEBUG_ASSEMBLY_HOLD;
+    std::array<TChannel, DebugAssemblerConstants::CHANNELS> channels;
+    int64_t sequence = 0;
+    // Receive times of the last replies, indexed by reply number
+    std::array<int64_t, DebugAssemblerConstants::STALE_REPLIES> replyTimesUs;
+};
@@ -0,0 +1,179 @@
+#include "EnduranceEstimator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <thread>
+
+namespace
+{
+    // Runs up to maxSteps steps of the profile, returns true when the battery is empty or maxTimeS is reached
+    bool advance(PowerTrain &powerTrain, const TFlightProfile &profile, TEnduranceResult &result, int &step, int maxSteps, double stepS, double maxTimeS)
+    {
+        const size_t samples = profile.samples.size();
+        for (int i = 0; i < maxSteps; i++)
+        {
+            if (powerTrain.isBatteryDischarged() || result.flightTimeS >= maxTimeS)
+            {
+                result.discharged = powerTrain.isBatteryDischarged();
+                result.remainingCapacityMah = powerTrain.getCurrentBatteryCapacityMah();
+                if (result.minVoltage == std::numeric_limits<double>::max())
+                {
+                    result.minVoltage = 0.0;
+                }
+                return true;
+            }
+
+            const size_t index = static_cast<size_t>(step * stepS / profile.sampleIntervalS) % samples;
+            const TProfileSample &sample = profile.samples[index];
+            powerTrain.update(sample.throttle, sample.climbAngleDeg, stepS);
+            step++;
+
+            if (!powerTrain.isBatteryDischarged())
+            {
+                result.flightTimeS += stepS;
+                result.minVoltage = std::min(result.minVoltage, powerTrain.getCurrentBatteryVoltage());
+            }
+        }
+        return false;
+    }
+
+    TEnduranceResult startResult()
+    {
+        TEnduranceResult result;
+        result.minVoltage = std::numeric_limits<double>::max();
+        return result;
+    }
+}
+
+TEnduranceResult EnduranceEstimator::estimate(const PowerTrain &powerTrain, const TFlightProfile &profile, double stepS, double maxTimeS)
+{
+    TEnduranceResult result = startResult();
+    if (profile.samples.empty())
+    {
+        result.minVoltage = powerTrain.getCurrentBatteryVoltage();
+        result.remainingCapacityMah = powerTrain.getCurrentBatteryCapacityMah();
+        return result;
+    }
+
+    PowerTrain simulated = powerTrain;
+    int step = 0;
+    advance(simulated, profile, result, step, std::numeric_limits<int>::max(), stepS, maxTimeS);
+    return result;
+}
+
+std::vector<TEnduranceResult> EnduranceEstimator::estimateAll(const PowerTrain &powerTrain, const std::vector<TFlightProfile> &profiles, unsigned int threads, double stepS, double maxTimeS)
+{
+    std::vector<TEnduranceResult> results(profiles.size());
+    if (threads == 0)
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::min<unsigned int>(threads, profiles.size());
+
+    // Profiles differ a lot in length, so each thread takes the next one instead of a fixed share
+    std::atomic<size_t> next = 0;
+    auto worker = [&]()
+    {
+        for (size_t i = next++; i < profiles.size(); i = next++)
+        {
+            results[i] = EnduranceEstimator::estimate(powerTrain, profiles[i], stepS, maxTimeS);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned int i = 1; i < threads; i++)
+    {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (std::thread &thread : pool)
+    {
+        thread.join();
+    }
+    return results;
+}
+
+void EnduranceEstimator::reset()
+{
+    this->recorded.clear();
+    this->recordedNext = 0;
+    this->sampleThrottleSum = 0.0;
+    this->sampleClimbAngleSum = 0.0;
+    this->sampleTimeS = 0.0;
+    this->running = false;
+    this->predictionValid = false;
+}
+
+void EnduranceEstimator::record(double throttle, double climbAngleDeg, double dtSec)
+{
+    if (dtSec <= 0.0)
+    {
+        return;
+    }
+
+    // Time weighted average over the sample interval
+    this->sampleThrottleSum += throttle * dtSec;
+    this->sampleClimbAngleSum += climbAngleDeg * dtSec;
+    this->sampleTimeS += dtSec;
+    if (this->sampleTimeS < EnduranceEstimatorConstants::SAMPLE_INTERVAL_S)
+    {
+        return;
+    }
+
+    const TProfileSample sample = {this->sampleThrottleSum / this->sampleTimeS, this->sampleClimbAngleSum / this->sampleTimeS};
+    if (this->recorded.size() < EnduranceEstimatorConstants::RECORDED_SAMPLES)
+    {
+        this->recorded.push_back(sample);
+    }
+    else
+    {
+        this->recorded[this->recordedNext] = sample;
+    }
+    this->recordedNext = (this->recordedNext + 1) % EnduranceEstimatorConstants::RECORDED_SAMPLES;
+
+    this->sampleThrottleSum = 0.0;
+    this->sampleClimbAngleSum = 0.0;
+    this->sampleTimeS = 0.0;
+}
+
+bool EnduranceEstimator::update(const PowerTrain &powerTrain, int steps)
+{
+    if (this->recorded.empty())
+    {
+        return false;
+    }
+
+    if (!this->running)
+    {
+        this->startPrediction(powerTrain);
+    }
+
+    if (!advance(this->simulated, this->profile, this->result, this->step, steps, EnduranceEstimatorConstants::STEP_S, EnduranceEstimatorConstants::MAX_FLIGHT_TIME_S))
+    {
+        return false;
+    }
+
+    this->prediction = this->result;
+    this->predictionValid = true;
+    this->running = false;
+    return true;
+}
+
+void EnduranceEstimator::startPrediction(const PowerTrain &powerTrain)
+{
+    // Oldest sample first, so the profile repeats in the order it was flown
+    this->profile.samples.clear();
+    const size_t count = this->recorded.size();
+    const size_t oldest = count < EnduranceEstimatorConstants::RECORDED_SAMPLES ? 0 : this->recordedNext;
+    for (size_t i = 0; i < count; i++)
+    {
+        this->profile.samples.push_back(this->recorded[(oldest + i) % count]);
+    }
+    this->profile.sampleIntervalS = EnduranceEstimatorConstants::SAMPLE_INTERVAL_S;
+
+    this->simulated = powerTrain;
+    this->result = startResult();
+    this->step = 0;
+    this->running = true;
+}
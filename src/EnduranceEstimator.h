@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "PowerTrain.h"
+
+namespace EnduranceEstimatorConstants
+{
+    static constexpr double STEP_S = 0.5;                   // Power train update step of the prediction
+    static constexpr double MAX_FLIGHT_TIME_S = 4 * 3600.0; // Predictions stop here, e.g. for gliding profiles
+    static constexpr double SAMPLE_INTERVAL_S = 1.0;        // Recorded in-sim profile: one averaged sample per second
+    static constexpr int RECORDED_SAMPLES = 120;            // of the last two minutes
+    static constexpr int STEPS_PER_UPDATE = 200;            // In-sim prediction steps per frame
+}
+
+struct TProfileSample
+{
+    double throttle;      // 0..1
+    double climbAngleDeg;
+};
+
+// Throttle and climb angle over time, repeated until the battery is empty
+struct TFlightProfile
+{
+    std::vector<TProfileSample> samples;
+    double sampleIntervalS = EnduranceEstimatorConstants::SAMPLE_INTERVAL_S;
+};
+
+struct TEnduranceResult
+{
+    double flightTimeS = 0.0;        // until discharged, or MAX_FLIGHT_TIME_S
+    double minVoltage = 0.0;         // under load, before discharge
+    double remainingCapacityMah = 0.0;
+    bool discharged = false;
+};
+
+/**
+ * @brief Predicts flight time, minimum voltage and remaining capacity by running a copy of a
+ * power train through flight profiles.
+ *
+ * estimate() / estimateAll() evaluate complete profiles, estimateAll() spread over all cores
+ * (used by the endurance_calculator tool). In the sim, the throttle and climb angle of the last
+ * two minutes are recorded and the prediction from the current battery state is advanced by a
+ * fixed number of steps per frame, so the cost per frame stays constant. A finished prediction
+ * is kept until the next one is done.
+ */
+class EnduranceEstimator
+{
+public:
+    // Runs a copy of powerTrain, its current battery state is the start state
+    static TEnduranceResult estimate(const PowerTrain &powerTrain, const TFlightProfile &profile,
+                                     double stepS = EnduranceEstimatorConstants::STEP_S,
+                                     double maxTimeS = EnduranceEstimatorConstants::MAX_FLIGHT_TIME_S);
+    // threads = 0: one per core
+    static std::vector<TEnduranceResult> estimateAll(const PowerTrain &powerTrain, const std::vector<TFlightProfile> &profiles, unsigned int threads = 0,
+                                                     double stepS = EnduranceEstimatorConstants::STEP_S,
+                                                     double maxTimeS = EnduranceEstimatorConstants::MAX_FLIGHT_TIME_S);
+
+    // In-sim prediction
+    void reset();
+    void record(double throttle, double climbAngleDeg, double dtSec);
+    // Advances the running prediction, starts a new one from powerTrain if none is running.
+    // Returns true if a prediction has finished in this call.
+    bool update(const PowerTrain &powerTrain, int steps = EnduranceEstimatorConstants::STEPS_PER_UPDATE);
+
+    bool hasPrediction() const { return this->predictionValid; }
+    const TEnduranceResult &getPrediction() const { return this->prediction; }
+
+private:
+    // Recorded profile, ring buffer
+    std::vector<TProfileSample> recorded;
+    size_t recordedNext = 0;
+    double sampleThrottleSum = 0.0;
+    double sampleClimbAngleSum = 0.0;
+    double sampleTimeS = 0.0;
+
+    // Running prediction
+    bool running = false;
+    PowerTrain simulated;
+    TFlightProfile profile;
+    TEnduranceResult result;
+    int step = 0;
+
+    bool predictionValid = false;
+    TEnduranceResult prediction;
+
+    void startPrediction(const PowerTrain &powerTrain);
+};
@@ -0,0 +1,158 @@
+#include "GpsReceiver.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "core/Clock.h"
+
+GpsReceiver::GpsReceiver()
+{
+    this->reset();
+}
+
+void GpsReceiver::configure(int rateHz, int latencyMs, int jitterMs)
+{
+    this->rateHz = std::clamp(rateHz, GpsReceiverConstants::MIN_RATE_HZ, GpsReceiverConstants::MAX_RATE_HZ);
+    this->latencyMs = std::clamp(latencyMs, 0, GpsReceiverConstants::MAX_LATENCY_MS);
+    this->jitterMs = std::clamp(jitterMs, 0, GpsReceiverConstants::MAX_JITTER_MS);
+    this->reset();
+}
+
+void GpsReceiver::setSatellites(int numSats, bool vary)
+{
+    this->configuredSats = std::max(numSats, 0);
+    this->varySatellites = vary && numSats > 0;
+    this->numSats = this->configuredSats;
+}
+
+void GpsReceiver::seed(uint64_t seed, uint32_t stream)
+{
+    this->random.seed(seed, stream);
+}
+
+void GpsReceiver::reset()
+{
+    this->hasSample = false;
+    this->head = 0;
+    this->count = 0;
+    this->numSats = this->configuredSats;
+}
+
+bool GpsReceiver::isSampleDue(int64_t nowUs) const
+{
+    return !this->hasSample || nowUs >= this->nextSampleUs();
+}
+
+int64_t GpsReceiver::nextSampleUs() const
+{
+    return this->sampleAnchorUs + this->sampleIndex * ClockConstants::US_PER_S / this->rateHz;
+}
+
+void GpsReceiver::addMeasurement(const TGpsMeasurement &measurement, int64_t nowUs)
+{
+    if (!this->hasSample)
+    {
+        this->hasSample = true;
+        this->sampleAnchorUs = nowUs;
+        this->sampleIndex = 0;
+        this->smoothedVelocity = measurement.velNED;
+        this->lastReleaseUs = nowUs;
+        this->lastSatelliteChangeUs = nowUs;
+    }
+    else
+    {
+        const float dt = 1.0f / this->rateHz;
+        const float alpha = dt / (GpsReceiverConstants::VELOCITY_SMOOTHING_S + dt);
+        this->smoothedVelocity.x += (measurement.velNED.x - this->smoothedVelocity.x) * alpha;
+        this->smoothedVelocity.y += (measurement.velNED.y - this->smoothedVelocity.y) * alpha;
+        this->smoothedVelocity.z += (measurement.velNED.z - this->smoothedVelocity.z) * alpha;
+    }
+
+    // Keep the sample grid, unless the flight loop stalled for more than a period
+    this->sampleIndex++;
+    if (this->sampleIndex == this->rateHz)
+    {
+        this->sampleAnchorUs += ClockConstants::US_PER_S;
+        this->sampleIndex = 0;
+    }
+    if (nowUs >= this->nextSampleUs())
+    {
+        this->sampleAnchorUs = nowUs;
+        this->sampleIndex = 1;
+    }
+
+    this->updateSatellites(nowUs);
+
+    TGpsSolution solution;
+    solution.latitude = measurement.latitude;
+    solution.longitude = measurement.longitude;
+    solution.elevation = measurement.elevation;
+    solution.velNED = this->smoothedVelocity;
+    solution.speed = hypotf(this->smoothedVelocity.x, this->smoothedVelocity.y);
+    if (solution.speed >= GpsReceiverConstants::MIN_COURSE_SPEED_MS)
+    {
+        this->course = atan2f(this->smoothedVelocity.y, this->smoothedVelocity.x) / MathUtils::DEG2RAD;
+        if (this->course < 0.0f)
+        {
+            this->course += 360.0f;
+        }
+    }
+    solution.course = this->course;
+    solution.numSats = this->numSats;
+    solution.hdop = hdopFromSatellites(this->numSats);
+    solution.sampleTimeUs = nowUs;
+
+    // Jitter must not reorder the solutions
+    const int64_t jitterUs = static_cast<int64_t>(this->random.uniform() * this->jitterMs * ClockConstants::US_PER_MS);
+    const int64_t releaseUs = std::max(nowUs + this->latencyMs * ClockConstants::US_PER_MS + jitterUs, this->lastReleaseUs);
+    this->lastReleaseUs = releaseUs;
+
+    if (this->count == GpsReceiverConstants::DELAY_LINE_SIZE)
+    {
+        // Can't happen within the configuration limits, drop the oldest
+        this->head = (this->head + 1) % GpsReceiverConstants::DELAY_LINE_SIZE;
+        this->count--;
+    }
+    const int tail = (this->head + this->count) % GpsReceiverConstants::DELAY_LINE_SIZE;
+    this->delayLine[tail] = {solution, releaseUs};
+    this->count++;
+}
+
+bool GpsReceiver::update(int64_t nowUs, TGpsSolution &solution)
+{
+    bool released = false;
+    while (this->count > 0 && nowUs >= this->delayLine[this->head].releaseUs)
+    {
+        solution = this->delayLine[this->head].solution;
+        this->head = (this->head + 1) % GpsReceiverConstants::DELAY_LINE_SIZE;
+        this->count--;
+        released = true;
+    }
+    return released;
+}
+
+void GpsReceiver::updateSatellites(int64_t nowUs)
+{
+    if (!this->varySatellites || nowUs - this->lastSatelliteChangeUs < GpsReceiverConstants::SATELLITE_CHANGE_PERIOD_US)
+    {
+        return;
+    }
+    this->lastSatelliteChangeUs = nowUs;
+
+    // -1, 0 or +1
+    const int step = static_cast<int>(this->random.next() % 3) - 1;
+    const int minSats = std::max(this->configuredSats - GpsReceiverConstants::SATELLITE_VARIATION_BELOW, 0);
+    const int maxSats = this->configuredSats + GpsReceiverConstants::SATELLITE_VARIATION_ABOVE;
+    this->numSats = std::clamp(this->numSats + step, minSats, maxSats);
+}
+
+// Rough geometry model: HDOP grows with 1/sqrt(satellites)
+float GpsReceiver::hdopFromSatellites(int numSats)
+{
+    if (numSats <= 0)
+    {
+        return GpsReceiverConstants::MAX_HDOP;
+    }
+    const float hdop = GpsReceiverConstants::HDOP_AT_REFERENCE_SATS * sqrtf(static_cast<float>(GpsReceiverConstants::HDOP_REFERENCE_SATS) / numSats);
+    return std::clamp(hdop, GpsReceiverConstants::MIN_HDOP, GpsReceiverConstants::MAX_HDOP);
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "MathUtils.h"
+#include "core/RandomStream.h"
+
+namespace GpsReceiverConstants
+{
+    static constexpr int MIN_RATE_HZ = 1;
+    static constexpr int MAX_RATE_HZ = 25;
+    static constexpr int DEFAULT_RATE_HZ = 5;
+    static constexpr int MAX_LATENCY_MS = 500;
+    static constexpr int MAX_JITTER_MS = 200;
+    // Enough for MAX_RATE_HZ samples in flight for MAX_LATENCY_MS + MAX_JITTER_MS
+    static constexpr int DELAY_LINE_SIZE = 32;
+
+    static constexpr float VELOCITY_SMOOTHING_S = 0.2f;
+    // Below this speed the course is held, the velocity direction is meaningless
+    static constexpr float MIN_COURSE_SPEED_MS = 0.5f;
+
+    // Satellite count random walk around the configured number
+    static constexpr int64_t SATELLITE_CHANGE_PERIOD_US = 5000000;
+    static constexpr int SATELLITE_VARIATION_BELOW = 3;
+    static constexpr int SATELLITE_VARIATION_ABOVE = 2;
+
+    static constexpr int HDOP_REFERENCE_SATS = 12;
+    static constexpr float HDOP_AT_REFERENCE_SATS = 0.9f;
+    static constexpr float MIN_HDOP = 0.6f;
+    static constexpr float MAX_HDOP = 99.9f;
+}
+
+// One position/velocity sample taken from X-Plane
+struct TGpsMeasurement
+{
+    double latitude;
+    double longitude;
+    double elevation;
+    MathUtils::vector3D velNED; // m/s north, east, down
+};
+
+// What the receiver reports, after smoothing and latency
+struct TGpsSolution
+{
+    double latitude;
+    double longitude;
+    double elevation;
+    MathUtils::vector3D velNED; // m/s north, east, down, smoothed
+    float speed;                // horizontal, m/s
+    float course;               // degrees, 0..360
+    int numSats;
+    float hdop;
+    int64_t sampleTimeUs;
+};
+
+/**
+ * @brief Timing model of a GPS receiver: update rate, output latency with jitter, satellites and HDOP.
+ *
+ * Measurements are taken at the configured rate, smoothed and queued in a fixed size delay line
+ * with their release time (sample time + latency + random jitter, never earlier than the previous
+ * solution). update() hands out the newest solution whose release time has passed. Every step
+ * is O(1) per measurement.
+ */
+class GpsReceiver
+{
+public:
+    GpsReceiver();
+
+    void configure(int rateHz, int latencyMs, int jitterMs);
+    void setSatellites(int numSats, bool vary);
+    void seed(uint64_t seed, uint32_t stream);
+    void reset();
+
+    // Times are Clock::NowUs(), or the sim clock in lockstep
+    bool isSampleDue(int64_t nowUs) const;
+    void addMeasurement(const TGpsMeasurement &measurement, int64_t nowUs);
+
+    // Releases all solutions due at nowUs, returns true and the newest one if there was any
+    bool update(int64_t nowUs, TGpsSolution &solution);
+
+    int getRateHz() const { return this->rateHz; }
+
+private:
+    struct TPendingSolution
+    {
+        TGpsSolution solution;
+        int64_t releaseUs;
+    };
+
+    int rateHz = GpsReceiverConstants::DEFAULT_RATE_HZ;
+    int latencyMs = 0;
+    int jitterMs = 0;
+
+    int configuredSats = 12;
+    bool varySatellites = false;
+    int numSats = 12;
+    int64_t lastSatelliteChangeUs = 0;
+
+    RandomStream random;
+
+    // Sample n of the current second is due at sampleAnchorUs + n * 1000000 / rateHz
+    int64_t sampleAnchorUs = 0;
+    int sampleIndex = 0;
+    bool hasSample = false;
+    MathUtils::vector3D smoothedVelocity = {0.0f, 0.0f, 0.0f};
+    float course = 0.0f;
+    int64_t lastReleaseUs = 0;
+
+    std::array<TPendingSolution, GpsReceiverConstants::DELAY_LINE_SIZE> delayLine;
+    int head = 0;
+    int count = 0;
+
+    int64_t nextSampleUs() const;
+    void updateSatellites(int64_t nowUs);
+    static float hdopFromSatellites(int numSats);
+};
@@ -13,6 +13,7 @@
 #include "core/EventBus.h"
 #include "Graph.h"
 #include "Utils.h"
+#include "core/Clock.h"
 #include "settings/SettingNames.h"
 
 static constexpr int DEBUG_U32_COUNT = 8;
@@ -137,9 +138,9 @@ Graph::Graph()
     this->activeCount = 0;
     this->lastLen = 0;
     this->pSeriesName = "";
-    memset(this->debug, 0, sizeof(float) * 8);
+    memset(this->attitudeError, 0, sizeof(this->attitudeError));
 
-    this->lastUpdatesCountTime = 0;
+    this->lastUpdatesCountTimeUs = 0;
     this->updatesCount = 0;
     this->updatesCountValue = 0;
 
@@ -199,15 +200,18 @@ Graph::Graph()
         this->addEstimatedAttitudeYPR(event.vector.x, event.vector.y, event.vector.z);
     });
 
-    eventBus->Subscribe<IntEventArg>("AddUpdatePeriodMS", [this](const IntEventArg &event) {
+    eventBus->Subscribe<Vector3EventArgs>("AttitudeEstimationError", [this](const Vector3EventArgs &event) {
+        this->attitudeError[0] = event.vector.x;
+        this->attitudeError[1] = event.vector.y;
+        this->attitudeError[2] = event.vector.z;
+    });
+
+    eventBus->Subscribe<FloatEventArg>("AddUpdatePeriodMS", [this](const FloatEventArg &event) {
         this->addUpdatePeriodMS(event.value);
     });
 
-    eventBus->Subscribe<AddDebugEventArg>("AddDebug", [this](const AddDebugEventArg &event) {
-        if (event.index >= 0 && event.index < DEBUG_U32_COUNT)
-        {
-            this->addDebug(event.index, event.value);
-        }
+    eventBus->Subscribe<DebugFrameEventArg>("DebugFrame", [this](const DebugFrameEventArg &event) {
+        this->addDebugFrame(event.frame);
     });
 }
 
@@ -255,6 +259,13 @@ void Graph::drawCallback()
 
     XPLMDrawString(col, (int)(bx + 4.0f), (int)y, (char *)this->pSeriesName, NULL, xplmFont_Basic);
 
+    if (this->graph_type == GRAPH_ATTITUDE_ESTIMATION)
+    {
+        char msg[100];
+        sprintf(msg, "Mean error R/P/Y: %.1f / %.1f / %.1f deg", this->attitudeError[0], this->attitudeError[1], this->attitudeError[2]);
+        XPLMDrawString(col, (int)(bx + 4.0f), (int)(y - lineHeight), msg, NULL, xplmFont_Basic);
+    }
+
     float y2 = by + 4 + this->activeCount * lineHeight;
 
     for (int i = 0; i < this->activeCount; i++)
@@ -497,37 +508,34 @@ void Graph::addGyro(float x, float y, float z)
 
 
 
-void Graph::addDebug(int index, float value)
+void Graph::addDebugFrame(const TDebugFrame &frame)
 {
     if ((this->graph_type != GRAPH_DEBUG_ALTITUDE) && (this->graph_type != GRAPH_DEBUG_CUSTOM))
         return;
 
-    this->debug[index] = value;
-    if (index == 7)
+    // One point per reply, all channels of the frame belong to the same moment
+    for (int i = 0; i < activeCount && i < DEBUG_U32_COUNT; i++)
     {
-        for (int i = 0; i < activeCount; i++)
-        {
-            this->series[i].addPoint(this->debug[i]);
-        }
+        this->series[i].addPoint(frame.values[i]);
     }
 }
 
 
 
-void Graph::addUpdatePeriodMS(uint32_t period)
+void Graph::addUpdatePeriodMS(float period)
 {
     if (this->graph_type != GRAPH_UPDATES)
         return;
-    this->series[0].addPoint((float)period);
+    this->series[0].addPoint(period);
 
     this->updatesCount++;
-    uint32_t t = Utils::GetTicks();
-    uint32_t delta = t - this->lastUpdatesCountTime;
-    if (delta >= 1000)
+    int64_t t = Clock::NowUs();
+    int64_t delta = t - this->lastUpdatesCountTimeUs;
+    if (delta >= ClockConstants::US_PER_S)
     {
         this->updatesCountValue = this->updatesCount;
         this->updatesCount = 0;
-        this->lastUpdatesCountTime = t;
+        this->lastUpdatesCountTimeUs = t;
     }
 
     this->series[1].addPoint((float)this->updatesCountValue);
@@ -2,6 +2,8 @@
 
 #include "platform.h"
 
+#include "DebugAssembler.h"
+
 static const char* SETTINGS_GRAPH_SECTION = "GraphSettings";
 static const char* SETTINGS_GRAPH_TYPE = "settings_graph_type";
 typedef enum
@@ -66,9 +68,9 @@ private:
   void addACC(float x, float y, float z );
   void addGyro(float x, float y, float z);
   void addEstimatedAttitudeYPR(float yaw, float pitch, float roll);
-  void addUpdatePeriodMS(uint32_t period);
+  void addUpdatePeriodMS(float period);
 
-  void addDebug(int index, float value);
+  void addDebugFrame(const TDebugFrame &frame);
 
   bool isActive = false;
 
@@ -78,9 +80,10 @@ private:
   const char* pSeriesName;
   size_t lastLen;
 
-  float debug[8];
+  // Mean absolute real vs. estimated attitude error of the last second: roll, pitch, yaw in degrees
+  float attitudeError[3];
 
-  uint32_t lastUpdatesCountTime;
+  int64_t lastUpdatesCountTimeUs;
   int updatesCount;
   int updatesCountValue;
 
@@ -1,7 +1,10 @@
 #include "MSP.h"
 #include "Utils.h"
+#include "core/Clock.h"
 
+#include <chrono>
 #include <cstring>
+#include <thread>
 
 #ifdef APL
 #include <iostream>
@@ -18,11 +21,11 @@
 #include "settings/SettingNames.h"
 
 namespace MSPConstants {
-    static constexpr int MSP_DETECT_TIMEOUT_MS = 300;
-    static constexpr int MSP_COMM_TIMEOUT_MS = 3000;
-    static constexpr int MSP_COMM_DEBUG_TIMEOUT_MS = 60000;
+    static constexpr int64_t MSP_DETECT_TIMEOUT_US = 300000;
+    static constexpr int64_t MSP_COMM_TIMEOUT_US = 3000000;
+    static constexpr int64_t MSP_COMM_DEBUG_TIMEOUT_US = 60000000;
     static constexpr int JUMBO_FRAME_MIN_SIZE = 255;
-    static constexpr int RECONNECT_DELAY_MS = 10000;
+    static constexpr int64_t RECONNECT_DELAY_US = 10000000;
     static constexpr int MAX_LINUX_TTY_PORTS = 16; // Max /dev/ttyACMx and /dev/ttyUSBx ports to probe, should be enough for everyone
     static constexpr int MAX_WINDOWS_COM_PORTS = 32; // Max COM ports to probe on Windows
     
@@ -42,7 +45,7 @@ MSP::MSP()
 {
     auto eventBus = Plugin()->GetEventBus();
 
-    eventBus->Subscribe<FlightLoopEventArg>("FlightLoop", [this](const FlightLoopEventArg &event)
+    eventBus->Subscribe<FlightLoopEventArg>("MspLoop", [this](const FlightLoopEventArg &event)
     { 
         this->loop(); 
     });
@@ -141,7 +144,7 @@ void MSP::connectDisconnect(bool toSitl)
 #if LIN
                     this->probeTtyUSB = false;
 #endif
-                    this->probeTime = Utils::GetTicks();
+                    this->probeTime = Clock::NowUs();
                 } else {
 #if IBM
                     std::string connectionString = "\\\\.\\" + this->comPort;
@@ -155,8 +158,8 @@ void MSP::connectDisconnect(bool toSitl)
                         {
                             Utils::LOG("MSP_VERSION sent");
                             this->state = STATE_CONNECT_SERIAL_WAIT;
-                            this->probeTime = Utils::GetTicks();
-                            this->lastUpdate = Utils::GetTicks();
+                            this->probeTime = Clock::NowUs();
+                            this->lastUpdate = Clock::NowUs();
                             this->decoderState = DS_IDLE;
                             return;
                         } 
@@ -186,7 +189,7 @@ void MSP::rebootAndReconnect()
     }
 
     this->sendCommand(MSPCommand::MSP_REBOOT);
-    this->reconnectTime = Utils::GetTicks() + MSPConstants::RECONNECT_DELAY_MS; // wait 5 seconds before reconnect attempt
+    this->reconnectTime = Clock::NowUs() + MSPConstants::RECONNECT_DELAY_US; // wait 5 seconds before reconnect attempt
     this->reconnectToSitl = typeid(*this->serial.get()) == typeid(TCPSerial);
     this->disconnect();
 }
@@ -211,6 +214,7 @@ void MSP::dispatchMessage(uint8_t expected_checksum)
 
 bool MSP::connectSerialPort(std::string &portName)
 {
+    std::lock_guard<std::recursive_mutex> lock(this->serialMutex);
     this->serial = SerialBase::CreateSerial(portName);
     try 
     {
@@ -273,8 +277,8 @@ bool MSP::probeNextPort()
         {
             Utils::LOG("MSP_FC_VERSION sent");
             this->state = STATE_ENUMERATE_WAIT;
-            this->probeTime = Utils::GetTicks();
-            this->lastUpdate = Utils::GetTicks();
+            this->probeTime = Clock::NowUs();
+            this->lastUpdate = Clock::NowUs();
             this->decoderState = DS_IDLE;
             return true;
         }
@@ -288,6 +292,7 @@ bool MSP::connectTCP()
   Utils::LOG("Connecting to {}:{}", this->tcpIp, this->tcpPort);
 
   std::string connectionString = "tcp://" + this->tcpIp + ":" + std::to_string(this->tcpPort);
+  std::lock_guard<std::recursive_mutex> lock(this->serialMutex);
   this->serial = SerialBase::CreateSerial(connectionString);
   try {
       this->serial->OpenConnection(connectionString);
@@ -305,8 +310,8 @@ bool MSP::connectTCP()
       Utils::LOG("MSP_VERSION sent");
       this->state = STATE_CONNECT_TCP_WAIT;
 
-      this->probeTime = Utils::GetTicks();
-      this->lastUpdate = Utils::GetTicks();
+      this->probeTime = Clock::NowUs();
+      this->lastUpdate = Clock::NowUs();
       this->decoderState = DS_IDLE;
       return true;
     }
@@ -318,15 +323,19 @@ bool MSP::connectTCP()
 void MSP::disconnect()
 {
     Utils::LOG("Disconnect");
-    if (this->serial)
     {
-        this->serial->flushOut();
-        if (this->serial->IsConnected())
+        std::lock_guard<std::recursive_mutex> lock(this->serialMutex);
+        if (this->serial)
         {
-            Utils::DelayMS(100); // make sure all bytes are sent. 100ms is enought to send 1kb
+            this->serial->flushOut();
+            this->publishSentCounters();
+            if (this->serial->IsConnected())
+            {
+                Utils::DelayMS(100); // make sure all bytes are sent. 100ms is enought to send 1kb
+            }
+            this->serial->CloseConnection();
+            this->serial = NULL;
         }
-        this->serial->CloseConnection();
-        this->serial = NULL;
     }
 
     bool timeout = false;
@@ -342,6 +351,66 @@ void MSP::disconnect()
     }
 }
 
+bool MSP::sendCommandImmediate(MSPCommand command, std::vector<uint8_t> &payload)
+{
+    std::lock_guard<std::recursive_mutex> lock(this->serialMutex);
+    if (!this->sendCommand(command, payload))
+    {
+        return false;
+    }
+    this->serial->flushOut();
+    return true;
+}
+
+bool MSP::waitForMessage(MSPCommand command, int64_t timeoutUs)
+{
+    if (this->state != STATE_CONNECTED)
+    {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::recursive_mutex> lock(this->serialMutex);
+        if (!this->serial)
+        {
+            return false;
+        }
+        this->serial->flushOut();
+        this->publishSentCounters();
+    }
+
+    this->waitForCode = command;
+    this->waitForCodeReceived = false;
+
+    const int64_t deadline = Clock::NowUs() + timeoutUs;
+    int emptyPolls = 0;
+    // decode() disconnects on communication timeout, state changes then
+    while (!this->waitForCodeReceived && this->state == STATE_CONNECTED && Clock::NowUs() < deadline)
+    {
+        this->decode();
+        if (this->waitForCodeReceived)
+        {
+            break;
+        }
+
+        // Sleep granularity is too coarse for a fast reply, only sleep once the FC is late
+        if (emptyPolls < MSPConstants::WAIT_YIELD_POLLS)
+        {
+            emptyPolls++;
+            std::this_thread::yield();
+        }
+        else
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(MSPConstants::WAIT_SLEEP_US));
+        }
+    }
+
+    const bool received = this->waitForCodeReceived;
+    this->waitForCode = -1;
+    this->waitForCodeReceived = false;
+    return received;
+}
+
 bool MSP::sendCommand(MSPCommand command)
 {
     std::vector<uint8_t> emptyPayload;
@@ -350,6 +419,7 @@ bool MSP::sendCommand(MSPCommand command)
 
 bool MSP::sendCommand(MSPCommand command, std::vector<uint8_t> &payload)
 {
+    std::lock_guard<std::recursive_mutex> lock(this->serialMutex);
     if (!this->serial || !this->serial->IsConnected())
     {
         return false;
@@ -393,13 +463,17 @@ bool MSP::sendCommand(MSPCommand command, std::vector<uint8_t> &payload)
 
 void MSP::decode()
 {
-    std::vector<uint8_t> data = this->serial->ReadData();
+    std::vector<uint8_t> data;
+    {
+        std::lock_guard<std::recursive_mutex> lock(this->serialMutex);
+        data = this->serial->ReadData();
+    }
 
     if (data.size() > 0)
     {
-        this->lastUpdate = Utils::GetTicks();
+        this->lastUpdate = Clock::NowUs();
     }
-    else if (Utils::GetTicks() > this->lastUpdate + (Utils::IsDebuggerAttached() ? MSPConstants::MSP_COMM_DEBUG_TIMEOUT_MS : MSPConstants::MSP_COMM_TIMEOUT_MS))
+    else if (Clock::NowUs() > this->lastUpdate + (Utils::IsDebuggerAttached() ? MSPConstants::MSP_COMM_DEBUG_TIMEOUT_US : MSPConstants::MSP_COMM_TIMEOUT_US))
     {
         this->state = STATE_TIMEOUT;
         this->disconnect();
@@ -617,6 +691,10 @@ void MSP::processMessage(const std::vector<uint8_t>& payload)
         break;
     }
     case STATE_CONNECTED:
+        if (this->code == this->waitForCode)
+        {
+            this->waitForCodeReceived = true;
+        }
         Plugin()->GetEventBus()->Publish<MSPMessageEventArg>("MSPMessage", MSPMessageEventArg(static_cast<MSPCommand>(this->code), payload));
         break;
     default:
@@ -638,7 +716,7 @@ void MSP::loop()
         break;
 
     case STATE_ENUMERATE_WAIT:
-        if (Utils::GetTicks() - this->probeTime > MSPConstants::MSP_DETECT_TIMEOUT_MS)
+        if (Clock::NowUs() - this->probeTime > MSPConstants::MSP_DETECT_TIMEOUT_US)
         {
             Utils::LOG("Probe Timeout");
             this->state = STATE_ENUMERATE;
@@ -650,7 +728,7 @@ void MSP::loop()
         break;
     case STATE_CONNECT_SERIAL_WAIT:
     case STATE_CONNECT_TCP_WAIT:
-        if (Utils::GetTicks() - this->probeTime > MSPConstants::MSP_DETECT_TIMEOUT_MS)
+        if (Clock::NowUs() - this->probeTime > MSPConstants::MSP_DETECT_TIMEOUT_US)
         {
             Utils::LOG("Connection Timeout");
             this->disconnect();
@@ -670,15 +748,28 @@ void MSP::loop()
     }
 
 
-    if (this->state == STATE_DISCONNECTED && this->reconnectTime != 0 && Utils::GetTicks() > this->reconnectTime)
+    if (this->state == STATE_DISCONNECTED && this->reconnectTime != 0 && Clock::NowUs() > this->reconnectTime)
     {
         this->connectDisconnect(this->reconnectToSitl); 
         this->reconnectTime = 0;
     }
 
+    std::lock_guard<std::recursive_mutex> lock(this->serialMutex);
     if (this->serial)
     {
         this->serial->flushOut();
+        this->publishSentCounters();
+    }
+}
+
+void MSP::publishSentCounters()
+{
+    int bytes = 0;
+    int packets = 0;
+    this->serial->takeSentCounters(bytes, packets);
+    if (packets > 0)
+    {
+        Plugin()->GetEventBus()->Publish<SerialTrafficEventArg>("SerialBytesSent", SerialTrafficEventArg(bytes, packets));
     }
 }
 
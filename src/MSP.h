@@ -3,6 +3,7 @@
 #include "platform.h"
 
 #include <functional>
+#include <mutex>
 
 #include "serial/SerialBase.h"
 
@@ -140,6 +141,10 @@ struct TMSPSimulatorFromINAV
 namespace MSPConstants
 {
     static constexpr int MSP_SIMULATOR_RESPOSE_MIN_LENGTH = (2 * 4 + 1 + 4 + 1);
+    // waitForMessage() polls with yield() first (the FC usually answers within a few hundred
+    // microseconds), then sleeps between polls so a slow or stalled FC doesn't cost a full core
+    static constexpr int WAIT_YIELD_POLLS = 200;
+    static constexpr int64_t WAIT_SLEEP_US = 200;
 }
 
 typedef enum
@@ -159,6 +164,13 @@ public:
 
     TMSPFCVersion version;
 
+    // Thread safe, sends and flushes right away instead of waiting for the next flight loop
+    bool sendCommandImmediate(MSPCommand command, std::vector<uint8_t> &payload);
+
+    // Flushes pending commands and processes incoming messages until one with the given code
+    // was dispatched, or the timeout passed. Main thread only, blocks the flight loop.
+    bool waitForMessage(MSPCommand command, int64_t timeoutUs);
+
 private:
     typedef enum
     {
@@ -205,14 +217,20 @@ private:
     std::string tcpIp;
     unsigned int tcpPort;
 
-    uint32_t lastUpdate = 0;
-    uint32_t reconnectTime = 0;
+    // Clock::NowUs()
+    int64_t lastUpdate = 0;
+    int64_t reconnectTime = 0;
     bool reconnectToSitl = false;
     bool restartOnAirportLoad = false;
 
     std::shared_ptr<SerialBase> serial;
+    // Guards the serial connection against the sensor sender thread
+    std::recursive_mutex serialMutex;
     int portID;
-    unsigned long probeTime;
+    int64_t probeTime;
+    // Set by processMessage() while waitForMessage() is waiting for it
+    int waitForCode = -1;
+    bool waitForCodeReceived = false;
 #if LIN
     bool probeTtyUSB = false;
 #endif
@@ -237,6 +255,7 @@ private:
     bool sendCommand(MSPCommand command);
     bool sendCommand(MSPCommand command, std::vector<uint8_t> &payload);
     void processMessage(std::vector<uint8_t> const &payload);
+    void publishSentCounters();
 
     uint8_t crc8_dvb_s2(uint8_t crc, unsigned char a) const;
 };
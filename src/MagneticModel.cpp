@@ -0,0 +1,399 @@
+#include "MagneticModel.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+    static constexpr int MAX_DEGREE = 12;
+    static constexpr double REFERENCE_RADIUS_KM = 6371.2;
+    static constexpr double WGS84_A_KM = 6378.137;
+    static constexpr double WGS84_F = 1.0 / 298.257223563;
+    static constexpr double MAX_LATITUDE = 89.99;
+    static constexpr double PI = 3.14159265358979323846;
+    static constexpr double DEG2RAD = PI / 180.0;
+    static constexpr double RAD2DEG = 180.0 / PI;
+
+    static constexpr float BUILTIN_EPOCH = 2020.0f;
+
+    // WMM2020 main field and secular variation, the complete degree 12 model from WMM.COF. Within
+    // its 2020-2025 validity about 0.5 degree of declination away from the poles; later dates
+    // extrapolate the secular variation, use tools/WmmGridGenerator with a newer WMM.COF for those.
+    static const std::vector<TMagneticCoefficient> BUILTIN_COEFFICIENTS = {
+        {1, 0, -29404.5f, 0.0f, 6.7f, 0.0f},
+        {1, 1, -1450.7f, 4652.9f, 7.7f, -25.1f},
+        {2, 0, -2500.0f, 0.0f, -11.5f, 0.0f},
+        {2, 1, 2982.0f, -2991.6f, -7.1f, -30.2f},
+        {2, 2, 1676.8f, -734.8f, -2.2f, -23.9f},
+        {3, 0, 1363.9f, 0.0f, 2.8f, 0.0f},
+        {3, 1, -2381.0f, -82.2f, -6.2f, 5.7f},
+        {3, 2, 1236.2f, 241.8f, 3.4f, -1.0f},
+        {3, 3, 525.7f, -542.9f, -12.2f, 1.1f},
+        {4, 0, 903.1f, 0.0f, -1.1f, 0.0f},
+        {4, 1, 809.4f, 282.0f, -1.6f, 0.2f},
+        {4, 2, 86.2f, -158.4f, -6.0f, 6.9f},
+        {4, 3, -309.4f, 199.8f, 5.4f, 3.7f},
+        {4, 4, 47.9f, -350.1f, -5.5f, -5.6f},
+        {5, 0, -234.4f, 0.0f, -0.3f, 0.0f},
+        {5, 1, 363.1f, 47.7f, 0.6f, 0.1f},
+        {5, 2, 187.8f, 208.4f, -0.7f, 2.5f},
+        {5, 3, -140.7f, -121.3f, 0.1f, -0.9f},
+        {5, 4, -151.2f, 32.2f, 1.2f, 3.0f},
+        {5, 5, 13.7f, 99.1f, 1.0f, 0.5f},
+        {6, 0, 65.9f, 0.0f, -0.6f, 0.0f},
+        {6, 1, 65.6f, -19.1f, -0.4f, 0.1f},
+        {6, 2, 73.0f, 25.0f, 0.5f, -1.8f},
+        {6, 3, -121.5f, 52.7f, 1.4f, -1.4f},
+        {6, 4, -36.2f, -64.4f, -1.4f, 0.9f},
+        {6, 5, 13.5f, 9.0f, -0.0f, 0.1f},
+        {6, 6, -64.7f, 68.1f, 0.8f, 1.0f},
+        {7, 0, 80.6f, 0.0f, -0.1f, 0.0f},
+        {7, 1, -76.8f, -51.4f, -0.3f, 0.5f},
+        {7, 2, -8.3f, -16.8f, -0.1f, 0.6f},
+        {7, 3, 56.5f, 2.3f, 0.7f, -0.7f},
+        {7, 4, 15.8f, 23.5f, 0.2f, -0.2f},
+        {7, 5, 6.4f, -2.2f, -0.5f, -1.2f},
+        {7, 6, -7.2f, -27.2f, -0.8f, 0.2f},
+        {7, 7, 9.8f, -1.9f, 1.0f, 0.3f},
+        {8, 0, 23.6f, 0.0f, -0.1f, 0.0f},
+        {8, 1, 9.8f, 8.4f, 0.1f, -0.3f},
+        {8, 2, -17.5f, -15.3f, -0.1f, 0.7f},
+        {8, 3, -0.4f, 12.8f, 0.5f, -0.2f},
+        {8, 4, -21.1f, -11.8f, -0.1f, 0.5f},
+        {8, 5, 15.3f, 14.9f, 0.4f, -0.3f},
+        {8, 6, 13.7f, 3.6f, 0.5f, -0.5f},
+        {8, 7, -16.5f, -6.9f, 0.0f, 0.4f},
+        {8, 8, -0.3f, 2.8f, 0.4f, 0.1f},
+        {9, 0, 5.0f, 0.0f, -0.1f, 0.0f},
+        {9, 1, 8.2f, -23.3f, -0.2f, -0.3f},
+        {9, 2, 2.9f, 11.1f, -0.0f, 0.2f},
+        {9, 3, -1.4f, 9.8f, 0.4f, -0.4f},
+        {9, 4, -1.1f, -5.1f, -0.3f, 0.4f},
+        {9, 5, -13.3f, -6.2f, -0.0f, 0.1f},
+        {9, 6, 1.1f, 7.8f, 0.3f, -0.0f},
+        {9, 7, 8.9f, 0.4f, -0.0f, -0.2f},
+        {9, 8, -9.3f, -1.5f, -0.0f, 0.5f},
+        {9, 9, -11.9f, 9.7f, -0.4f, 0.2f},
+        {10, 0, -1.9f, 0.0f, 0.0f, 0.0f},
+        {10, 1, -6.2f, 3.4f, -0.0f, -0.0f},
+        {10, 2, -0.1f, -0.2f, -0.0f, 0.1f},
+        {10, 3, 1.7f, 3.5f, 0.2f, -0.3f},
+        {10, 4, -0.9f, 4.8f, -0.1f, 0.1f},
+        {10, 5, 0.6f, -8.6f, -0.2f, -0.2f},
+        {10, 6, -0.9f, -0.1f, -0.0f, 0.1f},
+        {10, 7, 1.9f, -4.2f, -0.1f, -0.0f},
+        {10, 8, 1.4f, -3.4f, -0.2f, -0.1f},
+        {10, 9, -2.4f, -0.1f, -0.1f, 0.2f},
+        {10, 10, -3.9f, -8.8f, -0.0f, -0.0f},
+        {11, 0, 3.0f, 0.0f, -0.0f, 0.0f},
+        {11, 1, -1.4f, -0.0f, -0.1f, -0.0f},
+        {11, 2, -2.5f, 2.6f, -0.0f, 0.1f},
+        {11, 3, 2.4f, -0.5f, 0.0f, 0.0f},
+        {11, 4, -0.9f, -0.4f, -0.0f, 0.2f},
+        {11, 5, 0.3f, 0.6f, -0.1f, -0.0f},
+        {11, 6, -0.7f, -0.2f, 0.0f, 0.0f},
+        {11, 7, -0.1f, -1.7f, -0.0f, 0.1f},
+        {11, 8, 1.4f, -1.6f, -0.1f, -0.0f},
+        {11, 9, -0.6f, -3.0f, -0.1f, -0.1f},
+        {11, 10, 0.2f, -2.0f, -0.1f, 0.0f},
+        {11, 11, 3.1f, -2.6f, -0.1f, -0.0f},
+        {12, 0, -2.0f, 0.0f, 0.0f, 0.0f},
+        {12, 1, -0.1f, -1.2f, -0.0f, -0.0f},
+        {12, 2, 0.5f, 0.5f, -0.0f, 0.0f},
+        {12, 3, 1.3f, 1.3f, 0.0f, -0.1f},
+        {12, 4, -1.2f, -1.8f, -0.0f, 0.1f},
+        {12, 5, 0.7f, 0.1f, -0.0f, -0.0f},
+        {12, 6, 0.3f, 0.7f, 0.0f, 0.0f},
+        {12, 7, 0.5f, -0.1f, -0.0f, -0.0f},
+        {12, 8, -0.2f, 0.6f, 0.0f, 0.1f},
+        {12, 9, -0.5f, 0.2f, -0.0f, -0.0f},
+        {12, 10, 0.1f, -0.9f, -0.0f, -0.0f},
+        {12, 11, -1.1f, -0.0f, -0.0f, 0.0f},
+        {12, 12, -0.3f, 0.5f, -0.1f, -0.1f},
+    };
+}
+
+MagneticModel::MagneticModel()
+{
+    this->buildDefault(currentDecimalYear());
+}
+
+float MagneticModel::currentDecimalYear()
+{
+    const std::chrono::year_month_day date = std::chrono::floor<std::chrono::days>(std::chrono::system_clock::now());
+    const std::chrono::sys_days startOfYear = std::chrono::year_month_day(date.year(), std::chrono::January, std::chrono::day(1));
+    const int dayOfYear = (std::chrono::sys_days(date) - startOfYear).count();
+    const int daysInYear = date.year().is_leap() ? 366 : 365;
+    return static_cast<int>(date.year()) + static_cast<float>(dayOfYear) / daysInYear;
+}
+
+void MagneticModel::buildDefault(float decimalYear)
+{
+    this->build(BUILTIN_COEFFICIENTS, BUILTIN_EPOCH, decimalYear, MagneticModelConstants::DEFAULT_GRID_STEP_DEG);
+}
+
+void MagneticModel::build(const std::vector<TMagneticCoefficient> &coefficients, float epoch, float decimalYear, float stepDeg)
+{
+    this->step = stepDeg;
+    this->decimalYear = decimalYear;
+    this->latPoints = static_cast<int>(std::lround(180.0f / stepDeg)) + 1;
+    this->lonPoints = static_cast<int>(std::lround(360.0f / stepDeg)) + 1;
+    this->grid.resize(static_cast<size_t>(this->latPoints) * this->lonPoints);
+
+    for (int latIndex = 0; latIndex < this->latPoints; latIndex++)
+    {
+        const double latitude = -90.0 + latIndex * stepDeg;
+        for (int lonIndex = 0; lonIndex < this->lonPoints; lonIndex++)
+        {
+            const double longitude = -180.0 + lonIndex * stepDeg;
+            this->grid[latIndex * this->lonPoints + lonIndex] = evaluate(coefficients, epoch, decimalYear, latitude, longitude, 0.0);
+        }
+    }
+}
+
+bool MagneticModel::load(const std::string &fileName)
+{
+    std::ifstream file(fileName, std::ios::binary);
+    if (!file)
+    {
+        return false;
+    }
+
+    TGridFileHeader header = {};
+    file.read(reinterpret_cast<char *>(&header), sizeof(header));
+    if (!file || memcmp(header.magic, MagneticModelConstants::GRID_FILE_MAGIC, sizeof(header.magic)) != 0 || header.version != MagneticModelConstants::GRID_FILE_VERSION)
+    {
+        return false;
+    }
+
+    if (header.step <= 0.0f || header.latPoints != std::lround(180.0f / header.step) + 1 || header.lonPoints != std::lround(360.0f / header.step) + 1)
+    {
+        return false;
+    }
+
+    std::vector<TMagneticField> grid(static_cast<size_t>(header.latPoints) * header.lonPoints);
+    file.read(reinterpret_cast<char *>(grid.data()), grid.size() * sizeof(TMagneticField));
+    if (!file)
+    {
+        return false;
+    }
+
+    this->latPoints = header.latPoints;
+    this->lonPoints = header.lonPoints;
+    this->step = header.step;
+    this->decimalYear = header.decimalYear;
+    this->grid = std::move(grid);
+    return true;
+}
+
+bool MagneticModel::save(const std::string &fileName) const
+{
+    std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        return false;
+    }
+
+    TGridFileHeader header = {};
+    memcpy(header.magic, MagneticModelConstants::GRID_FILE_MAGIC, sizeof(header.magic));
+    header.version = MagneticModelConstants::GRID_FILE_VERSION;
+    header.latPoints = static_cast<uint16_t>(this->latPoints);
+    header.lonPoints = static_cast<uint16_t>(this->lonPoints);
+    header.step = this->step;
+    header.decimalYear = this->decimalYear;
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(this->grid.data()), this->grid.size() * sizeof(TMagneticField));
+    return static_cast<bool>(file);
+}
+
+TMagneticField MagneticModel::lookup(double latitude, double longitude) const
+{
+    latitude = std::clamp(latitude, -90.0, 90.0);
+    longitude = fmod(longitude + 180.0, 360.0);
+    if (longitude < 0.0)
+    {
+        longitude += 360.0;
+    }
+
+    const double latPosition = (latitude + 90.0) / this->step;
+    const double lonPosition = longitude / this->step;
+    const int latIndex = std::min(static_cast<int>(latPosition), this->latPoints - 2);
+    const int lonIndex = std::min(static_cast<int>(lonPosition), this->lonPoints - 2);
+    const float latFraction = static_cast<float>(latPosition - latIndex);
+    const float lonFraction = static_cast<float>(lonPosition - lonIndex);
+
+    const TMagneticField &f00 = this->at(latIndex, lonIndex);
+    const TMagneticField &f01 = this->at(latIndex, lonIndex + 1);
+    const TMagneticField &f10 = this->at(latIndex + 1, lonIndex);
+    const TMagneticField &f11 = this->at(latIndex + 1, lonIndex + 1);
+
+    // Declination wraps around +-180 near the magnetic poles, interpolate relative to the first corner
+    auto unwrap = [&](float declination)
+    {
+        float delta = declination - f00.declination;
+        if (delta > 180.0f)
+        {
+            delta -= 360.0f;
+        }
+        else if (delta < -180.0f)
+        {
+            delta += 360.0f;
+        }
+        return f00.declination + delta;
+    };
+
+    auto bilinear = [&](float v00, float v01, float v10, float v11)
+    {
+        const float v0 = v00 + (v01 - v00) * lonFraction;
+        const float v1 = v10 + (v11 - v10) * lonFraction;
+        return v0 + (v1 - v0) * latFraction;
+    };
+
+    TMagneticField field;
+    field.declination = bilinear(f00.declination, unwrap(f01.declination), unwrap(f10.declination), unwrap(f11.declination));
+    if (field.declination > 180.0f)
+    {
+        field.declination -= 360.0f;
+    }
+    else if (field.declination < -180.0f)
+    {
+        field.declination += 360.0f;
+    }
+    field.inclination = bilinear(f00.inclination, f01.inclination, f10.inclination, f11.inclination);
+    field.intensity = bilinear(f00.intensity, f01.intensity, f10.intensity, f11.intensity);
+    return field;
+}
+
+MathUtils::vector3D MagneticModel::getFieldVectorNED(const TMagneticField &field)
+{
+    const float declination = MathUtils::degreesToRadians(field.declination);
+    const float inclination = MathUtils::degreesToRadians(field.inclination);
+    const float intensity = field.intensity / MagneticModelConstants::NORMALIZATION_NT;
+
+    const float horizontal = intensity * cosf(inclination);
+    return {horizontal * cosf(declination), horizontal * sinf(declination), intensity * sinf(inclination)};
+}
+
+bool MagneticModel::parseCoefficientFile(const std::string &fileName, std::vector<TMagneticCoefficient> &coefficients, float &epoch)
+{
+    std::ifstream file(fileName);
+    if (!file)
+    {
+        return false;
+    }
+
+    // Header: epoch, model name, release date
+    std::string line;
+    if (!std::getline(file, line) || !(std::istringstream(line) >> epoch))
+    {
+        return false;
+    }
+
+    coefficients.clear();
+    while (std::getline(file, line))
+    {
+        if (line.compare(0, 4, "9999") == 0)
+        {
+            break;
+        }
+
+        TMagneticCoefficient coefficient = {};
+        std::istringstream stream(line);
+        if (stream >> coefficient.n >> coefficient.m >> coefficient.g >> coefficient.h >> coefficient.dg >> coefficient.dh)
+        {
+            if (coefficient.n >= 1 && coefficient.n <= MAX_DEGREE && coefficient.m >= 0 && coefficient.m <= coefficient.n)
+            {
+                coefficients.push_back(coefficient);
+            }
+        }
+    }
+
+    return !coefficients.empty();
+}
+
+TMagneticField MagneticModel::evaluate(const std::vector<TMagneticCoefficient> &coefficients, float epoch, float decimalYear, double latitude, double longitude, double altitudeKm)
+{
+    latitude = std::clamp(latitude, -MAX_LATITUDE, MAX_LATITUDE);
+
+    // Geodetic (WGS84) to geocentric spherical coordinates
+    const double phi = latitude * DEG2RAD;
+    const double lambda = longitude * DEG2RAD;
+    const double e2 = WGS84_F * (2.0 - WGS84_F);
+    const double rc = WGS84_A_KM / sqrt(1.0 - e2 * sin(phi) * sin(phi));
+    const double px = (rc + altitudeKm) * cos(phi);
+    const double pz = (rc * (1.0 - e2) + altitudeKm) * sin(phi);
+    const double r = sqrt(px * px + pz * pz);
+    const double phiGeocentric = asin(pz / r);
+
+    // Colatitude
+    const double theta = PI / 2.0 - phiGeocentric;
+    const double cosTheta = cos(theta);
+    const double sinTheta = sin(theta);
+
+    int maxDegree = 0;
+    for (const TMagneticCoefficient &coefficient : coefficients)
+    {
+        maxDegree = std::max(maxDegree, coefficient.n);
+    }
+
+    // Schmidt semi-normalized associated Legendre functions and their theta derivatives
+    double p[MAX_DEGREE + 1][MAX_DEGREE + 1] = {};
+    double dp[MAX_DEGREE + 1][MAX_DEGREE + 1] = {};
+    p[0][0] = 1.0;
+    for (int n = 1; n <= maxDegree; n++)
+    {
+        for (int m = 0; m <= n; m++)
+        {
+            if (n == m)
+            {
+                const double k = n == 1 ? 1.0 : sqrt((2.0 * n - 1.0) / (2.0 * n));
+                p[n][m] = k * sinTheta * p[n - 1][m - 1];
+                dp[n][m] = k * (sinTheta * dp[n - 1][m - 1] + cosTheta * p[n - 1][m - 1]);
+            }
+            else
+            {
+                const double k = sqrt(static_cast<double>(n * n - m * m));
+                const double k2 = n >= 2 ? sqrt(static_cast<double>((n - 1) * (n - 1) - m * m)) : 0.0;
+                const double pn2 = n >= 2 ? p[n - 2][m] : 0.0;
+                const double dpn2 = n >= 2 ? dp[n - 2][m] : 0.0;
+                p[n][m] = ((2.0 * n - 1.0) * cosTheta * p[n - 1][m] - k2 * pn2) / k;
+                dp[n][m] = ((2.0 * n - 1.0) * (cosTheta * dp[n - 1][m] - sinTheta * p[n - 1][m]) - k2 * dpn2) / k;
+            }
+        }
+    }
+
+    const double dt = decimalYear - epoch;
+    double x = 0.0, y = 0.0, z = 0.0;
+    for (const TMagneticCoefficient &coefficient : coefficients)
+    {
+        const int n = coefficient.n;
+        const int m = coefficient.m;
+        const double g = coefficient.g + dt * coefficient.dg;
+        const double h = coefficient.h + dt * coefficient.dh;
+        const double ratio = pow(REFERENCE_RADIUS_KM / r, n + 2);
+        const double cosM = cos(m * lambda);
+        const double sinM = sin(m * lambda);
+
+        x += ratio * (g * cosM + h * sinM) * dp[n][m];
+        y += ratio * m * (g * sinM - h * cosM) * p[n][m];
+        z -= ratio * (n + 1) * (g * cosM + h * sinM) * p[n][m];
+    }
+    y /= sinTheta;
+
+    // Rotate from geocentric back to the geodetic frame
+    const double psi = phiGeocentric - phi;
+    const double north = x * cos(psi) - z * sin(psi);
+    const double down = x * sin(psi) + z * cos(psi);
+
+    const double horizontal = sqrt(north * north + y * y);
+
+    TMagneticField field;
+    field.declination = static_cast<float>(atan2(y, north) * RAD2DEG);
+    field.inclination = static_cast<float>(atan2(down, horizontal) * RAD2DEG);
+    field.intensity = static_cast<float>(sqrt(horizontal * horizontal + down * down));
+    return field;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "MathUtils.h"
+
+namespace MagneticModelConstants
+{
+    static constexpr float DEFAULT_GRID_STEP_DEG = 5.0f;
+    // Field vectors are returned in units of this intensity, keeps the magnetometer around 1.0 like the old pure north vector
+    static constexpr float NORMALIZATION_NT = 50000.0f;
+
+    static constexpr char GRID_FILE_MAGIC[4] = {'W', 'M', 'M', 'G'};
+    static constexpr uint16_t GRID_FILE_VERSION = 1;
+}
+
+// One spherical harmonic coefficient pair as in WMM.COF, nT and nT/year
+struct TMagneticCoefficient
+{
+    int n;
+    int m;
+    float g;
+    float h;
+    float dg;
+    float dh;
+};
+
+struct TMagneticField
+{
+    float declination; // degrees, positive east
+    float inclination; // degrees, positive down
+    float intensity;   // nT
+};
+
+/**
+ * @brief Precomputed grid of declination, inclination and intensity with bilinear lookup.
+ *
+ * The grid is either loaded from a file written by tools/WmmGridGenerator (full WMM
+ * from WMM.COF) or built at startup from the built-in WMM2020 coefficients.
+ * Lookups are O(1) and don't evaluate the spherical harmonic model.
+ */
+class MagneticModel
+{
+public:
+    MagneticModel();
+
+    // Builds the grid from the built-in coefficients at the given date
+    void buildDefault(float decimalYear);
+    void build(const std::vector<TMagneticCoefficient> &coefficients, float epoch, float decimalYear, float stepDeg);
+
+    bool load(const std::string &fileName);
+    bool save(const std::string &fileName) const;
+
+    TMagneticField lookup(double latitude, double longitude) const;
+
+    // North, east, down in units of NORMALIZATION_NT
+    static MathUtils::vector3D getFieldVectorNED(const TMagneticField &field);
+
+    float getDecimalYear() const { return this->decimalYear; }
+    float getGridStep() const { return this->step; }
+
+    // Reads a WMM.COF coefficient file
+    static bool parseCoefficientFile(const std::string &fileName, std::vector<TMagneticCoefficient> &coefficients, float &epoch);
+
+    // Evaluates the spherical harmonic model at a geodetic position
+    static TMagneticField evaluate(const std::vector<TMagneticCoefficient> &coefficients, float epoch, float decimalYear, double latitude, double longitude, double altitudeKm);
+
+    static float currentDecimalYear();
+
+private:
+#pragma pack(push, 1)
+    struct TGridFileHeader
+    {
+        char magic[4];
+        uint16_t version;
+        uint16_t latPoints;
+        uint16_t lonPoints;
+        float step;
+        float decimalYear;
+    };
+#pragma pack(pop)
+
+    int latPoints = 0;
+    int lonPoints = 0;
+    float step = MagneticModelConstants::DEFAULT_GRID_STEP_DEG;
+    float decimalYear = 0.0f;
+
+    // [lat][lon], latitude from -90, longitude from -180, both including the end point
+    std::vector<TMagneticField> grid;
+
+    const TMagneticField &at(int latIndex, int lonIndex) const { return this->grid[latIndex * this->lonPoints + lonIndex]; }
+};
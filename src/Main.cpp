@@ -1,6 +1,5 @@
 #include "platform.h"
 
-#include <XPLMProcessing.h>
 #include <XPLMDisplay.h>
 
 #include "core/PluginContext.h"
@@ -12,15 +11,6 @@ static constexpr const char* pluginSig = "com.scavanger.inav.xplane-xitl";
 static constexpr const char* pluginDesc = "INAV Hardware/Software In The Loop";
 
 bool firstRender = true;
-XPLMFlightLoopID flightLoopId;
-
-// this flightloop callback will be called every frame to update the targets
-float Flightloop(float elapsed1, float elapsed2, int ctr, void *refcon)
-{
-    Plugin()->GetEventBus()->Publish("FlightLoop", FlightLoopEventArg{elapsed1, ctr});
-    return -1;
-}
-
 int DrawCallback(XPLMDrawingPhase inPhase, int inIsBefore, void *inRefcon)
 {
     Plugin()->GetEventBus()->Publish("DrawCallback", DrawCallbackEventArg{inPhase, inIsBefore});
@@ -61,21 +51,14 @@ PLUGIN_API int XPluginEnable(void)
         return 0;
     }
 
-    XPLMCreateFlightLoop_t params;
-    params.structSize = sizeof(XPLMCreateFlightLoop_t);
-    params.callbackFunc = &Flightloop;
-    params.phase = xplm_FlightLoop_Phase_AfterFlightModel;
-    params.refcon = NULL;
-    flightLoopId = XPLMCreateFlightLoop(&params);
-    XPLMScheduleFlightLoop(flightLoopId, -1, true);
-
     return 1;
 }
 
 PLUGIN_API void XPluginDisable(void)
 {
     Utils::LOG("Plugin disable");
-    XPLMDestroyFlightLoop(flightLoopId);
+    // Also destroys the flight loops
+    Plugin()->GetEventBus()->Publish("PluginDisabled");
 }
 
 PLUGIN_API void XPluginReceiveMessage(XPLMPluginID inFrom, int inMsg, void * inParam)
@@ -85,4 +68,9 @@ PLUGIN_API void XPluginReceiveMessage(XPLMPluginID inFrom, int inMsg, void * inP
         Plugin()->GetEventBus()->Publish("AirportLoaded");
         firstRender = false;
     }
+    else if (inMsg == XPLM_MSG_PLANE_LOADED && reinterpret_cast<intptr_t>(inParam) == 0)
+    {
+        // User aircraft
+        Plugin()->GetEventBus()->Publish("PlaneLoaded");
+    }
 } 
@@ -1,4 +1,5 @@
 #pragma once
+#include <algorithm>
 #include <cmath>
 #include <numbers>
 
@@ -69,6 +70,49 @@ namespace MathUtils
         return quat;
     }
 
+    // Inverse of computeQuaternionFromEuler, Euler angles in degrees, yaw 0...360
+    static eulerAngles computeEulerFromQuaternion(const quaternion &quat)
+    {
+        eulerAngles euler;
+
+        const float sinPitch = std::clamp(2.0f * (quat.w * quat.y - quat.z * quat.x), -1.0f, 1.0f);
+
+        euler.roll = atan2f(2.0f * (quat.w * quat.x + quat.y * quat.z), 1.0f - 2.0f * (quat.x * quat.x + quat.y * quat.y)) / DEG2RAD;
+        euler.pitch = asinf(sinPitch) / DEG2RAD;
+        euler.yaw = -atan2f(2.0f * (quat.w * quat.z + quat.x * quat.y), 1.0f - 2.0f * (quat.y * quat.y + quat.z * quat.z)) / DEG2RAD;
+        if (euler.yaw < 0.0f)
+            euler.yaw += 360.0f;
+
+        return euler;
+    }
+
+    static quaternion quaternionNormalize(const quaternion &quat)
+    {
+        const float norm = sqrtf(quat.w * quat.w + quat.x * quat.x + quat.y * quat.y + quat.z * quat.z);
+        if (norm < 1e-6f)
+        {
+            return {1.0f, 0.0f, 0.0f, 0.0f};
+        }
+        return {quat.w / norm, quat.x / norm, quat.y / norm, quat.z / norm};
+    }
+
+    // Rotation of q scaled by factor along the same axis, factor > 1 extrapolates
+    static quaternion quaternionScaleRotation(const quaternion &quat, float factor)
+    {
+        // Shortest path
+        quaternion q = quat.w < 0.0f ? quaternion{-quat.w, -quat.x, -quat.y, -quat.z} : quat;
+
+        const float sinHalfAngle = sqrtf(q.x * q.x + q.y * q.y + q.z * q.z);
+        if (sinHalfAngle < 1e-6f)
+        {
+            return {1.0f, 0.0f, 0.0f, 0.0f};
+        }
+
+        const float halfAngle = atan2f(sinHalfAngle, q.w) * factor;
+        const float scale = sinf(halfAngle) / sinHalfAngle;
+        return {cosf(halfAngle), q.x * scale, q.y * scale, q.z * scale};
+    }
+
     static quaternion quaternionConjugate(const quaternion &qaut)
     {
         quaternion result;
@@ -76,6 +76,7 @@ enum MenuItemRefs : size_t
     Battery4400LipoRef,
     Battery5200LionRef,
     Battery10400LionRef,
+    BatteryAircraftPackRef,
 
     // Beeper Menu
     BeeperMenuRef,
@@ -109,6 +110,9 @@ enum MenuItemRefs : size_t
     ShowGraphRef,
     RebootINAVRef,
     KickStartAutolaunchRef,
+    RecordTraceRef,
+    RecordOsdRef,
+    PlayOsdRecordingRef,
 
     // Settings Menu
     SettingsRef,
@@ -121,6 +125,7 @@ enum MenuItemRefs : size_t
     Rssi5KmRef,
     Rssi10KmRef,
     Rssi50KmRef,
+    RssiTerrainRef,
 
     // Debug Menu (only in debug builds)
 #ifdef DEBUG_BUILD
@@ -193,6 +198,7 @@ Menu::Menu()
                 XPLMCheckMenuItem(this->battery_menu_id, this->battery_3s_4400_id, batEmu == 3 ? xplm_Menu_Checked : xplm_Menu_Unchecked);
                 XPLMCheckMenuItem(this->battery_menu_id, this->battery_3s_5200_id, batEmu == 4 ? xplm_Menu_Checked : xplm_Menu_Unchecked);
                 XPLMCheckMenuItem(this->battery_menu_id, this->battery_3s_10400_id, batEmu == 5 ? xplm_Menu_Checked : xplm_Menu_Unchecked);
+                XPLMCheckMenuItem(this->battery_menu_id, this->battery_aircraft_pack_id, batEmu == 6 ? xplm_Menu_Checked : xplm_Menu_Unchecked);
             }
             else if (eventArg.settingName == SettingsKeys::SETTINGS_SIMULATE_PITOT)
             {
@@ -211,6 +217,11 @@ Menu::Menu()
                 XPLMCheckMenuItem(this->rssi_menu_id, this->rssi_10km_id, rangeKm == 10 ? xplm_Menu_Checked : xplm_Menu_Unchecked);
                 XPLMCheckMenuItem(this->rssi_menu_id, this->rssi_50km_id, rangeKm == 50 ? xplm_Menu_Checked : xplm_Menu_Unchecked);
             }
+            else if (eventArg.settingName == SettingsKeys::SETTINGS_RSSI_TERRAIN)
+            {
+                bool terrain = eventArg.getValueAs<bool>(true);
+                XPLMCheckMenuItem(this->rssi_menu_id, this->rssi_terrain_id, terrain ? xplm_Menu_Checked : xplm_Menu_Unchecked);
+            }
             else if (eventArg.settingName == SettingsKeys::SETTINGS_SIMULATE_RANGEFINDER)
             {
                 int rangefinderSim = eventArg.getValueAs<int>(0);
@@ -263,6 +274,7 @@ Menu::Menu()
             XPLMEnableMenuItem(this->battery_menu_id, this->battery_3s_4400_id, 0);
             XPLMEnableMenuItem(this->battery_menu_id, this->battery_3s_5200_id, 0);
             XPLMEnableMenuItem(this->battery_menu_id, this->battery_3s_10400_id, 0);
+            XPLMEnableMenuItem(this->battery_menu_id, this->battery_aircraft_pack_id, 0);
         }
         else
         {
@@ -280,11 +292,24 @@ Menu::Menu()
             XPLMEnableMenuItem(this->battery_menu_id, this->battery_3s_4400_id, 1);
             XPLMEnableMenuItem(this->battery_menu_id, this->battery_3s_5200_id, 1);
             XPLMEnableMenuItem(this->battery_menu_id, this->battery_3s_10400_id, 1);
+            XPLMEnableMenuItem(this->battery_menu_id, this->battery_aircraft_pack_id, 1);
         }
     };
 
     eventBus->Subscribe<SimulatorConnectedEventArg>("SimulatorConnected", connectedHandler);
     eventBus->Subscribe<SettingsChangedEventArg>("SettingsChanged", settingsChangedHandler);
+    eventBus->Subscribe<IntEventArg>("TraceRecordingChanged", [this](const IntEventArg &event)
+    {
+        XPLMCheckMenuItem(this->menu_id, this->record_trace_id, event.value != 0 ? xplm_Menu_Checked : xplm_Menu_Unchecked);
+    });
+    eventBus->Subscribe<IntEventArg>("OsdRecordingChanged", [this](const IntEventArg &event)
+    {
+        XPLMCheckMenuItem(this->menu_id, this->record_osd_id, event.value != 0 ? xplm_Menu_Checked : xplm_Menu_Unchecked);
+    });
+    eventBus->Subscribe<IntEventArg>("OsdPlaybackChanged", [this](const IntEventArg &event)
+    {
+        XPLMCheckMenuItem(this->menu_id, this->play_osd_recording_id, event.value != 0 ? xplm_Menu_Checked : xplm_Menu_Unchecked);
+    });
 }
 
 Menu::~Menu()
@@ -314,6 +339,7 @@ void Menu::CreateMenu()
     this->rssi_10km_id = XPLMAppendMenuItem(this->rssi_menu_id, "10 km Range", MakeMenuRef(Rssi10KmRef), 0);
     this->rssi_50km_id = XPLMAppendMenuItem(this->rssi_menu_id, "50 km Range", MakeMenuRef(Rssi50KmRef), 0);
     XPLMAppendMenuSeparator(this->rssi_menu_id);
+    this->rssi_terrain_id = XPLMAppendMenuItem(this->rssi_menu_id, "Terrain Line of Sight", MakeMenuRef(RssiTerrainRef), 0);
     this->trigger_failsafe_id = XPLMAppendMenuItem(this->rssi_menu_id, "Toggle Failsafe", MakeMenuRef(RxToggleFailsafeRef), 0);
 
     this->gps_fix_id = XPLMAppendMenuItem(this->hitlHardware_menu_id, "GPS Fix", NULL, 0);
@@ -344,6 +370,7 @@ void Menu::CreateMenu()
     this->battery_3s_4400_id = XPLMAppendMenuItem(this->battery_menu_id, "4400 mAh 3s Lipo", MakeMenuRef(Battery4400LipoRef), 0);
     this->battery_3s_5200_id = XPLMAppendMenuItem(this->battery_menu_id, "5200 mAh 3s Lion", MakeMenuRef(Battery5200LionRef), 0);
     this->battery_3s_10400_id = XPLMAppendMenuItem(this->battery_menu_id, "10400 mAh 3s Lion", MakeMenuRef(Battery10400LionRef), 0);
+    this->battery_aircraft_pack_id = XPLMAppendMenuItem(this->battery_menu_id, "Aircraft battery pack (Settings)", MakeMenuRef(BatteryAircraftPackRef), 0);
 
     this->pitot_id = XPLMAppendMenuItem(this->hitlHardware_menu_id, "Pitot", NULL, 0);
     this->pitot_menu_id = XPLMCreateMenu("Pitot", this->hitlHardware_menu_id, this->pitot_id, StaticMenuHandler, MakeMenuRef(PitotMenuRef));
@@ -372,6 +399,12 @@ void Menu::CreateMenu()
     this->show_graph_id = XPLMAppendMenuItem(this->menu_id, "Show Graph", MakeMenuRef(ShowGraphRef), 0);
     this->reboot_inav_id = XPLMAppendMenuItem(this->menu_id, "Reboot INAV", MakeMenuRef(RebootINAVRef), 0);
     this->kickstart_autolaunch_id = XPLMAppendMenuItem(this->menu_id, "Kickstart Autolaunch", MakeMenuRef(KickStartAutolaunchRef), 0);
+    this->record_trace_id = XPLMAppendMenuItem(this->menu_id, "Record Trace", MakeMenuRef(RecordTraceRef), 0);
+    XPLMCheckMenuItem(this->menu_id, this->record_trace_id, xplm_Menu_Unchecked);
+    this->record_osd_id = XPLMAppendMenuItem(this->menu_id, "Record OSD", MakeMenuRef(RecordOsdRef), 0);
+    XPLMCheckMenuItem(this->menu_id, this->record_osd_id, xplm_Menu_Unchecked);
+    this->play_osd_recording_id = XPLMAppendMenuItem(this->menu_id, "Play last OSD recording", MakeMenuRef(PlayOsdRecordingRef), 0);
+    XPLMCheckMenuItem(this->menu_id, this->play_osd_recording_id, xplm_Menu_Unchecked);
     XPLMEnableMenuItem(this->menu_id, this->reboot_inav_id, 0);
     XPLMAppendMenuSeparator(this->menu_id);
 
@@ -430,6 +463,15 @@ void Menu::MenuHandler(void *in_item_ref, void *in_menu_ref)
         case KickStartAutolaunchRef:
             EventBus->Publish("MenuKickStartAutolaunch");
             break;
+        case RecordTraceRef:
+            EventBus->Publish("MenuRecordTrace");
+            break;
+        case RecordOsdRef:
+            EventBus->Publish("MenuRecordOsd");
+            break;
+        case PlayOsdRecordingRef:
+            EventBus->Publish("MenuPlayOsdRecording");
+            break;
         default:
             break;
         }
@@ -520,6 +562,9 @@ void Menu::MenuHandler(void *in_item_ref, void *in_menu_ref)
         case Battery10400LionRef:
             plugin->Settings()->SetSetting(SettingsSections::SECTION_SIMDATA, SettingsKeys::SETTINGS_BATTERY_EMULATION, 5);
             break;
+        case BatteryAircraftPackRef:
+            plugin->Settings()->SetSetting(SettingsSections::SECTION_SIMDATA, SettingsKeys::SETTINGS_BATTERY_EMULATION, 6);
+            break;
         default:
             break;
         }
@@ -607,6 +652,12 @@ void Menu::MenuHandler(void *in_item_ref, void *in_menu_ref)
         case Rssi50KmRef:
             plugin->Settings()->SetSetting(SettingsSections::SECTION_SIMDATA, SettingsKeys::SETTINGS_RSSI_SIMULATION, 50);
             break;
+        case RssiTerrainRef:
+        {
+            bool terrain = plugin->Settings()->GetSettingAs<bool>(SettingsSections::SECTION_SIMDATA, SettingsKeys::SETTINGS_RSSI_TERRAIN, true);
+            plugin->Settings()->SetSetting(SettingsSections::SECTION_SIMDATA, SettingsKeys::SETTINGS_RSSI_TERRAIN, !terrain);
+            break;
+        }
         default:
             break;
         }
@@ -29,6 +29,9 @@ private:
     int show_graph_id;
     int reboot_inav_id;
     int kickstart_autolaunch_id;
+    int record_trace_id;
+    int record_osd_id;
+    int play_osd_recording_id;
 
     XPLMMenuID hitlHardware_menu_id;
     int hitlHardware_id;
@@ -66,6 +69,7 @@ private:
     int battery_3s_4400_id;
     int battery_3s_5200_id;
     int battery_3s_10400_id;
+    int battery_aircraft_pack_id;
 
     XPLMMenuID mag_menu_id;
     int mag_id;
@@ -100,6 +104,7 @@ private:
     int rssi_5km_id;
     int rssi_10km_id;
     int rssi_50km_id;
+    int rssi_terrain_id;
 
     void CreateMenu();
     void MenuHandler(void *in_item_ref, void *in_menu_ref);
@@ -2,11 +2,13 @@
 #include "platform.h"
 
 #include <math.h>
+#include <bit>
 #include <cstring>
 #include <XPLMDisplay.h>
 
 #include "core/PluginContext.h"
 #include "core/EventBus.h"
+#include "core/Clock.h"
 #include "settings/SettingNames.h"
 
 #include "OSD.h"
@@ -26,11 +28,23 @@ namespace OSDConstants {
     static constexpr int OSD_MARGIN = 30;
 
     typedef enum {
+        DP_SUB_CMD_HEARTBEAT = 0,
+        DP_SUB_CMD_RELEASE = 1,
         DP_SUB_CMD_CLEAR_SCREEN = 2,
         DP_SUB_CMD_WRITE_STRING = 3,
         DP_SUB_CMD_DRAW_SCREEN = 4,
         DP_SUB_CMD_SET_OPTIONS = 5
     } mspDisplayportSubCmd_t;
+
+    // DisplayPort write string attributes
+    // Character bit 8: INAV can address 4 pages, but the cells store a single extension bit (512 characters)
+    static constexpr uint8_t DP_ATTR_PAGE_MASK = 0x01;
+    static constexpr uint8_t DP_ATTR_BLINK = 0x40;
+
+    // Canvas size per DisplayPort resolution (INAV resolutionType_e)
+    static constexpr int DP_RESOLUTIONS = 5;
+    static constexpr int DP_RESOLUTION_COLS[DP_RESOLUTIONS] = {PAL_COLS, HDZERO_COLS, PAL_COLS, DJI_COLS, AVATAR_COLS};
+    static constexpr int DP_RESOLUTION_ROWS[DP_RESOLUTIONS] = {PAL_ROWS, HDZERO_ROWS, PAL_ROWS, DJI_ROWS, AVATAR_ROWS};
 }
 
 OSD::OSD()
@@ -38,7 +52,15 @@ OSD::OSD()
     auto eventBus = Plugin()->GetEventBus();
 
     this->osdData.assign(OSD_MAX_ROWS * OSD_MAX_COLS, 0);
+    this->osdBackData.assign(OSD_MAX_ROWS * OSD_MAX_COLS, 0);
     this->toastData.assign((OSDConstants::TOAST_MAX_ROWS + 2) * (OSDConstants::TOAST_MAX_COLS + 2), 0);
+    this->statusData.assign(OSDConstants::STATUS_MAX_COLS, 0);
+
+    this->layers[OSD_LAYER_FC] = {this->osdData.data(), OSD_MAX_COLS, 0, 0, OSD_MAX_ROWS, OSD_MAX_COLS, true, false};
+    this->layers[OSD_LAYER_TOAST] = {this->toastData.data(), OSDConstants::TOAST_MAX_COLS + 2, 0, OSD_MAX_COLS / 2 - 1 - OSDConstants::TOAST_MAX_COLS / 2,
+                                     OSDConstants::TOAST_MAX_ROWS + 2, OSDConstants::TOAST_MAX_COLS + 2, false, true};
+    // Row depends on the font, set on drawing
+    this->layers[OSD_LAYER_STATUS] = {this->statusData.data(), OSDConstants::STATUS_MAX_COLS, 0, 0, 1, OSDConstants::STATUS_MAX_COLS, false, false};
 
     Plugin()->Fonts()->setFontType(OsdType::WtfOS);
 
@@ -92,14 +114,25 @@ OSD::OSD()
 
     eventBus->Subscribe<MSPMessageEventArg>("MSPMessage", [this](const MSPMessageEventArg &event)
     {
+        if (event.command == MSP_DISPLAYPORT)
+        {
+            this->displayPortActive = true;
+            this->beginMessage();
+            this->updateFromDisplayPort(event.messageBuffer);
+            this->endMessage();
+            return;
+        }
+
         TMSPSimulatorFromINAV simData;
-        if (event.command != MSP_SIMULATOR || event.messageBuffer.size() < MSPConstants::MSP_SIMULATOR_RESPOSE_MIN_LENGTH || event.messageBuffer.size() > sizeof(simData))
+        if (event.command != MSP_SIMULATOR || this->displayPortActive || event.messageBuffer.size() < MSPConstants::MSP_SIMULATOR_RESPOSE_MIN_LENGTH || event.messageBuffer.size() > sizeof(simData))
         {
             return;
         }
 
+        this->beginMessage();
         std::memcpy(&simData, event.messageBuffer.data(), event.messageBuffer.size());
         this->updateFromINAV(simData.osdData);
+        this->endMessage();
     });
 
    updateFont();
@@ -115,6 +148,7 @@ OSD::OSD()
         {
             this->osdData[i] = OSDConstants::makeCharMode(i % 512, 0);
         }
+        this->markAllDirty();
     });
 
     eventBus->Subscribe("MenuDebugClearOSD", [this]()
@@ -132,6 +166,35 @@ OSD::OSD()
         Utils::SetView();
     });
     
+    eventBus->Subscribe("MenuRecordOsd", [this]()
+    {
+        if (this->recorder.isOpen())
+        {
+            this->stopRecording();
+        }
+        else
+        {
+            this->startRecording();
+        }
+    });
+
+    eventBus->Subscribe("MenuPlayOsdRecording", [this]()
+    {
+        if (this->player.isOpen())
+        {
+            this->stopPlayback();
+        }
+        else
+        {
+            this->startPlayback();
+        }
+    });
+
+    eventBus->Subscribe("PluginDisabled", [this]()
+    {
+        this->stopRecording();
+    });
+
     eventBus->Subscribe("FontChanged",[this]()
     {
         this->updateFont();
@@ -158,12 +221,46 @@ OSD::OSD()
             this->makeToast(event.messageLine1, event.messageLine2, event.durationMs);
         });
 
+    eventBus->Subscribe<FlightLoopEventArg>(
+        "ToastLoop",
+        [this](const FlightLoopEventArg &event)
+        {
+            const uint32_t ticks = Utils::GetTicks();
+            if (this->toastEndTime > 0 && ticks > this->toastEndTime)
+            {
+                this->resetToast();
+            }
+
+            const bool noOsdData = this->isConnected && ticks - this->lastFrameTicks > OSDConstants::NO_OSD_DATA_TIMEOUT_MS;
+            this->setStatus(noOsdData ? "NO OSD DATA FROM FC" : "");
+        });
+
+    eventBus->Subscribe<FlightLoopEventArg>(
+        "StatisticsLoop",
+        [this](const FlightLoopEventArg &event)
+        {
+            Plugin()->GetEventBus()->Publish("OSDLatencySummary", OsdLatencySummaryEventArg(this->latency.summarize()));
+
+            const int64_t now = Clock::NowUs();
+            if (now - this->latencyWindowStartUs > OsdLatencyStatisticsConstants::WINDOW_US)
+            {
+                this->latency.reset();
+                this->latencyWindowStartUs = now;
+            }
+        });
+
     eventBus->Subscribe<SimulatorConnectedEventArg>(
         "SimulatorConnected",
         [this](const SimulatorConnectedEventArg &event)
         {
             this->isConnected = event.status == ConnectionStatus::ConnectedHitl || event.status == ConnectionStatus::ConnectedSitl;
-            if (!this->isConnected)
+            this->lastFrameTicks = Utils::GetTicks();
+            this->resetLatency();
+            if (this->isConnected)
+            {
+                this->stopPlayback();
+            }
+            else
             {
                 this->disconnect();
             }
@@ -188,6 +285,12 @@ OSD::OSD()
                 // Force reload of textures with new filtering mode
                 updateFont();
             }
+            else if (event.settingName == SettingsKeys::SETTINGS_OSD_DOUBLE_BUFFER)
+            {
+                this->doubleBuffered = event.getValueAs<bool>(true);
+                // Continue the frame in progress from the current screen
+                this->osdBackData = this->osdData;
+            }
             else if (event.settingName == SettingsKeys::SETTINGS_VIDEOLINK_SIMULATION)
             {
                 this->videoLink = event.getValueAs<TVideoLinkSimulation>(VS_NONE);
@@ -213,28 +316,22 @@ void OSD::drawOSD()
     int windowWidth, windowHeight;
     XPLMGetScreenSize(&windowWidth, &windowHeight);
 
+    this->updatePlayback();
+
+    const int64_t drawStartUs = Clock::NowUs();
     uint32_t ticks = Utils::GetTicks();
     bool blink = (ticks % 266) < 133;
 
-    std::vector<uint16_t> osdDataRef;
-    bool isToastActive = this->toastEndTime > 0;   
-    if (isToastActive)
+    // Changed cells of an incomplete frame: drawn directly, the screen would be torn
+    if (this->frameHasChanges)
     {
-            osdDataRef = this->osdData;
-            const int lineOffset = OSD_MAX_COLS / 2 - 1 - OSDConstants::TOAST_MAX_COLS / 2;
-            for (int i = 0; i < OSDConstants::TOAST_MAX_ROWS + 2; i++)
-            {
-                const int start = i * (OSDConstants::TOAST_MAX_COLS + 2);
-                std::copy(this->toastData.begin() + start, this->toastData.begin() + start + OSDConstants::TOAST_MAX_COLS + 2, osdDataRef.begin() + i * OSD_MAX_COLS + lineOffset);
-            }
-
-        // Clear toast
-        if (ticks > this->toastEndTime)
-        {
-            resetToast();
-        }
+        (this->doubleBuffered ? this->frameTearsPrevented : this->frameTornDraws)++;
     }
 
+    this->layers[OSD_LAYER_TOAST].visible = this->toastEndTime > 0;
+    this->layers[OSD_LAYER_STATUS].row = std::min(rows / 2 + OSDConstants::STATUS_ROW_BELOW_CENTER, rows - 1);
+    this->layers[OSD_LAYER_STATUS].col = (cols - OSDConstants::STATUS_MAX_COLS) / 2;
+
     const float textureAspectRatio = static_cast<float>(this->textureWidth) / static_cast<float>(this->textureHeight);
 
     int cellWidth = windowWidth / this->textureWidth;
@@ -258,7 +355,17 @@ void OSD::drawOSD()
     int xOffset = (windowWidth - cellWidth * cols) / 2;
     int yOffset = (windowHeight - cellHeight * rows) / 2;
 
-    this->osdRenderer->drawOSD(isToastActive ? osdDataRef : this->osdData, rows, cols, cellWidth, cellHeight, xOffset, yOffset, blink);
+    this->osdRenderer->drawOSD(this->layers.data(), OSD_LAYER_COUNT, rows, cols, cellWidth, cellHeight, xOffset, yOffset, blink);
+
+    const int64_t drawEndUs = Clock::NowUs();
+    this->latency.add(OSD_LATENCY_DRAW, drawEndUs - drawStartUs);
+    if (this->pendingCompleteUs != 0)
+    {
+        this->latency.add(OSD_LATENCY_DRAW_WAIT, drawStartUs - this->pendingCompleteUs);
+        this->latency.add(OSD_LATENCY_TOTAL, drawEndUs - this->pendingFirstChangeUs);
+        this->pendingFirstChangeUs = 0;
+        this->pendingCompleteUs = 0;
+    }
 }
 
 void OSD::drawNoise(float amount)
@@ -281,9 +388,9 @@ void OSD::drawNoise(float amount)
     if ((t1 - t) > 40)
     {
         t = t1;
-        dx = -(float)(size - sx) * rand() / RAND_MAX;
-        dy = -(float)(size - sy) * rand() / RAND_MAX;
-        size = size + size * rand() / RAND_MAX;
+        dx = -(size - sx) * this->random.uniform();
+        dy = -(size - sy) * this->random.uniform();
+        size = size + size * this->random.uniform();
     }
 
     this->osdRenderer->drawInterferenceTexture(this->noiseTexture, static_cast<int>(dx), static_cast<int>(dy), static_cast<int>(size), static_cast<int>(size), amount * amount * amount * amount);
@@ -317,16 +424,16 @@ void OSD::drawInterference(float amount)
         }
 
         t = Utils::GetTicks();
-        dx = -(float)(sizeX - sx) * rand() / RAND_MAX;
-        dy = (float)sy * rand() / RAND_MAX;
+        dx = -(sizeX - sx) * this->random.uniform();
+        dy = sy * this->random.uniform();
 
-        sizeX = sizeX + sizeX * rand() / RAND_MAX;
-        sizeY = sizeY * (rand() / RAND_MAX + 0.3f);
+        sizeX = sizeX + sizeX * this->random.uniform();
+        sizeY = sizeY * (this->random.uniform() + 0.3f);
 
-        if (1.0f * rand() / RAND_MAX > (pow(amount, 0.25)))
+        if (this->random.uniform() > (pow(amount, 0.25)))
             dy = 10000;
 
-        delay = 2.0f * rand() / RAND_MAX;
+        delay = 2.0f * this->random.uniform();
     }
 
     this->osdRenderer->drawInterferenceTexture(this->interferenceTexture, static_cast<int>(dx), static_cast<int>(dy), static_cast<int>(sizeX), static_cast<int>(sizeY), amount);
@@ -366,6 +473,18 @@ void OSD::resetToast()
     this->toastEndTime = 0;
 }
 
+void OSD::setStatus(const std::string &text)
+{
+    std::fill(this->statusData.begin(), this->statusData.end(), 0);
+    const std::string line = Utils::ToUpper(text.substr(0, OSDConstants::STATUS_MAX_COLS));
+    const int startCol = (OSDConstants::STATUS_MAX_COLS - static_cast<int>(line.length())) / 2;
+    for (size_t i = 0; i < line.length(); i++)
+    {
+        this->statusData[startCol + i] = OSDConstants::makeCharMode(line[i], 0);
+    }
+    this->layers[OSD_LAYER_STATUS].visible = !line.empty();
+}
+
 void OSD::updateFromINAV(const TMSPSimulatorOSD& message)
 {
     if (message.newFormat.osdRows == 0)
@@ -435,6 +554,9 @@ void OSD::updateFromINAVRowData(int osdRow, int osdCol, const uint8_t (&data)[MS
     bool blink = false;
     int count;
 
+    this->frameUpdates++;
+    std::vector<uint16_t> &target = this->doubleBuffered ? this->osdBackData : this->osdData;
+
     int byteCount = 0;
     while (byteCount < (400 - 3 - 2))
     {
@@ -462,9 +584,10 @@ void OSD::updateFromINAVRowData(int osdRow, int osdCol, const uint8_t (&data)[MS
             count = 1;
         }
 
+        const uint16_t value = OSDConstants::makeCharMode((c | (highBank ? 0x100 : 0)), (blink ? OSDConstants::MAX7456_MODE_BLINK : 0));
         while (count > 0)
         {
-            this->osdData[osdRow * OSD_MAX_COLS + osdCol] = OSDConstants::makeCharMode((c | (highBank ? 0x100 : 0)), (blink ? OSDConstants::MAX7456_MODE_BLINK : 0));
+            this->writeCell(osdRow, osdCol, value, target);
             osdCol++;
             if (osdCol == cols)
             {
@@ -473,7 +596,7 @@ void OSD::updateFromINAVRowData(int osdRow, int osdCol, const uint8_t (&data)[MS
                 if (osdRow == decodeRowsCount)
                 {
                     osdRow = 0;
-                    Plugin()->GetEventBus()->Publish("OSDFrameUpdated");
+                    this->publishFrame();
                 }
             }
             count--;
@@ -481,9 +604,178 @@ void OSD::updateFromINAVRowData(int osdRow, int osdCol, const uint8_t (&data)[MS
     }
 }
 
+void OSD::updateFromDisplayPort(const std::vector<uint8_t> &payload)
+{
+    if (payload.empty())
+    {
+        return;
+    }
+
+    std::vector<uint16_t> &target = this->doubleBuffered ? this->osdBackData : this->osdData;
+
+    switch (payload[0])
+    {
+    case OSDConstants::DP_SUB_CMD_CLEAR_SCREEN:
+        for (int row = 0; row < OSD_MAX_ROWS; row++)
+        {
+            for (int col = 0; col < OSD_MAX_COLS; col++)
+            {
+                this->writeCell(row, col, 0, target);
+            }
+        }
+        break;
+
+    case OSDConstants::DP_SUB_CMD_WRITE_STRING:
+    {
+        // row, col, attributes, characters
+        if (payload.size() < 4 || payload[1] >= OSD_MAX_ROWS)
+        {
+            return;
+        }
+        const int row = payload[1];
+        const uint16_t page = static_cast<uint16_t>(payload[3] & OSDConstants::DP_ATTR_PAGE_MASK) << 8;
+        const uint8_t mode = (payload[3] & OSDConstants::DP_ATTR_BLINK) ? OSDConstants::MAX7456_MODE_BLINK : 0;
+        const int length = std::min(static_cast<int>(payload.size()) - 4, OSD_MAX_COLS - payload[2]);
+        for (int i = 0; i < length; i++)
+        {
+            this->writeCell(row, payload[2] + i, OSDConstants::makeCharMode(payload[4 + i] | page, mode), target);
+        }
+        this->frameUpdates++;
+        break;
+    }
+
+    case OSDConstants::DP_SUB_CMD_DRAW_SCREEN:
+        this->publishFrame();
+        break;
+
+    case OSDConstants::DP_SUB_CMD_SET_OPTIONS:
+        // font, resolution
+        if (payload.size() >= 3 && payload[2] < OSDConstants::DP_RESOLUTIONS)
+        {
+            this->setCanvas(OSDConstants::DP_RESOLUTION_ROWS[payload[2]], OSDConstants::DP_RESOLUTION_COLS[payload[2]]);
+        }
+        break;
+
+    default:
+        // Heartbeat, release
+        break;
+    }
+}
+
+void OSD::setCanvas(int rows, int cols)
+{
+    if (rows <= 0 || rows > OSD_MAX_ROWS || cols <= 0 || cols > OSD_MAX_COLS)
+    {
+        return; // invalid data
+    }
+    Plugin()->Fonts()->setFontTypeByOsdSize(rows, cols);
+}
+
+void OSD::writeCell(int row, int col, uint16_t value, std::vector<uint16_t> &target)
+{
+    // Compared with the front buffer, the last complete frame
+    const int index = row * OSD_MAX_COLS + col;
+    const bool changed = this->osdData[index] != value;
+    this->dirtyRows[row] |= static_cast<uint64_t>(changed) << col;
+    this->frameHasChanges |= changed;
+    target[index] = value;
+    this->frameWrittenCells++;
+    if (changed && this->frameFirstChangeUs == 0)
+    {
+        this->frameFirstChangeUs = this->messageReceivedUs;
+    }
+}
+
+void OSD::beginMessage()
+{
+    // MSP publishes the message right after its checksum, so this is the time it arrived
+    this->messageReceivedUs = Clock::NowUs();
+    if (this->lastMessageUs != 0)
+    {
+        this->latency.add(OSD_LATENCY_MESSAGE_INTERVAL, this->messageReceivedUs - this->lastMessageUs);
+    }
+    this->lastMessageUs = this->messageReceivedUs;
+}
+
+void OSD::endMessage()
+{
+    this->latency.add(OSD_LATENCY_DECODE, Clock::NowUs() - this->messageReceivedUs);
+}
+
+void OSD::resetLatency()
+{
+    this->latency.reset();
+    this->latencyWindowStartUs = Clock::NowUs();
+    this->lastMessageUs = 0;
+    this->lastFrameUs = 0;
+    this->frameFirstChangeUs = 0;
+    this->pendingFirstChangeUs = 0;
+    this->pendingCompleteUs = 0;
+}
+
 void OSD::clear()
 {
     std::fill(this->osdData.begin(), this->osdData.end(), 0);
+    std::fill(this->osdBackData.begin(), this->osdBackData.end(), 0);
+    this->markAllDirty();
+}
+
+void OSD::markAllDirty()
+{
+    this->dirtyRows.fill(OSD_MAX_COLS == 64 ? ~0ULL : (1ULL << OSD_MAX_COLS) - 1);
+}
+
+void OSD::publishFrame()
+{
+    const int64_t now = Clock::NowUs();
+    if (this->lastFrameUs != 0)
+    {
+        this->latency.add(OSD_LATENCY_FRAME_INTERVAL, now - this->lastFrameUs);
+    }
+    this->lastFrameUs = now;
+    if (this->frameFirstChangeUs != 0)
+    {
+        this->latency.add(OSD_LATENCY_ASSEMBLY, now - this->frameFirstChangeUs);
+        // Frames completed before the next draw are drawn together, the oldest change counts
+        if (this->pendingCompleteUs == 0)
+        {
+            this->pendingFirstChangeUs = this->frameFirstChangeUs;
+        }
+        this->pendingCompleteUs = now;
+        this->frameFirstChangeUs = 0;
+    }
+
+    if (this->doubleBuffered)
+    {
+        // The back buffer keeps the new frame, so cells INAV doesn't send in the next frame stay current
+        this->osdData.swap(this->osdBackData);
+        this->osdBackData = this->osdData;
+        this->layers[OSD_LAYER_FC].data = this->osdData.data();
+    }
+
+    int changedCells = 0;
+    for (uint64_t row : this->dirtyRows)
+    {
+        changedCells += std::popcount(row);
+    }
+
+    if (this->recorder.isOpen())
+    {
+        auto font = Plugin()->Fonts()->GetCurrentFont();
+        this->recorder.addFrame(now, static_cast<uint8_t>(Plugin()->Fonts()->getCurrentFontType()), font != nullptr ? font->getRows() : OSD_MAX_ROWS,
+                                font != nullptr ? font->getCols() : OSD_MAX_COLS, this->osdData.data(), this->dirtyRows.data());
+    }
+
+    Plugin()->GetEventBus()->Publish("OSDFrameUpdated", OsdFrameUpdatedEventArg(this->dirtyRows.data(), OSD_MAX_ROWS, changedCells, this->frameWrittenCells, this->frameUpdates,
+                                                                              this->frameTornDraws, this->frameTearsPrevented));
+
+    this->dirtyRows.fill(0);
+    this->frameWrittenCells = 0;
+    this->frameUpdates = 0;
+    this->frameTornDraws = 0;
+    this->frameTearsPrevented = 0;
+    this->frameHasChanges = false;
+    this->lastFrameTicks = Utils::GetTicks();
 }
 
 void OSD::updateFont()
@@ -510,6 +802,8 @@ void OSD::updateFont()
 
     this->textureWidth = font != nullptr ? font->getCharWidth() : 0;
     this->textureHeight = font != nullptr ? font->getCharHeight() : 0;
+    // New glyphs for every cell
+    this->markAllDirty();
 }
 
 
@@ -582,7 +876,106 @@ void OSD::makeToast(std::string line1, std::string line2, int durationMs)
 
 void OSD::disconnect()
 {
+    this->displayPortActive = false;
     Plugin()->Fonts()->setFontType(OsdType::WtfOS);
     this->clear();
     this->makeToast("DISCONNECTED", "", 5000);
 }
+
+void OSD::startRecording()
+{
+    fs::path directory = Utils::GetPluginDirectory() / "osd_recordings";
+    std::error_code error;
+    fs::create_directories(directory, error);
+
+    const auto now = std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now());
+    const fs::path fileName = directory / std::format("osd_{:%Y%m%d_%H%M%S}{}", now, OsdRecordingConstants::FILE_EXTENSION);
+    if (!this->recorder.open(fileName.string(), OSD_MAX_ROWS, OSD_MAX_COLS))
+    {
+        Utils::LOG("Unable to create OSD recording {}", fileName.string());
+        this->makeToast("OSD recording", "Unable to create file", 3000);
+        return;
+    }
+
+    Utils::LOG("OSD recording started: {}", fileName.string());
+    Plugin()->GetEventBus()->Publish<IntEventArg>("OsdRecordingChanged", IntEventArg(1));
+}
+
+void OSD::stopRecording()
+{
+    if (!this->recorder.isOpen())
+    {
+        return;
+    }
+
+    const int frames = this->recorder.getFrameCount();
+    const size_t bytes = this->recorder.getBytesWritten();
+    this->recorder.close();
+
+    Utils::LOG("OSD recording stopped, {} frames, {} bytes", frames, bytes);
+    this->makeToast("OSD recording saved", std::format("{} frames", frames), 3000);
+    Plugin()->GetEventBus()->Publish<IntEventArg>("OsdRecordingChanged", IntEventArg(0));
+}
+
+void OSD::startPlayback()
+{
+    if (this->isConnected || this->recorder.isOpen())
+    {
+        this->makeToast("OSD playback", this->isConnected ? "Disconnect first" : "Stop recording first", 3000);
+        return;
+    }
+
+    // Newest recording, the file names sort by date
+    fs::path fileName;
+    std::error_code error;
+    for (const fs::directory_entry &entry : fs::directory_iterator(Utils::GetPluginDirectory() / "osd_recordings", error))
+    {
+        if (entry.path().extension() == OsdRecordingConstants::FILE_EXTENSION && entry.path().filename() > fileName.filename())
+        {
+            fileName = entry.path();
+        }
+    }
+
+    if (fileName.empty() || !this->player.open(fileName.string()) ||
+        this->player.getGridRows() != OSD_MAX_ROWS || this->player.getGridCols() != OSD_MAX_COLS)
+    {
+        this->player.close();
+        this->makeToast("OSD playback", "No recording", 3000);
+        return;
+    }
+
+    Utils::LOG("OSD playback: {}", fileName.string());
+    this->playbackStartUs = Clock::NowUs();
+    this->layers[OSD_LAYER_FC].data = this->player.getGrid().data();
+    Plugin()->GetEventBus()->Publish<IntEventArg>("OsdPlaybackChanged", IntEventArg(1));
+}
+
+void OSD::stopPlayback()
+{
+    if (!this->player.isOpen())
+    {
+        return;
+    }
+
+    this->layers[OSD_LAYER_FC].data = this->osdData.data();
+    this->player.close();
+    Plugin()->GetEventBus()->Publish<IntEventArg>("OsdPlaybackChanged", IntEventArg(0));
+}
+
+void OSD::updatePlayback()
+{
+    if (!this->player.isOpen())
+    {
+        return;
+    }
+
+    const int64_t elapsedUs = Clock::NowUs() - this->playbackStartUs;
+    if (elapsedUs > this->player.getDurationUs() + OSDConstants::PLAYBACK_END_HOLD_US)
+    {
+        this->stopPlayback();
+        return;
+    }
+
+    this->player.advanceTo(elapsedUs);
+    Plugin()->Fonts()->setFontType(static_cast<OsdType>(this->player.getOsdType()));
+}
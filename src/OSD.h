@@ -2,17 +2,28 @@
 
 #include "MSP.h"
 
+#include <array>
+#include <cstdint>
 #include <vector>
 #include <memory>
 
 #include "fonts/FontBase.h"
 #include "fonts/Fonts.h"
 #include "renderer/OsdRenderer.h"
+#include "core/RandomStream.h"
+#include "OsdLatencyStatistics.h"
+#include "OsdRecording.h"
 
 // Toast buffer constants
 namespace OSDConstants {
     static constexpr int TOAST_MAX_COLS = 25;
     static constexpr int TOAST_MAX_ROWS = 2;
+    static constexpr int STATUS_MAX_COLS = 30;
+    // Status line below the center of the OSD
+    static constexpr int STATUS_ROW_BELOW_CENTER = 2;
+    static constexpr uint32_t NO_OSD_DATA_TIMEOUT_MS = 2000;
+    // The last frame of a played back recording stays this long
+    static constexpr int64_t PLAYBACK_END_HOLD_US = 2000000;
     
     // Mode constants (bit flags)
     static constexpr uint16_t MAX7456_MODE_BLINK = (1 << 4);
@@ -67,6 +78,29 @@ typedef enum
 // OSD dimensions
 static constexpr int OSD_MAX_COLS = DJI_COLS;
 static constexpr int OSD_MAX_ROWS = DJI_ROWS;
+// Dirty cells are tracked as one 64 bit column mask per row
+static_assert(OSD_MAX_COLS <= 64, "OSD dirty bitmap needs a bit per column");
+
+typedef enum
+{
+    OSD_LAYER_FC = 0,   // INAV's OSD
+    OSD_LAYER_TOAST,    // Plugin messages, hide the FC layer in their box
+    OSD_LAYER_STATUS,   // Plugin status line
+    OSD_LAYER_COUNT
+} TOsdLayerId;
+
+// Character grid placed on the OSD, the renderer resolves the layers per cell (top layer first)
+struct TOsdLayer
+{
+    const uint16_t *data = nullptr;
+    int stride = 0;     // cells per row in data
+    int row = 0;        // position on the OSD
+    int col = 0;
+    int rows = 0;
+    int cols = 0;
+    bool visible = false;
+    bool opaque = false; // blank cells hide the layers below
+};
 
 typedef enum
 {
@@ -90,6 +124,18 @@ private:
 
     void updateFromINAV(const TMSPSimulatorOSD& message);
     void updateFromINAVRowData(int osdRow, int osdCol, const uint8_t (&data)[MSPConstants::OSD_BUFFER_SIZE], int decodeRowsCount);
+    void updateFromDisplayPort(const std::vector<uint8_t> &payload);
+    void setCanvas(int rows, int cols);
+    void writeCell(int row, int col, uint16_t value, std::vector<uint16_t> &target);
+    void beginMessage();
+    void endMessage();
+    void resetLatency();
+
+    void startRecording();
+    void stopRecording();
+    void startPlayback();
+    void stopPlayback();
+    void updatePlayback();
 
     void makeToast(std::string line1, std::string line2, int durationMs = 3000);
 
@@ -117,16 +163,49 @@ private:
     std::unique_ptr<OsdRenderer> osdRenderer = nullptr;
     int noiseTexture = -1;
     int interferenceTexture = -1;
+    RandomStream random;
 
+    // Front buffer, drawn. Row data is decoded into the back buffer, which becomes the
+    // front buffer once the frame is complete.
     std::vector<uint16_t> osdData;
+    std::vector<uint16_t> osdBackData;
+    bool doubleBuffered = true;
+    // INAV sends its OSD as MSP DisplayPort messages, the OSD part of MSP_SIMULATOR is ignored
+    bool displayPortActive = false;
+    // Cells changed since the last OSDFrameUpdated
+    std::array<uint64_t, OSD_MAX_ROWS> dirtyRows = {};
+    int frameWrittenCells = 0;
+    int frameUpdates = 0;
+    bool frameHasChanges = false; // INAV has sent changed cells since the last complete frame
+    int frameTornDraws = 0;
+    int frameTearsPrevented = 0;
+    // Refresh latency, Clock::NowUs(), 0: none
+    OsdLatencyStatistics latency;
+    int64_t latencyWindowStartUs = 0;
+    int64_t messageReceivedUs = 0;   // MSP message being decoded
+    int64_t lastMessageUs = 0;
+    int64_t lastFrameUs = 0;
+    int64_t frameFirstChangeUs = 0;   // frame being decoded
+    int64_t pendingFirstChangeUs = 0; // complete frame, not drawn yet
+    int64_t pendingCompleteUs = 0;
+    // DVR, plays back while not connected to INAV
+    OsdRecordingWriter recorder;
+    OsdRecordingReader player;
+    int64_t playbackStartUs = 0;
     std::vector<uint16_t> toastData;
     uint32_t toastEndTime = 0;
+    std::vector<uint16_t> statusData;
+    uint32_t lastFrameTicks = 0;
+    // Reference the data above, nothing is copied per frame
+    std::array<TOsdLayer, OSD_LAYER_COUNT> layers;
 
     std::string activeAnalogFont = "";
     std::string activeDigitalFont = "";
     std::vector<FontBase *> fonts;
 
     void clear();
+    void markAllDirty();
+    void publishFrame();
 
     void updateFont();
     void drawOSD();
@@ -134,6 +213,7 @@ private:
     void drawInterference(float amount);
 
     void resetToast();
+    void setStatus(const std::string &text);
 
     float getNoiseAmount();
 };
@@ -0,0 +1,99 @@
+#include "OsdLatencyStatistics.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+using namespace OsdLatencyStatisticsConstants;
+
+OsdLatencyStatistics::OsdLatencyStatistics()
+{
+    this->reset();
+}
+
+void OsdLatencyStatistics::reset()
+{
+    for (TStage &stage : this->stages)
+    {
+        stage.samples = 0;
+        stage.sumUs = 0.0;
+        stage.maxUs = 0;
+        stage.histogram.fill(0);
+    }
+}
+
+int OsdLatencyStatistics::binIndex(int64_t us)
+{
+    if (us < BINS_PER_OCTAVE)
+    {
+        return static_cast<int>(std::max<int64_t>(us, 0));
+    }
+
+    // Octave from the highest bit, the two bits below it select the bin within the octave
+    const int octave = std::bit_width(static_cast<uint64_t>(us)) - 1;
+    const int sub = static_cast<int>((us >> (octave - 2)) & (BINS_PER_OCTAVE - 1));
+    return std::min((octave - 1) * BINS_PER_OCTAVE + sub, HISTOGRAM_BINS - 1);
+}
+
+double OsdLatencyStatistics::binCenterUs(int bin)
+{
+    if (bin < BINS_PER_OCTAVE)
+    {
+        return bin;
+    }
+
+    const int octave = bin / BINS_PER_OCTAVE + 1;
+    const int sub = bin % BINS_PER_OCTAVE;
+    const double width = std::ldexp(1.0, octave - 2);
+    return (BINS_PER_OCTAVE + sub) * width + width / 2.0;
+}
+
+void OsdLatencyStatistics::add(TOsdLatencyStage stage, int64_t us)
+{
+    TStage &s = this->stages[stage];
+    us = std::max<int64_t>(us, 0);
+    s.samples++;
+    s.sumUs += static_cast<double>(us);
+    s.maxUs = std::max(s.maxUs, us);
+    s.histogram[OsdLatencyStatistics::binIndex(us)]++;
+}
+
+float OsdLatencyStatistics::percentileMs(const TStage &stage, float fraction) const
+{
+    const uint64_t rank = static_cast<uint64_t>(ceil(fraction * stage.samples));
+    uint64_t count = 0;
+    for (int bin = 0; bin < HISTOGRAM_BINS; bin++)
+    {
+        count += stage.histogram[bin];
+        if (count >= rank)
+        {
+            // Never above the exact maximum
+            return static_cast<float>(std::min(OsdLatencyStatistics::binCenterUs(bin), static_cast<double>(stage.maxUs)) / 1000.0);
+        }
+    }
+    return stage.maxUs / 1000.0f;
+}
+
+TOsdLatencySummary OsdLatencyStatistics::summarize() const
+{
+    TOsdLatencySummary summary = {};
+    for (int i = 0; i < OSD_LATENCY_STAGES; i++)
+    {
+        const TStage &stage = this->stages[i];
+        summary.samples[i] = stage.samples;
+        if (stage.samples == 0)
+        {
+            continue;
+        }
+
+        summary.meanMs[i] = static_cast<float>(stage.sumUs / stage.samples / 1000.0);
+        summary.maxMs[i] = stage.maxUs / 1000.0f;
+        summary.p50Ms[i] = this->percentileMs(stage, 0.50f);
+        summary.p95Ms[i] = this->percentileMs(stage, 0.95f);
+        summary.p99Ms[i] = this->percentileMs(stage, 0.99f);
+    }
+
+    const float frameIntervalMs = summary.meanMs[OSD_LATENCY_FRAME_INTERVAL];
+    summary.frameRateHz = frameIntervalMs > 0.0f ? 1000.0f / frameIntervalMs : 0.0f;
+    return summary;
+}
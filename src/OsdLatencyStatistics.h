@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace OsdLatencyStatisticsConstants
+{
+    // Log scale bins: 4 per octave (max. 19 % wide), 0 µs to ~8 s
+    static constexpr int BINS_PER_OCTAVE = 4;
+    static constexpr int OCTAVES = 23;
+    static constexpr int HISTOGRAM_BINS = BINS_PER_OCTAVE * OCTAVES;
+    // Statistics are published every second and restarted after this window
+    static constexpr int64_t WINDOW_US = 10000000;
+}
+
+typedef enum
+{
+    OSD_LATENCY_MESSAGE_INTERVAL = 0, // Between MSP messages carrying OSD data: link and chunking rate
+    OSD_LATENCY_DECODE,               // Decoding one MSP message into the grid
+    OSD_LATENCY_ASSEMBLY,             // First changed cell received until the frame is complete
+    OSD_LATENCY_DRAW_WAIT,            // Frame complete until the next draw
+    OSD_LATENCY_DRAW,                 // Draw call, CPU side including the GL submission
+    OSD_LATENCY_TOTAL,                // First changed cell received until drawn
+    OSD_LATENCY_FRAME_INTERVAL,       // Between complete frames, the OSD update rate
+    OSD_LATENCY_STAGES
+} TOsdLatencyStage;
+
+// Per stage, in milliseconds
+struct TOsdLatencySummary
+{
+    std::array<int, OSD_LATENCY_STAGES> samples;
+    std::array<float, OSD_LATENCY_STAGES> meanMs;
+    std::array<float, OSD_LATENCY_STAGES> maxMs;
+    std::array<float, OSD_LATENCY_STAGES> p50Ms;
+    std::array<float, OSD_LATENCY_STAGES> p95Ms;
+    std::array<float, OSD_LATENCY_STAGES> p99Ms;
+    float frameRateHz; // complete OSD frames per second, from the mean frame interval
+};
+
+/**
+ * @brief Streaming histograms of the OSD refresh pipeline stages.
+ *
+ * add() is O(1): sum, maximum and a log scale histogram per stage, so microsecond decode times
+ * and second long link stalls fit in the same small table. Percentiles are the bin centers.
+ */
+class OsdLatencyStatistics
+{
+public:
+    OsdLatencyStatistics();
+
+    void reset();
+    void add(TOsdLatencyStage stage, int64_t us);
+
+    TOsdLatencySummary summarize() const;
+
+    static int binIndex(int64_t us);
+    static double binCenterUs(int bin);
+
+private:
+    struct TStage
+    {
+        int samples;
+        double sumUs;
+        int64_t maxUs;
+        std::array<uint32_t, OsdLatencyStatisticsConstants::HISTOGRAM_BINS> histogram;
+    };
+
+    std::array<TStage, OSD_LATENCY_STAGES> stages;
+
+    float percentileMs(const TStage &stage, float fraction) const;
+};
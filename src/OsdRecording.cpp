@@ -0,0 +1,530 @@
+#include "OsdRecording.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+static_assert(std::endian::native == std::endian::little, "OSD recordings are written in host byte order");
+
+using namespace OsdRecordingConstants;
+
+namespace
+{
+    void putVarint(std::vector<uint8_t> &buffer, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            buffer.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        buffer.push_back(static_cast<uint8_t>(value));
+    }
+
+    void putCell(std::vector<uint8_t> &buffer, uint16_t cell)
+    {
+        buffer.push_back(static_cast<uint8_t>(cell));
+        buffer.push_back(static_cast<uint8_t>(cell >> 8));
+    }
+
+    bool getVarint(const std::vector<uint8_t> &data, size_t &position, size_t end, uint64_t &value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64 && position < end; shift += 7)
+        {
+            const uint8_t byte = data[position++];
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool getCell(const std::vector<uint8_t> &data, size_t &position, size_t end, uint16_t &cell)
+    {
+        if (position + 2 > end)
+        {
+            return false;
+        }
+        cell = static_cast<uint16_t>(data[position] | (data[position + 1] << 8));
+        position += 2;
+        return true;
+    }
+}
+
+OsdRecordingWriter::~OsdRecordingWriter()
+{
+    this->close();
+}
+
+bool OsdRecordingWriter::open(const std::string &fileName, int gridRows, int gridCols)
+{
+    this->close();
+
+    this->file = fopen(fileName.c_str(), "wb");
+    if (this->file == nullptr)
+    {
+        return false;
+    }
+
+    const uint16_t version = FILE_VERSION;
+    const uint8_t rows = static_cast<uint8_t>(gridRows);
+    const uint8_t cols = static_cast<uint8_t>(gridCols);
+    fwrite(FILE_MAGIC, sizeof(FILE_MAGIC), 1, this->file);
+    fwrite(&version, sizeof(version), 1, this->file);
+    fwrite(&rows, sizeof(rows), 1, this->file);
+    fwrite(&cols, sizeof(cols), 1, this->file);
+    this->offset = sizeof(FILE_MAGIC) + sizeof(version) + sizeof(rows) + sizeof(cols);
+
+    this->gridRows = gridRows;
+    this->gridCols = gridCols;
+    this->grid.assign(gridRows * gridCols, 0);
+    this->index.clear();
+    this->startUs = 0;
+    this->lastUs = 0;
+    this->lastKeyframeUs = 0;
+    this->osdType = 0;
+    this->visibleRows = 0;
+    this->visibleCols = 0;
+    this->frameCount = 0;
+    return true;
+}
+
+void OsdRecordingWriter::close()
+{
+    if (this->file == nullptr)
+    {
+        return;
+    }
+
+    const uint64_t indexOffset = this->offset;
+    this->buffer.clear();
+    this->buffer.push_back(RECORD_INDEX);
+    putVarint(this->buffer, this->index.size());
+    for (const TOsdKeyframeIndexEntry &entry : this->index)
+    {
+        putVarint(this->buffer, entry.timeUs);
+        putVarint(this->buffer, entry.offset);
+    }
+    putVarint(this->buffer, this->lastUs - this->startUs);
+    this->flushBuffer();
+    fwrite(&indexOffset, sizeof(indexOffset), 1, this->file);
+    fwrite(INDEX_MAGIC, sizeof(INDEX_MAGIC), 1, this->file);
+
+    fclose(this->file);
+    this->file = nullptr;
+}
+
+void OsdRecordingWriter::addFrame(int64_t timeUs, uint8_t osdType, int visibleRows, int visibleCols, const uint16_t *cells, const uint64_t *dirtyRows)
+{
+    if (this->file == nullptr)
+    {
+        return;
+    }
+
+    const bool layoutChanged = osdType != this->osdType || visibleRows != this->visibleRows || visibleCols != this->visibleCols;
+    this->osdType = osdType;
+    this->visibleRows = visibleRows;
+    this->visibleCols = visibleCols;
+
+    // The dirty bits only cover the changes since the last frame: cells drawn before the recording
+    // started, or while the layout changed, are only found by comparing every cell
+    if (this->frameCount == 0 || layoutChanged)
+    {
+        dirtyRows = nullptr;
+    }
+
+    // Changed cells, updates the recorded grid
+    this->changedCells.clear();
+    for (int row = 0; row < this->gridRows; row++)
+    {
+        uint64_t dirty = dirtyRows != nullptr ? dirtyRows[row] : ~0ULL;
+        while (dirty != 0)
+        {
+            const int col = std::countr_zero(dirty);
+            dirty &= dirty - 1;
+            if (col >= this->gridCols)
+            {
+                break;
+            }
+
+            const uint32_t cell = row * this->gridCols + col;
+            if (this->grid[cell] != cells[cell])
+            {
+                this->grid[cell] = cells[cell];
+                this->changedCells.push_back(cell);
+            }
+        }
+    }
+
+    if (this->frameCount == 0)
+    {
+        this->startUs = timeUs;
+        this->writeKeyframe(timeUs);
+    }
+    else if (layoutChanged || timeUs - this->lastKeyframeUs >= KEYFRAME_INTERVAL_US ||
+             static_cast<int>(this->changedCells.size()) > this->gridRows * this->gridCols / KEYFRAME_CHANGED_CELLS_DIVISOR)
+    {
+        this->writeKeyframe(timeUs);
+    }
+    else if (!this->changedCells.empty())
+    {
+        this->writeDelta(timeUs);
+    }
+    this->frameCount++;
+}
+
+void OsdRecordingWriter::writeKeyframe(int64_t timeUs)
+{
+    const int64_t relativeUs = timeUs - this->startUs;
+    this->index.push_back({relativeUs, this->offset});
+
+    std::vector<uint8_t> payload;
+    putVarint(payload, relativeUs);
+    payload.push_back(this->osdType);
+    putVarint(payload, this->visibleRows);
+    putVarint(payload, this->visibleCols);
+    const size_t count = this->grid.size();
+    for (size_t i = 0; i < count;)
+    {
+        size_t run = 1;
+        while (i + run < count && this->grid[i + run] == this->grid[i])
+        {
+            run++;
+        }
+        putVarint(payload, run);
+        putCell(payload, this->grid[i]);
+        i += run;
+    }
+
+    this->buffer.clear();
+    this->buffer.push_back(RECORD_KEYFRAME);
+    putVarint(this->buffer, payload.size());
+    this->buffer.insert(this->buffer.end(), payload.begin(), payload.end());
+    this->flushBuffer();
+
+    this->lastUs = timeUs;
+    this->lastKeyframeUs = timeUs;
+}
+
+void OsdRecordingWriter::writeDelta(int64_t timeUs)
+{
+    std::vector<uint8_t> payload;
+    putVarint(payload, timeUs - this->lastUs);
+    putVarint(payload, this->changedCells.size());
+    uint32_t next = 0;
+    for (uint32_t cell : this->changedCells)
+    {
+        putVarint(payload, cell - next);
+        putCell(payload, this->grid[cell]);
+        next = cell + 1;
+    }
+
+    this->buffer.clear();
+    this->buffer.push_back(RECORD_DELTA);
+    putVarint(this->buffer, payload.size());
+    this->buffer.insert(this->buffer.end(), payload.begin(), payload.end());
+    this->flushBuffer();
+
+    this->lastUs = timeUs;
+}
+
+void OsdRecordingWriter::flushBuffer()
+{
+    fwrite(this->buffer.data(), 1, this->buffer.size(), this->file);
+    this->offset += this->buffer.size();
+}
+
+bool OsdRecordingReader::open(const std::string &fileName)
+{
+    this->close();
+
+    FILE *file = fopen(fileName.c_str(), "rb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    fseek(file, 0, SEEK_END);
+    const long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (size > 0)
+    {
+        this->data.resize(size);
+        if (fread(this->data.data(), 1, size, file) != static_cast<size_t>(size))
+        {
+            this->data.clear();
+        }
+    }
+    fclose(file);
+
+    const size_t headerSize = sizeof(FILE_MAGIC) + sizeof(uint16_t) + 2;
+    uint16_t version = 0;
+    if (this->data.size() < headerSize || memcmp(this->data.data(), FILE_MAGIC, sizeof(FILE_MAGIC)) != 0)
+    {
+        this->close();
+        return false;
+    }
+    memcpy(&version, this->data.data() + sizeof(FILE_MAGIC), sizeof(version));
+    if (version != FILE_VERSION)
+    {
+        this->close();
+        return false;
+    }
+
+    this->gridRows = this->data[sizeof(FILE_MAGIC) + sizeof(version)];
+    this->gridCols = this->data[sizeof(FILE_MAGIC) + sizeof(version) + 1];
+    this->recordsOffset = headerSize;
+    this->recordsEnd = this->data.size();
+
+    if (!this->readIndex())
+    {
+        this->buildIndex();
+    }
+
+    if (this->index.empty())
+    {
+        this->close();
+        return false;
+    }
+    return this->seek(0);
+}
+
+void OsdRecordingReader::close()
+{
+    this->data.clear();
+    this->data.shrink_to_fit();
+    this->index.clear();
+    this->grid.clear();
+    this->durationUs = 0;
+}
+
+bool OsdRecordingReader::readIndex()
+{
+    const size_t footerSize = sizeof(uint64_t) + sizeof(INDEX_MAGIC);
+    if (this->data.size() < this->recordsOffset + footerSize ||
+        memcmp(this->data.data() + this->data.size() - sizeof(INDEX_MAGIC), INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0)
+    {
+        return false;
+    }
+
+    uint64_t indexOffset;
+    memcpy(&indexOffset, this->data.data() + this->data.size() - footerSize, sizeof(indexOffset));
+    const size_t end = this->data.size() - footerSize;
+    if (indexOffset < this->recordsOffset || indexOffset >= end || this->data[indexOffset] != RECORD_INDEX)
+    {
+        return false;
+    }
+
+    size_t position = indexOffset + 1;
+    uint64_t count;
+    if (!getVarint(this->data, position, end, count))
+    {
+        return false;
+    }
+    for (uint64_t i = 0; i < count; i++)
+    {
+        uint64_t timeUs;
+        uint64_t offset;
+        if (!getVarint(this->data, position, end, timeUs) || !getVarint(this->data, position, end, offset) || offset >= indexOffset)
+        {
+            this->index.clear();
+            return false;
+        }
+        this->index.push_back({static_cast<int64_t>(timeUs), static_cast<size_t>(offset)});
+    }
+
+    uint64_t duration;
+    if (!getVarint(this->data, position, end, duration))
+    {
+        this->index.clear();
+        return false;
+    }
+    this->durationUs = static_cast<int64_t>(duration);
+    this->recordsEnd = indexOffset;
+    return true;
+}
+
+void OsdRecordingReader::buildIndex()
+{
+    // Stops at the first incomplete record, the end of a recording that wasn't closed
+    size_t position = this->recordsOffset;
+    int64_t time = 0;
+    while (position < this->recordsEnd)
+    {
+        const size_t recordOffset = position;
+        const uint8_t type = this->data[position];
+        if (!this->readRecord(position, false, time))
+        {
+            break;
+        }
+        if (type == RECORD_KEYFRAME)
+        {
+            this->index.push_back({time, recordOffset});
+        }
+        this->durationUs = time;
+    }
+    this->recordsEnd = position;
+}
+
+bool OsdRecordingReader::readRecord(size_t &recordOffset, bool apply, int64_t &recordTimeUs)
+{
+    size_t position = recordOffset;
+    if (position >= this->recordsEnd)
+    {
+        return false;
+    }
+
+    const uint8_t type = this->data[position++];
+    uint64_t length;
+    if (!getVarint(this->data, position, this->recordsEnd, length) || length > this->recordsEnd - position)
+    {
+        return false;
+    }
+    const size_t end = position + length;
+
+    uint64_t time;
+    if ((type != RECORD_KEYFRAME && type != RECORD_DELTA) || !getVarint(this->data, position, end, time))
+    {
+        return false;
+    }
+    const int64_t newTimeUs = type == RECORD_KEYFRAME ? static_cast<int64_t>(time) : recordTimeUs + static_cast<int64_t>(time);
+
+    if (apply)
+    {
+        const size_t cells = this->grid.size();
+        if (type == RECORD_KEYFRAME)
+        {
+            uint64_t rows;
+            uint64_t cols;
+            if (position >= end)
+            {
+                return false;
+            }
+            const uint8_t osdType = this->data[position++];
+            if (!getVarint(this->data, position, end, rows) || !getVarint(this->data, position, end, cols))
+            {
+                return false;
+            }
+            this->osdType = osdType;
+            this->visibleRows = static_cast<int>(rows);
+            this->visibleCols = static_cast<int>(cols);
+
+            size_t cell = 0;
+            while (cell < cells && position < end)
+            {
+                uint64_t run;
+                uint16_t value;
+                if (!getVarint(this->data, position, end, run) || !getCell(this->data, position, end, value))
+                {
+                    return false;
+                }
+                run = std::min<uint64_t>(run, cells - cell);
+                std::fill_n(this->grid.begin() + cell, run, value);
+                cell += run;
+            }
+        }
+        else
+        {
+            uint64_t count;
+            if (!getVarint(this->data, position, end, count))
+            {
+                return false;
+            }
+            uint64_t cell = 0;
+            for (uint64_t i = 0; i < count; i++)
+            {
+                uint64_t skip;
+                uint16_t value;
+                if (!getVarint(this->data, position, end, skip) || !getCell(this->data, position, end, value))
+                {
+                    return false;
+                }
+                cell += skip;
+                if (cell >= cells)
+                {
+                    return false;
+                }
+                this->grid[cell++] = value;
+            }
+        }
+    }
+
+    recordTimeUs = newTimeUs;
+    recordOffset = end;
+    return true;
+}
+
+bool OsdRecordingReader::peekTime(size_t recordOffset, int64_t &recordTimeUs) const
+{
+    if (recordOffset >= this->recordsEnd)
+    {
+        return false;
+    }
+
+    const uint8_t type = this->data[recordOffset];
+    size_t position = recordOffset + 1;
+    uint64_t length;
+    uint64_t time;
+    if (!getVarint(this->data, position, this->recordsEnd, length) || !getVarint(this->data, position, this->recordsEnd, time))
+    {
+        return false;
+    }
+    recordTimeUs = type == RECORD_KEYFRAME ? static_cast<int64_t>(time) : this->timeUs + static_cast<int64_t>(time);
+    return true;
+}
+
+bool OsdRecordingReader::seek(int64_t timeUs)
+{
+    if (this->index.empty())
+    {
+        return false;
+    }
+
+    // Last keyframe at or before timeUs
+    auto keyframe = std::upper_bound(this->index.begin(), this->index.end(), timeUs,
+                                     [](int64_t time, const TOsdKeyframeIndexEntry &entry) { return time < entry.timeUs; });
+    if (keyframe != this->index.begin())
+    {
+        keyframe--;
+    }
+
+    this->grid.assign(this->gridRows * this->gridCols, 0);
+    this->position = keyframe->offset;
+    this->timeUs = keyframe->timeUs;
+    if (!this->next())
+    {
+        return false;
+    }
+    this->advanceTo(timeUs);
+    return true;
+}
+
+void OsdRecordingReader::advanceTo(int64_t timeUs)
+{
+    if (timeUs < this->timeUs)
+    {
+        this->seek(timeUs);
+        return;
+    }
+
+    int64_t nextTimeUs;
+    while (this->peekTime(this->position, nextTimeUs) && nextTimeUs <= timeUs)
+    {
+        if (!this->next())
+        {
+            break;
+        }
+    }
+}
+
+bool OsdRecordingReader::next()
+{
+    return this->readRecord(this->position, true, this->timeUs);
+}
+
+bool OsdRecordingReader::isAtEnd() const
+{
+    return this->position >= this->recordsEnd;
+}
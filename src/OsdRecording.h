@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace OsdRecordingConstants
+{
+    static constexpr char FILE_MAGIC[4] = {'X', 'O', 'S', 'D'};
+    static constexpr char INDEX_MAGIC[4] = {'X', 'I', 'D', 'X'};
+    static constexpr uint16_t FILE_VERSION = 1;
+    static constexpr const char *FILE_EXTENSION = ".xosd";
+
+    // A keyframe at least every 5 s bounds the deltas to replay after a seek
+    static constexpr int64_t KEYFRAME_INTERVAL_US = 5000000;
+    // Frames changing more cells than 1 / n of the grid are written as keyframe
+    static constexpr int KEYFRAME_CHANGED_CELLS_DIVISOR = 4;
+
+    typedef enum : uint8_t
+    {
+        RECORD_KEYFRAME = 1,
+        RECORD_DELTA = 2,
+        RECORD_INDEX = 3,
+    } TRecordType;
+}
+
+struct TOsdKeyframeIndexEntry
+{
+    int64_t timeUs;
+    size_t offset;
+};
+
+/**
+ * @brief OSD DVR: the character grid (uint16_t per cell as in OSD.h) as keyframes plus changed cells.
+ *
+ * File layout, little endian: magic, version, grid rows and columns (the stride of the cells).
+ * Records follow, each starting with its type byte; numbers are LEB128 varints, cells 16 bit.
+ *  - Keyframe: time since the start, OSD type, visible rows and columns, then the whole grid as
+ *    runs of equal cells (run length, cell). The OSD is mostly blank, so this stays small.
+ *  - Delta: time since the previous record, changed cell count, then per changed cell the number
+ *    of cells skipped since the previous changed one and the new cell.
+ *  - Index (on close): keyframe count, per keyframe its time and file offset, the duration; then
+ *    the offset of the index record as 64 bit value and INDEX_MAGIC at the very end.
+ * A recording without index (plugin crashed) is still readable, the reader rebuilds the index.
+ * With ~10 frames per second and a few changed cells per frame, an hour takes a few MB.
+ */
+class OsdRecordingWriter
+{
+public:
+    OsdRecordingWriter() = default;
+    ~OsdRecordingWriter();
+
+    bool open(const std::string &fileName, int gridRows, int gridCols);
+    void close();
+    bool isOpen() const { return this->file != nullptr; }
+
+    // Complete OSD frame. dirtyRows: a column bitmap per grid row, set bits may be unchanged
+    // (cells are compared with the last recorded frame), nullptr compares every cell. The first
+    // frame and frames with a new layout always compare every cell.
+    void addFrame(int64_t timeUs, uint8_t osdType, int visibleRows, int visibleCols, const uint16_t *cells, const uint64_t *dirtyRows);
+
+    int getFrameCount() const { return this->frameCount; }
+    size_t getBytesWritten() const { return this->offset; }
+
+private:
+    FILE *file = nullptr;
+    size_t offset = 0;
+    int gridRows = 0;
+    int gridCols = 0;
+    std::vector<uint16_t> grid; // last recorded frame
+    std::vector<uint8_t> buffer;
+    std::vector<uint32_t> changedCells;
+    std::vector<TOsdKeyframeIndexEntry> index;
+    int64_t startUs = 0;
+    int64_t lastUs = 0;
+    int64_t lastKeyframeUs = 0;
+    uint8_t osdType = 0;
+    int visibleRows = 0;
+    int visibleCols = 0;
+    int frameCount = 0;
+
+    void writeKeyframe(int64_t timeUs);
+    void writeDelta(int64_t timeUs);
+    void flushBuffer();
+};
+
+class OsdRecordingReader
+{
+public:
+    bool open(const std::string &fileName);
+    void close();
+    bool isOpen() const { return !this->data.empty(); }
+
+    int getGridRows() const { return this->gridRows; }
+    int getGridCols() const { return this->gridCols; }
+    int64_t getDurationUs() const { return this->durationUs; }
+    size_t getKeyframeCount() const { return this->index.size(); }
+    size_t getFileSize() const { return this->data.size(); }
+
+    // Grid as it was shown at timeUs: replays from the last keyframe before it
+    bool seek(int64_t timeUs);
+    // Applies the records up to timeUs, seeks if timeUs is before the current time
+    void advanceTo(int64_t timeUs);
+    // Applies the next record, false at the end of the recording
+    bool next();
+    bool isAtEnd() const;
+
+    // State of the last applied record
+    int64_t getTimeUs() const { return this->timeUs; }
+    uint8_t getOsdType() const { return this->osdType; }
+    int getVisibleRows() const { return this->visibleRows; }
+    int getVisibleCols() const { return this->visibleCols; }
+    const std::vector<uint16_t> &getGrid() const { return this->grid; }
+
+private:
+    std::vector<uint8_t> data; // the whole file, a few MB
+    size_t recordsOffset = 0;
+    size_t recordsEnd = 0;
+    int gridRows = 0;
+    int gridCols = 0;
+    std::vector<TOsdKeyframeIndexEntry> index;
+    int64_t durationUs = 0;
+
+    size_t position = 0;
+    int64_t timeUs = 0;
+    uint8_t osdType = 0;
+    int visibleRows = 0;
+    int visibleCols = 0;
+    std::vector<uint16_t> grid;
+
+    bool readIndex();
+    void buildIndex();
+    // Time of the record at position, false if there is none
+    bool peekTime(size_t recordOffset, int64_t &recordTimeUs) const;
+    // Parses (and applies if apply is set) the record at position, advances position
+    bool readRecord(size_t &recordOffset, bool apply, int64_t &recordTimeUs);
+};
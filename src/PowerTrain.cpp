@@ -1,65 +1,64 @@
 #include "PowerTrain.h"
 #include <algorithm>
 #include <cmath>
+#include <numbers>
 
-PowerTrain::PowerTrain(BatteryChemistryType batteryType, double batteryCapacityMah, int batteryCells) : batteryType(batteryType),
-                                                                                                        batteryCapacityMah(batteryCapacityMah),
-                                                                                                        batteryCells(batteryCells)
+using PowerTrainTables::lerp;
+using PowerTrainTables::tableIndex;
+
+namespace
 {
-    this->batteryCapacityRemainingMah = batteryCapacityMah;
-    if (batteryType == Lipo)
-    {
-        this->dischargeCurve = PowerTrainConstants::LIPO_DISCHARGE_CURVE;
-        this->cutOffVoltagePerCell = PowerTrainConstants::LIPO_CUTOFF_VOLTAGE_PER_CELL;
-    }
-    else if (batteryType == Lion)
-    {
-        this->dischargeCurve = PowerTrainConstants::LION_DISCHARGE_CURVE;
-        this->cutOffVoltagePerCell = PowerTrainConstants::LION_CUTOFF_VOLTAGE_PER_CELL;
-    }
+    constexpr TBatteryChemistry LIPO_CHEMISTRY = {
+        PowerTrainConstants::LIPO_INTERNAL_RESISTANCE_PER_CELL,
+        PowerTrainConstants::LIPO_CUTOFF_VOLTAGE_PER_CELL,
+        PowerTrainTables::makeDischargeTable(PowerTrainConstants::LIPO_DISCHARGE_CURVE)
+    };
 
-    this->motorMaxOutputWatts = PowerTrainConstants::MOTOR_PERFORMANCE_CURVE.back().power;
+    constexpr TBatteryChemistry LION_CHEMISTRY = {
+        PowerTrainConstants::LION_INTERNAL_RESISTANCE_PER_CELL,
+        PowerTrainConstants::LION_CUTOFF_VOLTAGE_PER_CELL,
+        PowerTrainTables::makeDischargeTable(PowerTrainConstants::LION_DISCHARGE_CURVE)
+    };
+
+    constexpr TPropulsion BUILT_IN_PROPULSION = {
+        11.1, // 3S LiPo
+        PowerTrainTables::makeMotorTable(PowerTrainConstants::MOTOR_PERFORMANCE_CURVE)
+    };
 }
 
-void PowerTrain::update(double throttleInput, double climbAngleDeg, double dtSec)
+PowerTrain::PowerTrain(BatteryChemistryType batteryType, double batteryCapacityMah, int batteryCells)
+    : PowerTrain(PowerTrain::getBuiltInChemistry(batteryType), batteryCapacityMah, batteryCells, PowerTrain::getBuiltInPropulsion())
 {
-    const double throttlePercent = std::clamp(throttleInput * 100.0, 0.0, 100.0);
-    this->updateBattery(this->motorCurrentAmps, dtSec);
-    this->updateMotor(throttlePercent, this->batteryVoltage, climbAngleDeg, dtSec);
 }
-    
-void PowerTrain::updateBattery(double motorCurrentAmps, double dtSec)
+
+PowerTrain::PowerTrain(const TBatteryChemistry &chemistry, double batteryCapacityMah, int batteryCells, const TPropulsion &propulsion) : battery(chemistry, batteryCapacityMah, batteryCells),
+                                                                                                                                        chemistry(&chemistry),
+                                                                                                                                        propulsion(&propulsion)
 {
-    this->batteryCurrentAmps = motorCurrentAmps;
-    this->batteryCapacityRemainingMah -= motorCurrentAmps * (dtSec / 3600.0f) * 1000.0f; // convert to mAh
+    this->motorMaxOutputWatts = propulsion.motorTable.back().power;
+}
 
-    if (this->batteryCapacityRemainingMah <= 0.0f)
-    {
-        this->batteryCapacityRemainingMah = 0.0f;
-        this->batteryDischarged = true;
-        this->batteryVoltagePerCell = 0.0f;
-        this->batteryVoltage = 0.0f;
-        return;
-    }
+const TBatteryChemistry &PowerTrain::getBuiltInChemistry(BatteryChemistryType batteryType)
+{
+    return batteryType == Lion ? LION_CHEMISTRY : LIPO_CHEMISTRY;
+}
 
-    const double capacityPercent = (this->batteryCapacityRemainingMah / this->batteryCapacityMah) * 100.0f;
-    const double baseVoltagePerCell = this->getBatteryBaseVoltagePerCell(capacityPercent);
-    const double internalResistancePerCell = (this->batteryType == Lipo) ? PowerTrainConstants::LIPO_INTERNAL_RESISTANCE_PER_CELL
-                                                                       : PowerTrainConstants::LION_INTERNAL_RESISTANCE_PER_CELL;
-                                              
-    const double voltageDropPerCell = motorCurrentAmps * internalResistancePerCell;
-    this->batteryVoltagePerCell = baseVoltagePerCell - voltageDropPerCell;
-    this->batteryVoltage = this->batteryVoltagePerCell * this->batteryCells;
+const TPropulsion &PowerTrain::getBuiltInPropulsion()
+{
+    return BUILT_IN_PROPULSION;
+}
 
-    if (this->batteryVoltage <= this->cutOffVoltagePerCell * this->batteryCells)
-    {
-        this->batteryDischarged = true;
-    }
+void PowerTrain::update(double throttleInput, double climbAngleDeg, double dtSec)
+{
+    const double throttlePercent = std::clamp(throttleInput * 100.0, 0.0, 100.0);
+    this->batteryCurrentAmps = this->motorCurrentAmps;
+    this->battery.update(this->motorCurrentAmps, dtSec);
+    this->updateMotor(throttlePercent, this->battery.getVoltage(), climbAngleDeg, dtSec);
 }
 
 void PowerTrain::updateMotor(double throttlePercent, double voltage, double climbAngleDeg, double dtSec)
 {
-    if (this->batteryDischarged)
+    if (this->battery.isDischarged())
     {
         this->motorRPM = 0;
         this->motorCurrentAmps = 0.0f;
@@ -78,7 +77,7 @@ void PowerTrain::updateMotor(double throttlePercent, double voltage, double clim
     // At -90°: factor = 0.5 (50% less load for vertical descent)
     const double loadFactor = 1 + 0.5 * std::sin(climbAngleRad); 
     const MotorValues motorBaseValues = this->interpolateMotorPerformance(throttlePercent);
-    const double voltageRatio = voltage / this->motorReferenceVoltage;
+    const double voltageRatio = voltage / this->propulsion->referenceVoltage;
     const double effectiveVoltageRatio = voltageRatio / loadFactor;
     this->motorRPM = static_cast<int>(motorBaseValues.rpm * effectiveVoltageRatio);
     this->motorCurrentAmps = motorBaseValues.current * voltageRatio * loadFactor;
@@ -88,55 +87,27 @@ void PowerTrain::updateMotor(double throttlePercent, double voltage, double clim
 
 double PowerTrain::getBatteryBaseVoltagePerCell(const double capacityPercent) const
 {
-    if (capacityPercent >= 100.0f)
-    {
-        return this->dischargeCurve.front().voltage;
-    } 
-    else if (capacityPercent <= 0.0f)
-    {
-        return this->dischargeCurve.back().voltage;
-    }   
-
-    for (size_t i = 1; i < this->dischargeCurve.size(); ++i)
-    {
-        if (capacityPercent >= this->dischargeCurve[i].capacityPercent)
-        {
-            const BatteryValues& upper = this->dischargeCurve[i - 1];
-            const BatteryValues& lower = this->dischargeCurve[i];
-
-            // Linear interpolation
-            double slope = (upper.voltage - lower.voltage) / (upper.capacityPercent - lower.capacityPercent);
-            return lower.voltage + slope * (capacityPercent - lower.capacityPercent);
-        }
-    }
-    
-    return 0.0;
+    double t;
+    const int index = tableIndex(capacityPercent, t);
+    const TDischargeTable &table = this->chemistry->dischargeTable;
+    return lerp(table[index], table[index + 1], t);
 }
 
 MotorValues PowerTrain::interpolateMotorPerformance(double throttlePercent) const
 {
-    for (size_t i = 1; i < PowerTrainConstants::MOTOR_PERFORMANCE_CURVE.size(); ++i)
-    {
-        if (throttlePercent <= PowerTrainConstants::MOTOR_PERFORMANCE_CURVE[i].throttlePercent)
-        {
-            const MotorValues& upper = PowerTrainConstants::MOTOR_PERFORMANCE_CURVE[i - 1];
-            const MotorValues& lower = PowerTrainConstants::MOTOR_PERFORMANCE_CURVE[i];
+    double t;
+    const int index = tableIndex(throttlePercent, t);
+    const TMotorTable &table = this->propulsion->motorTable;
+    const TMotorTableValues &lower = table[index];
+    const TMotorTableValues &upper = table[index + 1];
 
-            // Linear interpolation
-            double slope = (throttlePercent - lower.throttlePercent) / (upper.throttlePercent - lower.throttlePercent);
-
-            MotorValues result;
-            result.throttlePercent = throttlePercent;
-            result.voltage = lower.voltage + slope * (upper.voltage - lower.voltage);
-            result.current = lower.current + slope * (upper.current - lower.current);
-            result.power = lower.power + slope * (upper.power - lower.power);
-            result.rpm = static_cast<int>(lower.rpm + slope * (upper.rpm - lower.rpm));
-            result.torque = lower.torque + slope * (upper.torque - lower.torque);
-            result.thrust = static_cast<int>(lower.thrust + slope * (upper.thrust - lower.thrust));
-
-            return result;
-        }
-    }
-    
-    return MotorValues();
+    MotorValues result;
+    result.throttlePercent = throttlePercent;
+    result.voltage = lerp(lower.voltage, upper.voltage, t);
+    result.current = lerp(lower.current, upper.current, t);
+    result.power = lerp(lower.power, upper.power, t);
+    result.rpm = static_cast<int>(lerp(lower.rpm, upper.rpm, t));
+    result.torque = lerp(lower.torque, upper.torque, t);
+    result.thrust = static_cast<int>(lerp(lower.thrust, upper.thrust, t));
+    return result;
 }
@@ -0,0 +1,493 @@
+#include "PowerTrainCatalog.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+
+namespace fs = std::filesystem;
+
+static_assert(std::is_trivially_copyable_v<TCatalogChemistry>, "cached as raw bytes");
+static_assert(std::is_trivially_copyable_v<TCatalogPropulsion>, "cached as raw bytes");
+static_assert(std::is_trivially_copyable_v<TCatalogPack>, "cached as raw bytes");
+
+namespace
+{
+    constexpr const char *SOURCE_FILES[] = {
+        PowerTrainCatalogConstants::CHEMISTRIES_FILE,
+        PowerTrainCatalogConstants::DISCHARGE_CURVES_FILE,
+        PowerTrainCatalogConstants::MOTORS_FILE,
+        PowerTrainCatalogConstants::PACKS_FILE,
+    };
+
+    struct TCsvRow
+    {
+        int line;
+        std::vector<std::string> fields; // in the order of the requested columns
+    };
+
+    std::string trim(const std::string &value)
+    {
+        const size_t start = value.find_first_not_of(" \t\r");
+        if (start == std::string::npos)
+        {
+            return "";
+        }
+        return value.substr(start, value.find_last_not_of(" \t\r") - start + 1);
+    }
+
+    std::vector<std::string> split(const std::string &line)
+    {
+        std::vector<std::string> fields;
+        size_t start = 0;
+        while (true)
+        {
+            const size_t comma = line.find(',', start);
+            fields.push_back(trim(line.substr(start, comma == std::string::npos ? std::string::npos : comma - start)));
+            if (comma == std::string::npos)
+            {
+                return fields;
+            }
+            start = comma + 1;
+        }
+    }
+
+    // Plain CSV without quoting, '#' starts a comment line, the first line is the header.
+    // Columns are matched by name, so their order doesn't matter and extra columns are ignored.
+    bool readCsv(const fs::path &fileName, const std::vector<std::string> &columns, std::vector<TCsvRow> &rows, std::string &error)
+    {
+        std::ifstream file(fileName);
+        if (!file)
+        {
+            error = "Can't open " + fileName.string();
+            return false;
+        }
+
+        std::vector<int> columnIndex;
+        std::string line;
+        int lineNumber = 0;
+        while (std::getline(file, line))
+        {
+            lineNumber++;
+            line = trim(line);
+            if (line.empty() || line[0] == '#')
+            {
+                continue;
+            }
+
+            const std::vector<std::string> fields = split(line);
+            if (columnIndex.empty())
+            {
+                for (const std::string &column : columns)
+                {
+                    const auto field = std::find(fields.begin(), fields.end(), column);
+                    if (field == fields.end())
+                    {
+                        error = fileName.filename().string() + ": column " + column + " missing";
+                        return false;
+                    }
+                    columnIndex.push_back(static_cast<int>(field - fields.begin()));
+                }
+                continue;
+            }
+
+            TCsvRow row = {lineNumber, {}};
+            for (int index : columnIndex)
+            {
+                if (index >= static_cast<int>(fields.size()))
+                {
+                    error = fileName.filename().string() + ":" + std::to_string(lineNumber) + ": too few columns";
+                    return false;
+                }
+                row.fields.push_back(fields[index]);
+            }
+            rows.push_back(std::move(row));
+        }
+        return true;
+    }
+
+    bool toNumber(const fs::path &fileName, const TCsvRow &row, int field, double &value, std::string &error)
+    {
+        try
+        {
+            size_t length;
+            value = std::stod(row.fields[field], &length);
+            if (length == row.fields[field].size())
+            {
+                return true;
+            }
+        }
+        catch (const std::exception &)
+        {
+        }
+        error = fileName.filename().string() + ":" + std::to_string(row.line) + ": invalid number \"" + row.fields[field] + "\"";
+        return false;
+    }
+
+    bool copyName(const fs::path &fileName, const TCsvRow &row, const std::string &name, char (&target)[PowerTrainCatalogConstants::NAME_LENGTH], std::string &error)
+    {
+        if (name.empty() || name.size() >= PowerTrainCatalogConstants::NAME_LENGTH)
+        {
+            error = fileName.filename().string() + ":" + std::to_string(row.line) + ": name empty or longer than " + std::to_string(PowerTrainCatalogConstants::NAME_LENGTH - 1) + " characters";
+            return false;
+        }
+        std::memset(target, 0, sizeof(target));
+        std::memcpy(target, name.data(), name.size());
+        return true;
+    }
+
+    template <typename TPoint>
+    struct TCurvePoint
+    {
+        TPoint point;
+        int line;
+    };
+
+    // Sorts by percent, equal percentages are rejected: the resampling into the tables divides by their difference
+    template <typename TPoint>
+    bool sortCurve(const fs::path &fileName, std::vector<TCurvePoint<TPoint>> &points, double TPoint::*percent, bool descending, std::vector<TPoint> &curve, std::string &error)
+    {
+        std::stable_sort(points.begin(), points.end(), [&](const TCurvePoint<TPoint> &a, const TCurvePoint<TPoint> &b)
+                         { return descending ? a.point.*percent > b.point.*percent : a.point.*percent < b.point.*percent; });
+
+        curve.clear();
+        for (size_t i = 0; i < points.size(); i++)
+        {
+            if (i > 0 && points[i].point.*percent == points[i - 1].point.*percent)
+            {
+                error = fileName.filename().string() + ":" + std::to_string(points[i].line) + ": same percentage as line " + std::to_string(points[i - 1].line);
+                return false;
+            }
+            curve.push_back(points[i].point);
+        }
+        return true;
+    }
+}
+
+bool PowerTrainCatalog::load(const fs::path &directory, const fs::path &cacheFile)
+{
+    this->chemistries.clear();
+    this->propulsions.clear();
+    this->packs.clear();
+    this->loadedFromCache = false;
+    this->error.clear();
+
+    uint64_t sourceStamp;
+    if (!PowerTrainCatalog::getSourceStamp(directory, sourceStamp))
+    {
+        this->error = "CSV files missing in " + directory.string();
+        return false;
+    }
+
+    if (this->readCache(cacheFile, sourceStamp))
+    {
+        this->loadedFromCache = true;
+        return true;
+    }
+
+    if (!this->parse(directory))
+    {
+        this->chemistries.clear();
+        this->propulsions.clear();
+        this->packs.clear();
+        return false;
+    }
+
+    // Not fatal, the CSV files are parsed again next time
+    this->writeCache(cacheFile, sourceStamp);
+    return true;
+}
+
+const TCatalogPropulsion *PowerTrainCatalog::findPropulsion(const std::string &motor, const std::string &propeller) const
+{
+    for (const TCatalogPropulsion &propulsion : this->propulsions)
+    {
+        if (motor == propulsion.motor && propeller == propulsion.propeller)
+        {
+            return &propulsion;
+        }
+    }
+    return nullptr;
+}
+
+const TCatalogPack *PowerTrainCatalog::findPack(const std::string &name) const
+{
+    for (const TCatalogPack &pack : this->packs)
+    {
+        if (name == pack.name)
+        {
+            return &pack;
+        }
+    }
+    return nullptr;
+}
+
+bool PowerTrainCatalog::getSourceStamp(const fs::path &directory, uint64_t &stamp)
+{
+    // FNV-1a over name, size and modification time of the CSV files
+    stamp = 14695981039346656037ull;
+    auto hash = [&stamp](const void *data, size_t size)
+    {
+        const uint8_t *bytes = static_cast<const uint8_t *>(data);
+        for (size_t i = 0; i < size; i++)
+        {
+            stamp = (stamp ^ bytes[i]) * 1099511628211ull;
+        }
+    };
+
+    hash(&PowerTrainCatalogConstants::CACHE_VERSION, sizeof(PowerTrainCatalogConstants::CACHE_VERSION));
+    for (const char *name : SOURCE_FILES)
+    {
+        std::error_code ec;
+        const fs::path fileName = directory / name;
+        const uint64_t size = fs::file_size(fileName, ec);
+        if (ec)
+        {
+            return false;
+        }
+        const int64_t modified = fs::last_write_time(fileName, ec).time_since_epoch().count();
+        if (ec)
+        {
+            return false;
+        }
+        hash(name, std::strlen(name));
+        hash(&size, sizeof(size));
+        hash(&modified, sizeof(modified));
+    }
+    return true;
+}
+
+bool PowerTrainCatalog::readCache(const fs::path &cacheFile, uint64_t sourceStamp)
+{
+    FILE *file = fopen(cacheFile.string().c_str(), "rb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    TCacheHeader header;
+    bool valid = fread(&header, sizeof(header), 1, file) == 1 &&
+                 std::memcmp(header.magic, PowerTrainCatalogConstants::CACHE_MAGIC, sizeof(header.magic)) == 0 &&
+                 header.version == PowerTrainCatalogConstants::CACHE_VERSION &&
+                 header.sourceStamp == sourceStamp;
+
+    if (valid)
+    {
+        this->chemistries.resize(header.chemistries);
+        this->propulsions.resize(header.propulsions);
+        this->packs.resize(header.packs);
+        valid = fread(this->chemistries.data(), sizeof(TCatalogChemistry), header.chemistries, file) == header.chemistries &&
+                fread(this->propulsions.data(), sizeof(TCatalogPropulsion), header.propulsions, file) == header.propulsions &&
+                fread(this->packs.data(), sizeof(TCatalogPack), header.packs, file) == header.packs;
+    }
+    fclose(file);
+
+    for (const TCatalogPack &pack : this->packs)
+    {
+        valid = valid && pack.chemistry >= 0 && pack.chemistry < static_cast<int>(this->chemistries.size());
+    }
+
+    if (!valid)
+    {
+        this->chemistries.clear();
+        this->propulsions.clear();
+        this->packs.clear();
+    }
+    return valid;
+}
+
+bool PowerTrainCatalog::writeCache(const fs::path &cacheFile, uint64_t sourceStamp) const
+{
+    FILE *file = fopen(cacheFile.string().c_str(), "wb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    TCacheHeader header = {};
+    std::memcpy(header.magic, PowerTrainCatalogConstants::CACHE_MAGIC, sizeof(header.magic));
+    header.version = PowerTrainCatalogConstants::CACHE_VERSION;
+    header.sourceStamp = sourceStamp;
+    header.chemistries = static_cast<uint32_t>(this->chemistries.size());
+    header.propulsions = static_cast<uint32_t>(this->propulsions.size());
+    header.packs = static_cast<uint32_t>(this->packs.size());
+
+    const bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                    fwrite(this->chemistries.data(), sizeof(TCatalogChemistry), header.chemistries, file) == header.chemistries &&
+                    fwrite(this->propulsions.data(), sizeof(TCatalogPropulsion), header.propulsions, file) == header.propulsions &&
+                    fwrite(this->packs.data(), sizeof(TCatalogPack), header.packs, file) == header.packs;
+    fclose(file);
+
+    if (!ok)
+    {
+        std::error_code ec;
+        fs::remove(cacheFile, ec);
+    }
+    return ok;
+}
+
+bool PowerTrainCatalog::parse(const fs::path &directory)
+{
+    return this->parseChemistries(directory) && this->parseMotors(directory) && this->parsePacks(directory);
+}
+
+bool PowerTrainCatalog::parseChemistries(const fs::path &directory)
+{
+    const fs::path chemistriesFile = directory / PowerTrainCatalogConstants::CHEMISTRIES_FILE;
+    std::vector<TCsvRow> rows;
+    if (!readCsv(chemistriesFile, {"chemistry", "internal_resistance_ohm", "cutoff_voltage"}, rows, this->error))
+    {
+        return false;
+    }
+
+    for (const TCsvRow &row : rows)
+    {
+        TCatalogChemistry chemistry = {};
+        if (!copyName(chemistriesFile, row, row.fields[0], chemistry.name, this->error) ||
+            !toNumber(chemistriesFile, row, 1, chemistry.chemistry.internalResistancePerCell, this->error) ||
+            !toNumber(chemistriesFile, row, 2, chemistry.chemistry.cutOffVoltagePerCell, this->error))
+        {
+            return false;
+        }
+        this->chemistries.push_back(chemistry);
+    }
+
+    const fs::path curvesFile = directory / PowerTrainCatalogConstants::DISCHARGE_CURVES_FILE;
+    rows.clear();
+    if (!readCsv(curvesFile, {"chemistry", "capacity_percent", "voltage"}, rows, this->error))
+    {
+        return false;
+    }
+
+    for (TCatalogChemistry &chemistry : this->chemistries)
+    {
+        std::vector<TCurvePoint<BatteryValues>> points;
+        for (const TCsvRow &row : rows)
+        {
+            if (row.fields[0] != chemistry.name)
+            {
+                continue;
+            }
+            BatteryValues point;
+            if (!toNumber(curvesFile, row, 1, point.capacityPercent, this->error) ||
+                !toNumber(curvesFile, row, 2, point.voltage, this->error))
+            {
+                return false;
+            }
+            points.push_back({point, row.line});
+        }
+
+        std::vector<BatteryValues> curve;
+        if (!sortCurve(curvesFile, points, &BatteryValues::capacityPercent, true, curve, this->error))
+        {
+            return false;
+        }
+        if (curve.size() < 2 || curve.front().capacityPercent != 100.0 || curve.back().capacityPercent != 0.0)
+        {
+            this->error = curvesFile.filename().string() + ": curve of " + chemistry.name + " must run from 100 to 0 %";
+            return false;
+        }
+        chemistry.chemistry.dischargeTable = PowerTrainTables::makeDischargeTable(curve);
+    }
+    return true;
+}
+
+bool PowerTrainCatalog::parseMotors(const fs::path &directory)
+{
+    const fs::path motorsFile = directory / PowerTrainCatalogConstants::MOTORS_FILE;
+    std::vector<TCsvRow> rows;
+    if (!readCsv(motorsFile, {"motor", "propeller", "reference_voltage", "throttle_percent", "voltage", "current", "power", "rpm", "torque", "thrust"}, rows, this->error))
+    {
+        return false;
+    }
+
+    // One curve per motor and propeller, in the order of their first row
+    std::vector<std::vector<TCurvePoint<MotorValues>>> curves;
+    for (const TCsvRow &row : rows)
+    {
+        MotorValues point;
+        double referenceVoltage, rpm, thrust;
+        if (!toNumber(motorsFile, row, 2, referenceVoltage, this->error) ||
+            !toNumber(motorsFile, row, 3, point.throttlePercent, this->error) ||
+            !toNumber(motorsFile, row, 4, point.voltage, this->error) ||
+            !toNumber(motorsFile, row, 5, point.current, this->error) ||
+            !toNumber(motorsFile, row, 6, point.power, this->error) ||
+            !toNumber(motorsFile, row, 7, rpm, this->error) ||
+            !toNumber(motorsFile, row, 8, point.torque, this->error) ||
+            !toNumber(motorsFile, row, 9, thrust, this->error))
+        {
+            return false;
+        }
+        point.rpm = static_cast<int>(rpm);
+        point.thrust = static_cast<int>(thrust);
+
+        size_t index = 0;
+        while (index < this->propulsions.size() && (row.fields[0] != this->propulsions[index].motor || row.fields[1] != this->propulsions[index].propeller))
+        {
+            index++;
+        }
+        if (index == this->propulsions.size())
+        {
+            TCatalogPropulsion propulsion = {};
+            if (!copyName(motorsFile, row, row.fields[0], propulsion.motor, this->error) ||
+                !copyName(motorsFile, row, row.fields[1], propulsion.propeller, this->error))
+            {
+                return false;
+            }
+            propulsion.propulsion.referenceVoltage = referenceVoltage;
+            this->propulsions.push_back(propulsion);
+            curves.emplace_back();
+        }
+        curves[index].push_back({point, row.line});
+    }
+
+    for (size_t i = 0; i < this->propulsions.size(); i++)
+    {
+        std::vector<MotorValues> curve;
+        if (!sortCurve(motorsFile, curves[i], &MotorValues::throttlePercent, false, curve, this->error))
+        {
+            return false;
+        }
+        if (curve.size() < 2 || curve.front().throttlePercent != 0.0 || curve.back().throttlePercent != 100.0)
+        {
+            this->error = motorsFile.filename().string() + ": curve of " + this->propulsions[i].motor + " / " + this->propulsions[i].propeller + " must run from 0 to 100 %";
+            return false;
+        }
+        this->propulsions[i].propulsion.motorTable = PowerTrainTables::makeMotorTable(curve);
+    }
+    return true;
+}
+
+bool PowerTrainCatalog::parsePacks(const fs::path &directory)
+{
+    const fs::path packsFile = directory / PowerTrainCatalogConstants::PACKS_FILE;
+    std::vector<TCsvRow> rows;
+    if (!readCsv(packsFile, {"pack", "chemistry", "cells", "capacity_mah"}, rows, this->error))
+    {
+        return false;
+    }
+
+    for (const TCsvRow &row : rows)
+    {
+        TCatalogPack pack = {};
+        double cells;
+        if (!copyName(packsFile, row, row.fields[0], pack.name, this->error) ||
+            !toNumber(packsFile, row, 2, cells, this->error) ||
+            !toNumber(packsFile, row, 3, pack.capacityMah, this->error))
+        {
+            return false;
+        }
+        pack.cells = static_cast<int>(cells);
+
+        const auto chemistry = std::find_if(this->chemistries.begin(), this->chemistries.end(), [&row](const TCatalogChemistry &c) { return row.fields[1] == c.name; });
+        if (chemistry == this->chemistries.end() || pack.cells < 1 || pack.cells > BatteryPackConstants::MAX_CELLS || pack.capacityMah <= 0.0)
+        {
+            this->error = packsFile.filename().string() + ":" + std::to_string(row.line) + ": unknown chemistry or invalid cells / capacity";
+            return false;
+        }
+        pack.chemistry = static_cast<int>(chemistry - this->chemistries.begin());
+        this->packs.push_back(pack);
+    }
+    return true;
+}
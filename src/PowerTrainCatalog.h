@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "PowerTrain.h"
+
+namespace PowerTrainCatalogConstants
+{
+    static constexpr int NAME_LENGTH = 48; // including the terminating 0
+    static constexpr char CACHE_MAGIC[4] = {'X', 'P', 'T', 'C'};
+    static constexpr uint32_t CACHE_VERSION = 1;
+
+    static constexpr const char *CHEMISTRIES_FILE = "chemistries.csv";
+    static constexpr const char *DISCHARGE_CURVES_FILE = "discharge_curves.csv";
+    static constexpr const char *MOTORS_FILE = "motors.csv";
+    static constexpr const char *PACKS_FILE = "packs.csv";
+}
+
+struct TCatalogChemistry
+{
+    char name[PowerTrainCatalogConstants::NAME_LENGTH];
+    TBatteryChemistry chemistry;
+};
+
+struct TCatalogPropulsion
+{
+    char motor[PowerTrainCatalogConstants::NAME_LENGTH];
+    char propeller[PowerTrainCatalogConstants::NAME_LENGTH];
+    TPropulsion propulsion;
+};
+
+struct TCatalogPack
+{
+    char name[PowerTrainCatalogConstants::NAME_LENGTH];
+    int chemistry; // index into the chemistries
+    int cells;
+    double capacityMah;
+};
+
+/**
+ * @brief Motors, propellers and battery packs from the CSV files in assets/powertrain.
+ *
+ * The CSV files are parsed once and their curves resampled into the PowerTrain lookup tables.
+ * The result is stored as a flat binary cache, which is used instead of the CSV files as long
+ * as their names, sizes and modification times are unchanged. The tables stay at the same
+ * address for the lifetime of the catalog, so power trains can reference them.
+ */
+class PowerTrainCatalog
+{
+public:
+    // False if the CSV files are missing or invalid, see getError()
+    bool load(const std::filesystem::path &directory, const std::filesystem::path &cacheFile);
+
+    bool isLoadedFromCache() const { return this->loadedFromCache; }
+    const std::string &getError() const { return this->error; }
+
+    const std::vector<TCatalogPropulsion> &getPropulsions() const { return this->propulsions; }
+    const std::vector<TCatalogPack> &getPacks() const { return this->packs; }
+
+    // nullptr if not in the catalog
+    const TCatalogPropulsion *findPropulsion(const std::string &motor, const std::string &propeller) const;
+    const TCatalogPack *findPack(const std::string &name) const;
+    const TBatteryChemistry &getChemistry(const TCatalogPack &pack) const { return this->chemistries[pack.chemistry].chemistry; }
+
+private:
+    struct TCacheHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint64_t sourceStamp;
+        uint32_t chemistries;
+        uint32_t propulsions;
+        uint32_t packs;
+    };
+
+    std::vector<TCatalogChemistry> chemistries;
+    std::vector<TCatalogPropulsion> propulsions;
+    std::vector<TCatalogPack> packs;
+    bool loadedFromCache = false;
+    std::string error;
+
+    static bool getSourceStamp(const std::filesystem::path &directory, uint64_t &stamp);
+    bool readCache(const std::filesystem::path &cacheFile, uint64_t sourceStamp);
+    bool writeCache(const std::filesystem::path &cacheFile, uint64_t sourceStamp) const;
+
+    bool parse(const std::filesystem::path &directory);
+    bool parseChemistries(const std::filesystem::path &directory);
+    bool parseMotors(const std::filesystem::path &directory);
+    bool parsePacks(const std::filesystem::path &directory);
+};
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+struct BatteryValues
+{
+    double capacityPercent;
+    double voltage;
+};
+
+struct MotorValues
+{
+    double throttlePercent;
+    double voltage;
+    double current;
+    double power;
+    int rpm;
+    double torque;
+    int thrust;
+};
+
+namespace PowerTrainConstants
+{
+    static constexpr double DEFAULT_BATTERY_VOLTAGE = 11.1f; // 3S LiPo
+    static constexpr double DEFAULT_BATTERY_CAPACITY_MAH = 2200.0f; // 2200 mAh
+    static constexpr int DEFAULT_BATTERY_CELLS = 3;
+    static const constexpr double LIPO_INTERNAL_RESISTANCE_PER_CELL = 0.01; // Ohms
+    static const constexpr double LION_INTERNAL_RESISTANCE_PER_CELL = 0.015; // Ohms
+    static constexpr double LIPO_CUTOFF_VOLTAGE_PER_CELL = 3.2; // Volts
+    static constexpr double LION_CUTOFF_VOLTAGE_PER_CELL = 2.5; // Volts
+
+    // T-Motor AT2312 1400 KV @ APC 8x6
+    static constexpr std::array<MotorValues, 19> MOTOR_PERFORMANCE_CURVE = {{
+        {0.0f,      11.70f,   0.00f,    0.00f,      0,      0.00f,   0   },
+        {5.0f,      11.70f,   0.37f,    4.13f,      336,    0.003f, 19   },
+        {10.0f,     11.70f,   0.73f,    8.15f,      671,    0.006f, 38   },
+        {15.0f,     11.70f,   1.10f,    12.29f,     1006,   0.009f, 57   },
+        {20.0f,     11.70f,   1.46f,    16.32f,     1342,   0.012f, 76   },
+        {25.0f,     11.70f,   2.19f,    24.48f,     2009,   0.018f, 114  },
+        {30.0f,     11.70f,   3.65f,    40.77f,     3354,   0.030f, 190  },
+        {35.0f,     11.70f,   4.75f,    53.06f,     4362,   0.039f, 247  },
+        {40.0f,     11.70f,   5.85f,    65.19f,     6709,   0.062f, 376  },
+        {45.0f,     11.12f,   6.75f,    74.94f,     7075,   0.090f, 422  },
+        {50.0f,     11.16f,   7.75f,    86.32f,     7531,   0.076f, 480  },
+        {55.0f,     11.13f,   8.82f,    97.91f,     7870,   0.083f, 533  },
+        {60.0f,     11.10f,   9.91f,    109.88f,    8179,   0.090f, 592  },
+        {65.0f,     11.06f,   11.16f,   123.29f,    8530,   0.098f, 648  },
+        {70.0f,     11.03f,   12.52f,   137.88f,    8825,   0.106f, 703  },
+        {75.0f,     10.96f,   14.37f,   157.37f,    9237,   0.117f, 777  },
+        {80.0f,     10.92f,   16.62f,   181.38f,    9731,   0.130f, 853  },
+        {90.0f,     10.81f,   21.79f,   235.278f,   10530,  0.115f, 1009 },
+        {100.0f,    10.77f,   23.34f,   251.15f,    10709,  0.161f, 1050 }
+    }};
+
+    static constexpr std::array<BatteryValues, 11> LIPO_DISCHARGE_CURVE = {{
+        {100.0f,    4.20f},
+        {95.0f,     4.08f},
+        {90.0f,     3.98f},
+        {80.0f,     3.88f},
+        {70.0f,     3.82f},
+        {50.0f,     3.78f},
+        {30.0f,     3.70f},
+        {20.0f,     3.62f},
+        {10.0f,     3.45f},
+        {5.0f,      3.20f},
+        {0.0f,      3.00f} 
+    }};
+
+    static constexpr std::array<BatteryValues, 11> LION_DISCHARGE_CURVE = {{
+        {100.0f,    4.20f},
+        {95.0f,     4.12f},
+        {90.0f,     4.07f},
+        {80.0f,     4.00f},
+        {70.0f,     3.95f},
+        {50.0f,     3.85f},
+        {30.0f,     3.65f},
+        {20.0f,     3.55f},
+        {10.0f,     3.35f},
+        {5.0f,      3.10f},
+        {0.0f,      2.50f} 
+    }};
+
+    // Curves are resampled to lookup tables over 0..100 % in 1 % steps. All built-in curve points
+    // are on multiples of 5 %, so the tables reproduce the piecewise linear curves exactly.
+    static constexpr int TABLE_SIZE = 101;
+    static constexpr double TABLE_STEP_PERCENT = 100.0 / (TABLE_SIZE - 1);
+}
+
+// Motor curve point with rpm and thrust kept fractional for interpolation
+struct TMotorTableValues
+{
+    double voltage;
+    double current;
+    double power;
+    double rpm;
+    double torque;
+    double thrust;
+};
+
+typedef std::array<TMotorTableValues, PowerTrainConstants::TABLE_SIZE> TMotorTable;
+typedef std::array<double, PowerTrainConstants::TABLE_SIZE> TDischargeTable;
+
+struct TBatteryChemistry
+{
+    double internalResistancePerCell; // Ohms
+    double cutOffVoltagePerCell;
+    TDischargeTable dischargeTable;   // Voltage per cell over the remaining capacity
+};
+
+// Motor with propeller, from a thrust test at the reference voltage
+struct TPropulsion
+{
+    double referenceVoltage;
+    TMotorTable motorTable;           // Over the throttle
+};
+
+namespace PowerTrainTables
+{
+    constexpr double lerp(double a, double b, double t)
+    {
+        return a + (b - a) * t;
+    }
+
+    // Table index and interpolation factor of a percentage, clamped to 0..100
+    inline int tableIndex(double percent, double &t)
+    {
+        const double x = std::clamp(percent, 0.0, 100.0) / PowerTrainConstants::TABLE_STEP_PERCENT;
+        const int index = std::min(static_cast<int>(x), PowerTrainConstants::TABLE_SIZE - 2);
+        t = x - index;
+        return index;
+    }
+
+    // Curve ordered from full to empty, from 100 to 0 %
+    template <typename Curve>
+    constexpr TDischargeTable makeDischargeTable(const Curve &curve)
+    {
+        TDischargeTable table = {};
+        const size_t n = curve.size();
+        for (int i = 0; i < PowerTrainConstants::TABLE_SIZE; i++)
+        {
+            const double percent = i * PowerTrainConstants::TABLE_STEP_PERCENT;
+            size_t segment = 1;
+            while (segment < n - 1 && percent < curve[segment].capacityPercent)
+            {
+                segment++;
+            }
+            const BatteryValues &upper = curve[segment - 1];
+            const BatteryValues &lower = curve[segment];
+            table[i] = lerp(lower.voltage, upper.voltage, (percent - lower.capacityPercent) / (upper.capacityPercent - lower.capacityPercent));
+        }
+        return table;
+    }
+
+    // Curve ordered from 0 to 100 % throttle
+    template <typename Curve>
+    constexpr TMotorTable makeMotorTable(const Curve &curve)
+    {
+        TMotorTable table = {};
+        const size_t n = curve.size();
+        for (int i = 0; i < PowerTrainConstants::TABLE_SIZE; i++)
+        {
+            const double percent = i * PowerTrainConstants::TABLE_STEP_PERCENT;
+            size_t segment = 1;
+            while (segment < n - 1 && percent > curve[segment].throttlePercent)
+            {
+                segment++;
+            }
+            const MotorValues &lower = curve[segment - 1];
+            const MotorValues &upper = curve[segment];
+            const double t = (percent - lower.throttlePercent) / (upper.throttlePercent - lower.throttlePercent);
+            table[i] = {
+                lerp(lower.voltage, upper.voltage, t),
+                lerp(lower.current, upper.current, t),
+                lerp(lower.power, upper.power, t),
+                lerp(lower.rpm, upper.rpm, t),
+                lerp(lower.torque, upper.torque, t),
+                lerp(lower.thrust, upper.thrust, t)
+            };
+        }
+        return table;
+    }
+}
@@ -0,0 +1,158 @@
+#include "Rangefinder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+#include "core/Clock.h"
+
+using MathUtils::vector3D;
+
+Rangefinder::Rangefinder()
+{
+    this->probe = XPLMCreateProbe(xplm_ProbeY);
+}
+
+Rangefinder::~Rangefinder()
+{
+    if (this->probe != nullptr)
+    {
+        XPLMDestroyProbe(this->probe);
+    }
+}
+
+void Rangefinder::configure(int rateHz)
+{
+    this->rateHz = std::clamp(rateHz, RangefinderConstants::MIN_RATE_HZ, RangefinderConstants::MAX_RATE_HZ);
+    this->reset();
+}
+
+void Rangefinder::reset()
+{
+    this->hasSample = false;
+    this->distanceM = RangefinderConstants::OUT_OF_RANGE;
+    this->probesLastMeasurement = 0;
+}
+
+bool Rangefinder::isSampleDue(int64_t nowUs) const
+{
+    return !this->hasSample || nowUs >= this->nextSampleUs;
+}
+
+void Rangefinder::measure(const TRangefinderPose &pose, int64_t nowUs)
+{
+    // Keep the sample grid, unless the flight loop is slower than the sensor
+    const int64_t periodUs = ClockConstants::US_PER_S / this->rateHz;
+    this->nextSampleUs = this->hasSample ? this->nextSampleUs + periodUs : nowUs + periodUs;
+    if (nowUs >= this->nextSampleUs)
+    {
+        this->nextSampleUs = nowUs + periodUs;
+    }
+
+    if (this->hasSample && this->canReuse(pose))
+    {
+        this->probesLastMeasurement = 0;
+        return;
+    }
+    this->hasSample = true;
+    this->lastPose = pose;
+
+    const float sr = sinf(MathUtils::degreesToRadians(pose.roll));
+    const float cr = cosf(MathUtils::degreesToRadians(pose.roll));
+    const float sp = sinf(MathUtils::degreesToRadians(pose.pitch));
+    const float cp = cosf(MathUtils::degreesToRadians(pose.pitch));
+    const float sy = sinf(MathUtils::degreesToRadians(pose.yaw));
+    const float cy = cosf(MathUtils::degreesToRadians(pose.yaw));
+
+    // Body axes in NED, then to local OpenGL: x = east, y = -down, z = -north
+    auto toLocal = [](float north, float east, float down) -> vector3D
+    {
+        return {east, -down, -north};
+    };
+    const vector3D forward = toLocal(cp * cy, cp * sy, -sp);
+    const vector3D right = toLocal(sr * sp * cy - cr * sy, sr * sp * sy + cr * cy, sr * cp);
+    const vector3D down = toLocal(cr * sp * cy + sr * sy, cr * sp * sy - sr * cy, cr * cp);
+
+    int probes = 0;
+    float nearest = this->castRay(pose, down, probes);
+
+    const float spread = tanf(MathUtils::degreesToRadians(RangefinderConstants::CONE_HALF_ANGLE_DEG));
+    for (int i = 0; i < RangefinderConstants::CONE_RAYS; i++)
+    {
+        const float angle = 2.0f * std::numbers::pi_v<float> * i / RangefinderConstants::CONE_RAYS;
+        const float f = cosf(angle) * spread;
+        const float r = sinf(angle) * spread;
+        vector3D direction = {
+            down.x + forward.x * f + right.x * r,
+            down.y + forward.y * f + right.y * r,
+            down.z + forward.z * f + right.z * r};
+        const float length = sqrtf(direction.x * direction.x + direction.y * direction.y + direction.z * direction.z);
+        direction = {direction.x / length, direction.y / length, direction.z / length};
+
+        const float distance = this->castRay(pose, direction, probes);
+        if (distance != RangefinderConstants::OUT_OF_RANGE && (nearest == RangefinderConstants::OUT_OF_RANGE || distance < nearest))
+        {
+            nearest = distance;
+        }
+    }
+
+    this->distanceM = nearest;
+    this->probesLastMeasurement = probes;
+}
+
+bool Rangefinder::canReuse(const TRangefinderPose &pose) const
+{
+    const double dx = pose.x - this->lastPose.x;
+    const double dy = pose.y - this->lastPose.y;
+    const double dz = pose.z - this->lastPose.z;
+    return dx * dx + dy * dy + dz * dz < RangefinderConstants::REUSE_DISTANCE_M * RangefinderConstants::REUSE_DISTANCE_M &&
+           fabsf(pose.roll - this->lastPose.roll) < RangefinderConstants::REUSE_ANGLE_DEG &&
+           fabsf(pose.pitch - this->lastPose.pitch) < RangefinderConstants::REUSE_ANGLE_DEG;
+}
+
+float Rangefinder::castRay(const TRangefinderPose &pose, const vector3D &direction, int &probes)
+{
+    // Pointing up or at the horizon
+    if (-direction.y < cosf(MathUtils::degreesToRadians(RangefinderConstants::MAX_TILT_DEG)) || this->probe == nullptr)
+    {
+        return RangefinderConstants::OUT_OF_RANGE;
+    }
+
+    float range = 0.0f;
+    for (int i = 0; i < RangefinderConstants::MAX_PROBES_PER_RAY; i++)
+    {
+        const double x = pose.x + direction.x * range;
+        const double y = pose.y + direction.y * range;
+        const double z = pose.z + direction.z * range;
+
+        XPLMProbeInfo_t info;
+        info.structSize = sizeof(XPLMProbeInfo_t);
+        probes++;
+        if (XPLMProbeTerrainXYZ(this->probe, static_cast<float>(x), static_cast<float>(y), static_cast<float>(z), &info) != xplm_ProbeHitTerrain)
+        {
+            return RangefinderConstants::OUT_OF_RANGE;
+        }
+
+        // Height above the terrain below the current ray end, negative if the ray went underground
+        const float height = static_cast<float>(y - info.locationY);
+        if (fabsf(height) < RangefinderConstants::CONVERGENCE_M)
+        {
+            break;
+        }
+
+        // Next end point: where the ray meets a plane at the terrain height just probed
+        const float next = std::max(range + height / -direction.y, 0.0f);
+        if (next == range)
+        {
+            // Sensor below the terrain, e.g. standing on the ground
+            break;
+        }
+        range = next;
+        if (range > RangefinderConstants::MAX_DISTANCE_M * 2.0f)
+        {
+            return RangefinderConstants::OUT_OF_RANGE;
+        }
+    }
+
+    return range <= RangefinderConstants::MAX_DISTANCE_M ? range : RangefinderConstants::OUT_OF_RANGE;
+}
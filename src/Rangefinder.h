@@ -0,0 +1,83 @@
+#pragma once
+
+#include "platform.h"
+
+#include <cstdint>
+
+#include <XPLMScenery.h>
+
+#include "MathUtils.h"
+
+namespace RangefinderConstants
+{
+    static constexpr int MIN_RATE_HZ = 5;
+    static constexpr int MAX_RATE_HZ = 100;
+    static constexpr int DEFAULT_RATE_HZ = 25;
+
+    static constexpr float MAX_DISTANCE_M = 10.0f;
+    static constexpr float OUT_OF_RANGE = -1.0f;
+
+    // Beam cone: center ray plus CONE_RAYS rays at the half angle, nearest return wins
+    static constexpr float CONE_HALF_ANGLE_DEG = 5.0f;
+    static constexpr int CONE_RAYS = 4;
+    // Rays flatter than this never reach the ground within range
+    static constexpr float MAX_TILT_DEG = 80.0f;
+
+    // Terrain probes per ray, each one moves the ray end to the terrain height below it
+    static constexpr int MAX_PROBES_PER_RAY = 4;
+    static constexpr float CONVERGENCE_M = 0.01f;
+
+    // The last result is reused while position and attitude changed less than this
+    static constexpr float REUSE_DISTANCE_M = 0.02f;
+    static constexpr float REUSE_ANGLE_DEG = 0.2f;
+}
+
+// Aircraft position in X-Plane local OpenGL coordinates (x east, y up, z south), attitude in degrees
+struct TRangefinderPose
+{
+    double x;
+    double y;
+    double z;
+    float roll;
+    float pitch;
+    float yaw;
+};
+
+/**
+ * @brief Downward looking rangefinder, measured along the body down axis with terrain probes.
+ *
+ * Measures at its own rate, independent of the X-Plane frame rate (at most once per frame).
+ * Every ray is marched to the ground with a few vertical terrain probes, which converges in
+ * one or two steps over flat or moderately sloped terrain. Main thread only.
+ */
+class Rangefinder
+{
+public:
+    Rangefinder();
+    ~Rangefinder();
+
+    void configure(int rateHz);
+    void reset();
+
+    // Times are Clock::NowUs(), or the sim clock in lockstep
+    bool isSampleDue(int64_t nowUs) const;
+    void measure(const TRangefinderPose &pose, int64_t nowUs);
+
+    // Meters along the beam, OUT_OF_RANGE if nothing was hit within MAX_DISTANCE_M
+    float getDistanceM() const { return this->distanceM; }
+    int getProbesLastMeasurement() const { return this->probesLastMeasurement; }
+
+private:
+    XPLMProbeRef probe = nullptr;
+
+    int rateHz = RangefinderConstants::DEFAULT_RATE_HZ;
+    int64_t nextSampleUs = 0;
+    bool hasSample = false;
+
+    TRangefinderPose lastPose = {};
+    float distanceM = RangefinderConstants::OUT_OF_RANGE;
+    int probesLastMeasurement = 0;
+
+    bool canReuse(const TRangefinderPose &pose) const;
+    float castRay(const TRangefinderPose &pose, const MathUtils::vector3D &direction, int &probes);
+};
@@ -0,0 +1,84 @@
+#include "SensorExtrapolator.h"
+
+#include <algorithm>
+
+SensorExtrapolator::SensorExtrapolator()
+{
+    this->reset();
+}
+
+void SensorExtrapolator::reset()
+{
+    this->history = {};
+    this->head = 0;
+    this->count = 0;
+}
+
+const SensorExtrapolator::TSample &SensorExtrapolator::sample(int age) const
+{
+    const int index = (this->head - 1 - age + SensorExtrapolatorConstants::HISTORY_SIZE) % SensorExtrapolatorConstants::HISTORY_SIZE;
+    return this->history[index];
+}
+
+void SensorExtrapolator::addSample(const TSimdata &simData, int64_t timeUs)
+{
+    TSample &sample = this->history[this->head];
+    sample.timeUs = timeUs;
+    sample.attitude = computeQuaternionFromEuler(simData.euler);
+    sample.gyro = simData.gyro;
+    sample.acceleration = simData.acceleration;
+
+    this->head = (this->head + 1) % SensorExtrapolatorConstants::HISTORY_SIZE;
+    this->count = std::min(this->count + 1, SensorExtrapolatorConstants::HISTORY_SIZE);
+}
+
+int64_t SensorExtrapolator::meanFramePeriodUs() const
+{
+    return (this->sample(0).timeUs - this->sample(this->count - 1).timeUs) / (this->count - 1);
+}
+
+void SensorExtrapolator::extrapolate(TSensorSnapshot &snapshot, int64_t nowUs)
+{
+    if (this->count == 0 || snapshot.sampleTimeUs != this->sample(0).timeUs)
+    {
+        if (this->count > 0 && snapshot.sampleTimeUs - this->sample(0).timeUs > SensorExtrapolatorConstants::MAX_SAMPLE_GAP_US)
+        {
+            // Sim was paused or stalled, don't extrapolate across the gap
+            this->reset();
+        }
+        this->addSample(snapshot.reference, snapshot.sampleTimeUs);
+    }
+
+    if (this->count < 2)
+    {
+        return;
+    }
+
+    const TSample &last = this->sample(0);
+    const TSample &previous = this->sample(1);
+
+    const int64_t sampleDeltaUs = last.timeUs - previous.timeUs;
+    const int64_t ageUs = nowUs - last.timeUs;
+    if (sampleDeltaUs <= 0 || ageUs <= 0 || ageUs > SensorExtrapolatorConstants::MAX_SAMPLE_GAP_US)
+    {
+        return;
+    }
+
+    const float horizonUs = std::min<float>(static_cast<float>(ageUs), SensorExtrapolatorConstants::MAX_HORIZON_FRAMES * this->meanFramePeriodUs());
+    const float factor = horizonUs / sampleDeltaUs;
+
+    // Continue the rotation of the last frame: delta * last, delta = last * conj(previous)
+    const quaternion delta = quaternionMultiply(last.attitude, quaternionConjugate(previous.attitude));
+    const quaternion attitude = quaternionNormalize(quaternionMultiply(quaternionScaleRotation(delta, factor), last.attitude));
+    snapshot.simData.euler = computeEulerFromQuaternion(attitude);
+
+    // The trend comes from the clean X-Plane values and is added to the sensor pipeline output,
+    // extrapolating the noisy values would amplify the noise
+    snapshot.simData.gyro.x += (last.gyro.x - previous.gyro.x) * factor;
+    snapshot.simData.gyro.y += (last.gyro.y - previous.gyro.y) * factor;
+    snapshot.simData.gyro.z += (last.gyro.z - previous.gyro.z) * factor;
+
+    snapshot.simData.acceleration.x += (last.acceleration.x - previous.acceleration.x) * factor;
+    snapshot.simData.acceleration.y += (last.acceleration.y - previous.acceleration.y) * factor;
+    snapshot.simData.acceleration.z += (last.acceleration.z - previous.acceleration.z) * factor;
+}
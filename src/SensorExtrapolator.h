@@ -0,0 +1,54 @@
+#pragma once
+
+#include "platform.h"
+
+#include <array>
+#include <cstdint>
+
+#include "MathUtils.h"
+#include "SimData.h"
+
+namespace SensorExtrapolatorConstants
+{
+    static constexpr int HISTORY_SIZE = 4;
+    // Never extrapolate further than this many mean X-Plane frame periods
+    static constexpr float MAX_HORIZON_FRAMES = 1.5f;
+    // Larger gaps between samples (pause, loading, stutter) hold the last sample instead
+    static constexpr int64_t MAX_SAMPLE_GAP_US = 100000;
+}
+
+/**
+ * @brief Produces smooth intermediate attitude, gyro and accelerometer samples between X-Plane frames.
+ *
+ * Keeps a short timestamped history of the frame samples. At send time the attitude is
+ * extrapolated along the rotation between the last two samples, gyro and accelerometer
+ * linearly. Only used by the fixed rate sender, which runs faster than the flight loop.
+ */
+class SensorExtrapolator
+{
+public:
+    SensorExtrapolator();
+
+    void reset();
+
+    // Records the snapshot reference if it carries a new X-Plane sample and moves attitude, gyro
+    // and accelerometer of simData to nowUs (Clock::NowUs(), the clock the snapshots are stamped with)
+    void extrapolate(TSensorSnapshot &snapshot, int64_t nowUs);
+
+private:
+    struct TSample
+    {
+        int64_t timeUs;
+        quaternion attitude;
+        vector3D gyro;
+        vector3D acceleration;
+    };
+
+    std::array<TSample, SensorExtrapolatorConstants::HISTORY_SIZE> history;
+    int head = 0;
+    int count = 0;
+
+    void addSample(const TSimdata &simData, int64_t timeUs);
+    const TSample &sample(int age) const;
+    int64_t meanFramePeriodUs() const;
+};
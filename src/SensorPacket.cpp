@@ -0,0 +1,75 @@
+#include "SensorPacket.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace SensorPacket
+{
+    static int16_t clampToInt16(float value)
+    {
+        return static_cast<int16_t>(round(std::clamp(value, static_cast<float>(INT16_MIN), static_cast<float>(INT16_MAX))));
+    }
+
+    TMSPSimulatorToINAV encode(const TSensorSnapshot &snapshot, bool hasNewGpsData)
+    {
+        const TSimdata &simData = snapshot.simData;
+
+        TMSPSimulatorToINAV data = {0};
+
+        data.header.version = MSPConstants::MSP_SIMULATOR_VERSION;
+        data.header.flags = snapshot.flags | (hasNewGpsData ? SIMU_HAS_NEW_GPS_DATA : 0);
+
+        data.fix = snapshot.fix;
+        data.numSat = (uint8_t)simData.numSats;
+        data.lat = (int32_t)round(simData.latitude * 10000000);
+        data.lon = (int32_t)round(simData.longitude * 10000000);
+        data.alt = (int32_t)round(simData.elevation * 100);      // expected by inav: elevation in cm
+        data.speed = (int16_t)round(simData.speed * 100);        // expected by inav: ground speed cm/sec
+        data.airspeed = (uint16_t)round(simData.airspeed * 100); // expected by inav: ground speed cm/sec
+
+        data.course = (int16_t)round(simData.course * 10); // expected by inav: deg * 10
+        if (data.course < 0)
+            data.course += 3600;
+
+        // Smoothed receiver velocities, cm/s. Zero lets INAV calculate velocities from the positions by itself
+        if (snapshot.gpsVelocities)
+        {
+            data.velNED[0] = clampToInt16(simData.velNED.x * 100.0f); // nedVelNorth
+            data.velNED[1] = clampToInt16(simData.velNED.y * 100.0f); // nedVelEast
+            data.velNED[2] = clampToInt16(simData.velNED.z * 100.0f); // nedVelDown
+        }
+
+        // expected order of rotation from local to global: roll, pitch, yaw
+        data.roll = (int16_t)round(simData.euler.roll * 10);   // expected by inav: left wing down - negative roll, 1 degree = 10, values range: -1800...1800
+        data.pitch = (int16_t)round(-simData.euler.pitch * 10); // expected by inav: stick down/nose up - negative pitch, upside-down: stick down/nose up - positiive pitch, 1 degree = 10 , values range: -1800...1800
+        data.yaw = (int16_t)round(simData.euler.yaw * 10);    // expected by inav: rotate clockwise( top view) - positive yaw+, 1 degreee = 10 , values range: 0...3600 , north = 0
+        if (data.yaw < 0)
+            data.yaw += 3600;
+
+
+        data.accel_x = clampToInt16(-simData.acceleration.x * 1000.0f); // expected by inav: forward - positive
+        data.accel_y = clampToInt16(simData.acceleration.y * 1000.0f);  // expected by inav: right - negative
+        data.accel_z = clampToInt16(simData.acceleration.z * 1000.0f);  // expected by inav: 1.0f in stable position (1G)
+
+        data.gyro_x = clampToInt16(simData.gyro.x * 16.0f);  // expected by inav: roll left wing down rotation -> negative
+        data.gyro_y = clampToInt16(-simData.gyro.y * 16.0f); // expected by inav: pitch up rotation -> negative, 1 deerees per second
+        data.gyro_z = clampToInt16(-simData.gyro.z * 16.0f); // expected by inav: yaw clockwise rotation (top view) ->negative
+
+        data.baro = (int32_t)round(simData.baro * 3386.39f);
+        data.mag_x = clampToInt16(simData.mag.x * 16000.0f);
+        data.mag_y = clampToInt16(simData.mag.y * 16000.0f);
+        data.mag_z = clampToInt16(simData.mag.z * 16000.0f);
+
+        data.rangefinder_distance_cm = simData.rangefinder_distance_cm;
+
+        data.vbat = (uint8_t)round(snapshot.batteryVoltage * 10);
+        data.current = snapshot.batteryCurrent * 10;
+
+        std::memcpy(data.rc_inputs, snapshot.rc_inputs, sizeof(data.rc_inputs));
+        data.rssi = snapshot.rssi;
+
+        return data;
+    }
+}
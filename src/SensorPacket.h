@@ -0,0 +1,113 @@
+#pragma once
+
+#include "platform.h"
+
+#include <cstdint>
+
+#include "MathUtils.h"
+#include "MSP.h"
+
+// MSP_SIMULATOR packet to INAV and the data it is built from. Independent of X-Plane, shared with the trace player tool.
+
+namespace SensorPacketConstants
+{
+    static constexpr int RC_INPUT_CHANNELS = 8;
+}
+
+// In Xplane format: floating point data
+struct TSimdata
+{
+    int numSats;
+    int fixType;
+    float airspeed;
+    float latitude;
+    float longitude;
+    float elevation;
+    float speed;
+    float course;
+    MathUtils::vector3D acceleration;
+    MathUtils::vector3D gyro;
+    MathUtils::eulerAngles euler;
+    MathUtils::vector3D velNED;
+    MathUtils::vector3D mag;
+    float baro;
+    uint16_t rangefinder_distance_cm;
+    float battery_voltage;
+    float current_consumption;
+};
+
+#pragma pack(1)
+
+struct TMSPSimultatorToINAVHeader
+{
+    uint8_t version; // MSP_SIMULATOR_VERSION
+    uint16_t flags; // TSimulatorFlags
+};
+
+struct TMSPSimulatorToINAV
+{
+    TMSPSimultatorToINAVHeader header;
+
+    uint8_t fix;
+    uint8_t numSat;
+    int32_t lat;
+    int32_t lon;
+    int32_t alt;
+    int16_t speed;
+    int16_t course;
+    int16_t velNED[3];
+
+    int16_t roll;
+    int16_t pitch;
+    int16_t yaw;
+
+    int16_t accel_x;
+    int16_t accel_y;
+    int16_t accel_z;
+
+    int16_t gyro_x;
+    int16_t gyro_y;
+    int16_t gyro_z;
+
+    int32_t baro;
+
+    int16_t mag_x;
+    int16_t mag_y;
+    int16_t mag_z;
+
+    // SIMU_EXT_BATTERY_VOLTAGE in format 2
+    uint8_t vbat;      // 126->12.6V
+    uint16_t airspeed; // cm/s
+
+    uint16_t rangefinder_distance_cm; // cm
+
+    uint16_t current;
+
+    // RC inputs
+    uint16_t rc_inputs[SensorPacketConstants::RC_INPUT_CHANNELS];
+    uint16_t rssi;
+};
+#pragma pack()
+
+// Everything needed to build one MSP_SIMULATOR packet for HITL, published once per cycle
+struct TSensorSnapshot
+{
+    TSimdata simData;
+    uint16_t flags;       // TSimulatorFlags, SIMU_HAS_NEW_GPS_DATA is derived from gpsSequence
+    uint8_t fix;
+    uint32_t gpsSequence; // incremented with every GPS sample INAV should see
+    float batteryVoltage;
+    float batteryCurrent;
+    uint16_t rc_inputs[SensorPacketConstants::RC_INPUT_CHANNELS];
+    uint16_t rssi;
+    TSimdata reference;   // X-Plane values before the sensor pipeline
+    int64_t sampleTimeUs; // when simData was read from X-Plane, steady clock
+    bool extrapolate;     // sender thread may extrapolate attitude, gyro and acc to the send time
+    bool gpsVelocities;   // send velNED, otherwise zeros
+};
+
+namespace SensorPacket
+{
+    // Pure function of the snapshot, safe on any thread
+    TMSPSimulatorToINAV encode(const TSensorSnapshot &snapshot, bool hasNewGpsData);
+}
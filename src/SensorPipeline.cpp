@@ -0,0 +1,244 @@
+#include "SensorPipeline.h"
+
+#include <algorithm>
+#include <cmath>
+
+static TSensorStageConfig makeStage(TSensorStageType type, TSensorChannel first, std::initializer_list<float> values, float parameter)
+{
+    TSensorStageConfig config = {};
+    config.type = type;
+    config.first = first;
+    config.count = std::min<int>(static_cast<int>(values.size()), SensorPipelineConstants::MAX_SENSOR_CHANNELS);
+    std::copy_n(values.begin(), config.count, config.values.begin());
+    config.parameter = parameter;
+    return config;
+}
+
+TSensorStageConfig TSensorStageConfig::Bias(TSensorChannel first, std::initializer_list<float> values)
+{
+    return makeStage(SENSOR_STAGE_BIAS, first, values, 0.0f);
+}
+
+TSensorStageConfig TSensorStageConfig::Scale(TSensorChannel first, std::initializer_list<float> values)
+{
+    return makeStage(SENSOR_STAGE_SCALE, first, values, 0.0f);
+}
+
+TSensorStageConfig TSensorStageConfig::Noise(TSensorChannel first, std::initializer_list<float> sigmas)
+{
+    return makeStage(SENSOR_STAGE_NOISE, first, sigmas, 0.0f);
+}
+
+TSensorStageConfig TSensorStageConfig::Quantization(TSensorChannel first, std::initializer_list<float> steps)
+{
+    return makeStage(SENSOR_STAGE_QUANTIZATION, first, steps, 0.0f);
+}
+
+TSensorStageConfig TSensorStageConfig::Delay(TSensorChannel first, int count, int cycles)
+{
+    TSensorStageConfig config = makeStage(SENSOR_STAGE_DELAY, first, {}, static_cast<float>(cycles));
+    config.count = std::min(count, SensorPipelineConstants::MAX_SENSOR_CHANNELS);
+    return config;
+}
+
+TSensorStageConfig TSensorStageConfig::Dropout(TSensorChannel first, std::initializer_list<float> values, float probability)
+{
+    return makeStage(SENSOR_STAGE_DROPOUT, first, values, probability);
+}
+
+TSensorStageConfig TSensorStageConfig::Stuck(TSensorChannel first, int count)
+{
+    TSensorStageConfig config = makeStage(SENSOR_STAGE_STUCK, first, {}, 0.0f);
+    config.count = std::min(count, SensorPipelineConstants::MAX_SENSOR_CHANNELS);
+    return config;
+}
+
+TSensorStageConfig TSensorStageConfig::Drift(TSensorChannel first, std::initializer_list<float> amplitudes, float periodS)
+{
+    return makeStage(SENSOR_STAGE_DRIFT, first, amplitudes, periodS);
+}
+
+SensorPipeline::SensorPipeline()
+{
+    for (int sensor = 0; sensor < SENSOR_COUNT; sensor++)
+    {
+        this->streams[sensor].seed(this->seed, sensor);
+    }
+}
+
+void SensorPipeline::setSeed(uint64_t seed)
+{
+    this->seed = seed;
+}
+
+void SensorPipeline::configure(TSensorType sensor, const std::vector<TSensorStageConfig> &stages)
+{
+    std::vector<TStage> &sensorStages = this->stages[sensor];
+    sensorStages.clear();
+    sensorStages.reserve(stages.size());
+    this->streams[sensor].seed(this->seed, sensor);
+
+    for (const TSensorStageConfig &config : stages)
+    {
+        if (config.count <= 0 || config.first + config.count > SENSOR_CHANNEL_COUNT)
+        {
+            continue;
+        }
+
+        TStage stage = {};
+        stage.first = config.first;
+        stage.count = config.count;
+        stage.values = config.values;
+        stage.parameter = config.parameter;
+
+        switch (config.type)
+        {
+        case SENSOR_STAGE_BIAS:
+            stage.apply = &SensorPipeline::applyBias;
+            break;
+        case SENSOR_STAGE_SCALE:
+            stage.apply = &SensorPipeline::applyScale;
+            break;
+        case SENSOR_STAGE_NOISE:
+            stage.apply = &SensorPipeline::applyNoise;
+            break;
+        case SENSOR_STAGE_QUANTIZATION:
+            stage.apply = &SensorPipeline::applyQuantization;
+            break;
+        case SENSOR_STAGE_DELAY:
+            stage.historyLength = std::clamp(static_cast<int>(config.parameter), 1, SensorPipelineConstants::MAX_DELAY_CYCLES);
+            stage.history.resize(static_cast<size_t>(stage.historyLength) * stage.count);
+            stage.apply = &SensorPipeline::applyDelayFill;
+            break;
+        case SENSOR_STAGE_DROPOUT:
+            stage.apply = &SensorPipeline::applyDropout;
+            break;
+        case SENSOR_STAGE_STUCK:
+            stage.apply = &SensorPipeline::applyStuckCapture;
+            break;
+        case SENSOR_STAGE_DRIFT:
+            if (config.parameter <= 0.0f)
+            {
+                continue;
+            }
+            stage.apply = &SensorPipeline::applyDrift;
+            break;
+        }
+
+        sensorStages.push_back(std::move(stage));
+    }
+}
+
+void SensorPipeline::process(const TChannelValues &in, TChannelValues &out, double timeS)
+{
+    out = in;
+    float *values = out.data();
+
+    for (int sensor = 0; sensor < SENSOR_COUNT; sensor++)
+    {
+        TStageContext context = {timeS, this->streams[sensor]};
+        for (TStage &stage : this->stages[sensor])
+        {
+            stage.apply(stage, values, context);
+        }
+    }
+}
+
+void SensorPipeline::applyBias(TStage &stage, float *values, TStageContext &context)
+{
+    float *v = values + stage.first;
+    for (int i = 0; i < stage.count; i++)
+    {
+        v[i] += stage.values[i];
+    }
+}
+
+void SensorPipeline::applyScale(TStage &stage, float *values, TStageContext &context)
+{
+    float *v = values + stage.first;
+    for (int i = 0; i < stage.count; i++)
+    {
+        v[i] *= stage.values[i];
+    }
+}
+
+void SensorPipeline::applyNoise(TStage &stage, float *values, TStageContext &context)
+{
+    float *v = values + stage.first;
+    for (int i = 0; i < stage.count; i++)
+    {
+        v[i] += stage.values[i] * context.random.normal();
+    }
+}
+
+void SensorPipeline::applyQuantization(TStage &stage, float *values, TStageContext &context)
+{
+    float *v = values + stage.first;
+    for (int i = 0; i < stage.count; i++)
+    {
+        // A step of 0 leaves the channel untouched
+        const float step = stage.values[i] > 0.0f ? stage.values[i] : 1.0f;
+        const float quantized = roundf(v[i] / step) * step;
+        v[i] = stage.values[i] > 0.0f ? quantized : v[i];
+    }
+}
+
+// First cycle: the delay line starts filled with the current value instead of zeros
+void SensorPipeline::applyDelayFill(TStage &stage, float *values, TStageContext &context)
+{
+    for (int n = 0; n < stage.historyLength; n++)
+    {
+        std::copy_n(values + stage.first, stage.count, stage.history.begin() + n * stage.count);
+    }
+    stage.historyHead = 0;
+    stage.apply = &SensorPipeline::applyDelay;
+    applyDelay(stage, values, context);
+}
+
+void SensorPipeline::applyDelay(TStage &stage, float *values, TStageContext &context)
+{
+    float *slot = stage.history.data() + stage.historyHead * stage.count;
+    float *v = values + stage.first;
+    for (int i = 0; i < stage.count; i++)
+    {
+        const float delayed = slot[i];
+        slot[i] = v[i];
+        v[i] = delayed;
+    }
+    stage.historyHead = (stage.historyHead + 1) % stage.historyLength;
+}
+
+void SensorPipeline::applyDropout(TStage &stage, float *values, TStageContext &context)
+{
+    const bool drop = context.random.uniform() < stage.parameter;
+    float *v = values + stage.first;
+    for (int i = 0; i < stage.count; i++)
+    {
+        v[i] = drop ? stage.values[i] : v[i];
+    }
+}
+
+// First cycle: remember the current values, hold them from now on
+void SensorPipeline::applyStuckCapture(TStage &stage, float *values, TStageContext &context)
+{
+    std::copy_n(values + stage.first, stage.count, stage.values.begin());
+    stage.apply = &SensorPipeline::applyStuckHold;
+    applyStuckHold(stage, values, context);
+}
+
+void SensorPipeline::applyStuckHold(TStage &stage, float *values, TStageContext &context)
+{
+    std::copy_n(stage.values.begin(), stage.count, values + stage.first);
+}
+
+void SensorPipeline::applyDrift(TStage &stage, float *values, TStageContext &context)
+{
+    double phase = context.timeS / stage.parameter;
+    phase -= floor(phase);
+
+    float *v = values + stage.first;
+    for (int i = 0; i < stage.count; i++)
+    {
+        v[i] += stage.values[i] * static_cast<float>(phase);
+    }
+}
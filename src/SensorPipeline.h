@@ -0,0 +1,167 @@
+#pragma once
+
+#include "platform.h"
+
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+#include "core/RandomStream.h"
+
+// One float per channel, sensors own consecutive channels
+typedef enum
+{
+    SENSOR_CHANNEL_GPS_LATITUDE = 0,
+    SENSOR_CHANNEL_GPS_LONGITUDE,
+    SENSOR_CHANNEL_GPS_ELEVATION,
+    SENSOR_CHANNEL_GPS_SPEED,
+    SENSOR_CHANNEL_GPS_VEL_X,
+    SENSOR_CHANNEL_GPS_VEL_Y,
+    SENSOR_CHANNEL_GPS_VEL_Z,
+    SENSOR_CHANNEL_AIRSPEED,
+    SENSOR_CHANNEL_ACC_X,
+    SENSOR_CHANNEL_ACC_Y,
+    SENSOR_CHANNEL_ACC_Z,
+    SENSOR_CHANNEL_GYRO_X,
+    SENSOR_CHANNEL_GYRO_Y,
+    SENSOR_CHANNEL_GYRO_Z,
+    SENSOR_CHANNEL_MAG_X,
+    SENSOR_CHANNEL_MAG_Y,
+    SENSOR_CHANNEL_MAG_Z,
+    SENSOR_CHANNEL_BARO,
+    SENSOR_CHANNEL_RANGEFINDER,
+    SENSOR_CHANNEL_COUNT
+} TSensorChannel;
+
+typedef enum
+{
+    SENSOR_GPS = 0,
+    SENSOR_AIRSPEED,
+    SENSOR_ACC,
+    SENSOR_GYRO,
+    SENSOR_MAG,
+    SENSOR_BARO,
+    SENSOR_RANGEFINDER,
+    SENSOR_COUNT
+} TSensorType;
+
+typedef enum
+{
+    SENSOR_STAGE_BIAS,         // value + values[i]
+    SENSOR_STAGE_SCALE,        // value * values[i]
+    SENSOR_STAGE_NOISE,        // value + gaussian noise, sigma = values[i]
+    SENSOR_STAGE_QUANTIZATION, // rounded to a multiple of values[i]
+    SENSOR_STAGE_DELAY,        // value of parameter cycles ago, at most MAX_DELAY_CYCLES
+    SENSOR_STAGE_DROPOUT,      // replaced by values[i] with probability parameter
+    SENSOR_STAGE_STUCK,        // frozen at the first value after configuration
+    SENSOR_STAGE_DRIFT,        // value + values[i] * sawtooth with period parameter seconds
+} TSensorStageType;
+
+namespace SensorPipelineConstants
+{
+    static constexpr int MAX_SENSOR_CHANNELS = 7;
+    static constexpr int MAX_DELAY_CYCLES = 256;
+
+    struct TSensorChannels
+    {
+        TSensorChannel first;
+        int count;
+    };
+
+    // Indexed by TSensorType
+    static constexpr TSensorChannels SENSOR_CHANNELS[SENSOR_COUNT] = {
+        {SENSOR_CHANNEL_GPS_LATITUDE, 7},
+        {SENSOR_CHANNEL_AIRSPEED, 1},
+        {SENSOR_CHANNEL_ACC_X, 3},
+        {SENSOR_CHANNEL_GYRO_X, 3},
+        {SENSOR_CHANNEL_MAG_X, 3},
+        {SENSOR_CHANNEL_BARO, 1},
+        {SENSOR_CHANNEL_RANGEFINDER, 1},
+    };
+}
+
+// Description of one stage working on count consecutive channels starting at first
+struct TSensorStageConfig
+{
+    TSensorStageType type;
+    TSensorChannel first;
+    int count;
+    std::array<float, SensorPipelineConstants::MAX_SENSOR_CHANNELS> values;
+    float parameter;
+
+    static TSensorStageConfig Bias(TSensorChannel first, std::initializer_list<float> values);
+    static TSensorStageConfig Scale(TSensorChannel first, std::initializer_list<float> values);
+    static TSensorStageConfig Noise(TSensorChannel first, std::initializer_list<float> sigmas);
+    static TSensorStageConfig Quantization(TSensorChannel first, std::initializer_list<float> steps);
+    static TSensorStageConfig Delay(TSensorChannel first, int count, int cycles);
+    static TSensorStageConfig Dropout(TSensorChannel first, std::initializer_list<float> values, float probability);
+    static TSensorStageConfig Stuck(TSensorChannel first, int count);
+    static TSensorStageConfig Drift(TSensorChannel first, std::initializer_list<float> amplitudes, float periodS);
+};
+
+/**
+ * @brief Per sensor chains of error model stages, applied to all channels once per cycle.
+ *
+ * Stages are resolved to function pointers when a sensor is configured, so the
+ * per-cycle work is a flat loop over the configured stages without any checks for
+ * which failure or noise model is active. Sensors are configured independently,
+ * reconfiguring one sensor keeps the state (delay lines, frozen values) of the others.
+ * Every sensor draws from its own random stream, restarted from the seed when the
+ * sensor is configured, so the same seed and inputs reproduce a run exactly.
+ */
+class SensorPipeline
+{
+public:
+    typedef std::array<float, SENSOR_CHANNEL_COUNT> TChannelValues;
+
+    SensorPipeline();
+
+    // Takes effect for sensors configured afterwards
+    void setSeed(uint64_t seed);
+
+    void configure(TSensorType sensor, const std::vector<TSensorStageConfig> &stages);
+
+    // in and out may be the same
+    void process(const TChannelValues &in, TChannelValues &out, double timeS);
+
+private:
+    struct TStage;
+
+    struct TStageContext
+    {
+        double timeS;
+        RandomStream &random;
+    };
+
+    typedef void (*TStageFunction)(TStage &stage, float *values, TStageContext &context);
+
+    struct TStage
+    {
+        TStageFunction apply;
+        int first;
+        int count;
+        std::array<float, SensorPipelineConstants::MAX_SENSOR_CHANNELS> values;
+        float parameter;
+
+        // Delay line, count * delay cycles
+        std::vector<float> history;
+        int historyHead;
+        int historyLength;
+    };
+
+    uint64_t seed = 1;
+    std::array<std::vector<TStage>, SENSOR_COUNT> stages;
+    std::array<RandomStream, SENSOR_COUNT> streams;
+
+    static void applyBias(TStage &stage, float *values, TStageContext &context);
+    static void applyScale(TStage &stage, float *values, TStageContext &context);
+    static void applyNoise(TStage &stage, float *values, TStageContext &context);
+    static void applyQuantization(TStage &stage, float *values, TStageContext &context);
+    static void applyDelayFill(TStage &stage, float *values, TStageContext &context);
+    static void applyDelay(TStage &stage, float *values, TStageContext &context);
+    static void applyDropout(TStage &stage, float *values, TStageContext &context);
+    static void applyStuckCapture(TStage &stage, float *values, TStageContext &context);
+    static void applyStuckHold(TStage &stage, float *values, TStageContext &context);
+    static void applyDrift(TStage &stage, float *values, TStageContext &context);
+};
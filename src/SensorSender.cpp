@@ -0,0 +1,226 @@
+#include "SensorSender.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#if LIN
+#include <time.h>
+#include <errno.h>
+#endif
+
+#include "Utils.h"
+
+#if IBM && !defined(CREATE_WAITABLE_TIMER_HIGH_RESOLUTION)
+// Windows 10 1803 and later, missing in older SDK headers
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+namespace SensorSenderConstants
+{
+    static constexpr int64_t NS_PER_SECOND = 1000000000LL;
+#if !LIN
+    // Without clock_nanosleep the sleep ends this early and the rest is spun with yield(). The Windows
+    // high resolution timer and macOS nanosleep wake within a few hundred microseconds.
+    static constexpr int64_t SPIN_BEFORE_DEADLINE_NS = 500000LL;
+#endif
+}
+
+static int64_t monotonicNowNs()
+{
+#if LIN
+    struct timespec spec;
+    clock_gettime(CLOCK_MONOTONIC, &spec);
+    return static_cast<int64_t>(spec.tv_sec) * SensorSenderConstants::NS_PER_SECOND + spec.tv_nsec;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/**
+ * @brief Sleeps until an absolute monotonicNowNs() deadline, one instance per thread.
+ *
+ * Linux sleeps on the absolute deadline with clock_nanosleep. std::this_thread::sleep_until wakes
+ * on the system timer tick on Windows (1 - 15.6 ms), far too coarse for 100 - 500 Hz: Windows uses
+ * a high resolution waitable timer instead, Windows and macOS spin the last bit before the deadline.
+ */
+class PreciseSleeper
+{
+public:
+    PreciseSleeper()
+    {
+#if IBM
+        this->timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+        if (this->timer == nullptr)
+        {
+            // Before Windows 10 1803: timer tick resolution, the spin has to cover the rest
+            this->timer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+            Utils::LOG("Sensor sender: no high resolution timer, send timing will have up to a timer tick of jitter");
+        }
+#endif
+    }
+
+    ~PreciseSleeper()
+    {
+#if IBM
+        if (this->timer != nullptr)
+        {
+            CloseHandle(this->timer);
+        }
+#endif
+    }
+
+    void sleepUntilNs(int64_t deadlineNs)
+    {
+#if LIN
+        struct timespec spec;
+        spec.tv_sec = static_cast<time_t>(deadlineNs / SensorSenderConstants::NS_PER_SECOND);
+        spec.tv_nsec = static_cast<long>(deadlineNs % SensorSenderConstants::NS_PER_SECOND);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &spec, nullptr) == EINTR)
+        {
+        }
+#else
+        const int64_t sleepNs = deadlineNs - SensorSenderConstants::SPIN_BEFORE_DEADLINE_NS - monotonicNowNs();
+        if (sleepNs > 0)
+        {
+#if IBM
+            // Relative due time in 100 ns units
+            LARGE_INTEGER dueTime;
+            dueTime.QuadPart = -(sleepNs / 100);
+            if (this->timer != nullptr && SetWaitableTimer(this->timer, &dueTime, 0, nullptr, nullptr, FALSE))
+            {
+                WaitForSingleObject(this->timer, INFINITE);
+            }
+#else
+            std::this_thread::sleep_for(std::chrono::nanoseconds(sleepNs));
+#endif
+        }
+        while (monotonicNowNs() < deadlineNs)
+        {
+            std::this_thread::yield();
+        }
+#endif
+    }
+
+private:
+#if IBM
+    HANDLE timer = nullptr;
+#endif
+};
+
+SensorSender::SensorSender(SendCallback callback) : sendCallback(callback)
+{
+}
+
+SensorSender::~SensorSender()
+{
+    this->stop();
+}
+
+void SensorSender::start(int rateHz)
+{
+    this->stop();
+
+    this->rateHz = std::clamp(rateHz, SensorSenderConstants::MIN_RATE_HZ, SensorSenderConstants::MAX_RATE_HZ);
+    this->running.store(true, std::memory_order_release);
+    this->thread = std::thread(&SensorSender::run, this);
+
+    Utils::LOG("Sensor sender started at {} Hz", this->rateHz);
+}
+
+void SensorSender::stop()
+{
+    if (!this->thread.joinable())
+    {
+        return;
+    }
+
+    this->running.store(false, std::memory_order_release);
+    this->thread.join();
+
+    Utils::LOG("Sensor sender stopped");
+}
+
+void SensorSender::publish(const TSensorSnapshot &snapshot)
+{
+    this->snapshot.store(snapshot);
+}
+
+uint32_t SensorSender::getStatistics(TSensorSenderStatistics &statistics) const
+{
+    return this->statistics.load(statistics);
+}
+
+void SensorSender::run()
+{
+    const int64_t periodNs = SensorSenderConstants::NS_PER_SECOND / this->rateHz;
+    const int64_t windowNs = static_cast<int64_t>(SensorSenderConstants::STATISTICS_WINDOW_MS) * 1000000LL;
+
+    PreciseSleeper sleeper;
+    TSensorSnapshot current;
+    int64_t nextDeadline = monotonicNowNs() + periodNs;
+    int64_t lastSend = 0;
+    int64_t windowStart = monotonicNowNs();
+
+    int packets = 0;
+    int intervals = 0;
+    int overruns = 0;
+    double sumDeviation = 0.0;
+    double sumInterval = 0.0;
+    double sumIntervalSquared = 0.0;
+    double maxDeviation = 0.0;
+
+    while (this->running.load(std::memory_order_acquire))
+    {
+        sleeper.sleepUntilNs(nextDeadline);
+        const int64_t now = monotonicNowNs();
+
+        // Nothing published yet, keep the cadence but don't send
+        if (this->snapshot.getSequence() != 0)
+        {
+            this->snapshot.load(current);
+            this->sendCallback(current);
+            packets++;
+
+            if (lastSend != 0)
+            {
+                const double intervalUs = (now - lastSend) / 1000.0;
+                const double deviationUs = std::fabs(intervalUs - periodNs / 1000.0);
+                sumDeviation += deviationUs;
+                sumInterval += intervalUs;
+                sumIntervalSquared += intervalUs * intervalUs;
+                maxDeviation = std::max(maxDeviation, deviationUs);
+                intervals++;
+            }
+            lastSend = now;
+        }
+
+        nextDeadline += periodNs;
+        if (nextDeadline < now)
+        {
+            // Woke up more than a period late, don't try to catch up with a burst of packets
+            const int64_t missed = (now - nextDeadline) / periodNs + 1;
+            overruns += static_cast<int>(missed);
+            nextDeadline += missed * periodNs;
+        }
+
+        if (now - windowStart >= windowNs)
+        {
+            TSensorSenderStatistics stats = {};
+            stats.rateHz = static_cast<int>(std::lround(packets * 1.0e9 / (now - windowStart)));
+            stats.overruns = overruns;
+            if (intervals > 0)
+            {
+                const double mean = sumInterval / intervals;
+                stats.jitterMeanUs = static_cast<float>(sumDeviation / intervals);
+                stats.jitterStdDevUs = static_cast<float>(std::sqrt(std::max(0.0, sumIntervalSquared / intervals - mean * mean)));
+                stats.jitterMaxUs = static_cast<float>(maxDeviation);
+            }
+            this->statistics.store(stats);
+
+            windowStart = now;
+            packets = intervals = overruns = 0;
+            sumDeviation = sumInterval = sumIntervalSquared = maxDeviation = 0.0;
+        }
+    }
+}
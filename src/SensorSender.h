@@ -0,0 +1,62 @@
+#pragma once
+
+#include "platform.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+#include "core/SeqLock.h"
+#include "SimData.h"
+
+namespace SensorSenderConstants
+{
+    static constexpr int MIN_RATE_HZ = 100;
+    static constexpr int MAX_RATE_HZ = 500;
+    static constexpr int STATISTICS_WINDOW_MS = 1000;
+}
+
+struct TSensorSenderStatistics
+{
+    int rateHz;           // packets actually sent in the last window
+    float jitterMeanUs;   // mean absolute deviation of the send interval from the nominal period
+    float jitterStdDevUs; // standard deviation of the send interval
+    float jitterMaxUs;    // largest absolute deviation in the last window
+    int overruns;         // periods skipped because the thread woke up too late
+};
+
+/**
+ * @brief Sends sensor packets to the FC at a fixed rate from its own thread.
+ *
+ * The flight loop only publishes snapshots, the thread picks up the most recent
+ * one on every tick. The send callback is invoked from the sender thread.
+ */
+class SensorSender
+{
+public:
+    typedef std::function<void(const TSensorSnapshot &snapshot)> SendCallback;
+
+    SensorSender(SendCallback callback);
+    ~SensorSender();
+
+    void start(int rateHz);
+    void stop();
+    bool isRunning() const { return this->running.load(std::memory_order_acquire); }
+
+    void publish(const TSensorSnapshot &snapshot);
+
+    // Returns the sequence number of the statistics window, changes once per window
+    uint32_t getStatistics(TSensorSenderStatistics &statistics) const;
+
+private:
+    SendCallback sendCallback;
+    std::thread thread;
+    std::atomic<bool> running{false};
+    int rateHz = SensorSenderConstants::MIN_RATE_HZ;
+
+    SeqLock<TSensorSnapshot> snapshot;
+    SeqLock<TSensorSenderStatistics> statistics;
+
+    void run();
+};
@@ -6,7 +6,10 @@
 #include "core/EventBus.h"
 
 #include "settings/SettingNames.h"
+#include "settings/Settings.h"
 #include "SimData.h"
+#include "SensorSender.h"
+#include "SensorExtrapolator.h"
 
 #include <math.h>
 
@@ -19,12 +22,34 @@ struct BatteryData
 
 namespace SimDataConstants
 {
-    static constexpr unsigned int MSP_PERIOD_MS = 10u;
-    static constexpr int GPS_RATE_HZ = 5;
     static constexpr float GRAVITY_MSS = 9.80665f;
 
-    static constexpr int SITL_HEARTBEAT_TIMEOUT = 500; // 0.5 seconds
-    static constexpr float MAX_RANEGEFINDER_DISTANCE_CM = 1000.0f; // 10 meters
+    static constexpr int64_t SITL_HEARTBEAT_TIMEOUT_US = 500000; // 0.5 seconds
+    static constexpr int64_t ATTITUDE_ERROR_WINDOW_US = 1000000;
+    static constexpr int64_t AUTOLAUNCH_KICK_US = 1000000;
+    // Longer gaps between two FC updates are not shown in the update period graph
+    static constexpr int64_t MAX_UPDATE_PERIOD_US = 300000;
+    // Lockstep: X-Plane continues without the reply after this, counted as timeout
+    static constexpr int64_t LOCKSTEP_REPLY_TIMEOUT_US = 100000;
+    static constexpr int64_t LOCKSTEP_STATISTICS_WINDOW_US = 1000000;
+
+    static constexpr float METERS_TO_DEGREES = 1.0f / 111320.0f;
+    static constexpr float GPS_GLITCH_PERIOD_S = 100.0f;
+    static constexpr float PITOT_FAILURE_AIRSPEED = 17.77f; // 60 km/h
+
+    // Standard deviations for SENSOR_NOISE_LOW, SENSOR_NOISE_HIGH triples them
+    static constexpr float NOISE_GPS_POSITION_M = 1.5f;
+    static constexpr float NOISE_GPS_ELEVATION_M = 3.0f;
+    static constexpr float NOISE_GPS_VELOCITY_MS = 0.1f;
+    static constexpr float NOISE_AIRSPEED_MS = 0.3f;
+    static constexpr float NOISE_ACC_G = 0.01f;
+    static constexpr float NOISE_GYRO_DPS = 0.2f;
+    static constexpr float NOISE_MAG = 0.01f;
+    static constexpr float NOISE_BARO_INHG = 0.0015f; // ~5 Pa
+    static constexpr float NOISE_HIGH_FACTOR = 3.0f;
+    // Additional SENSOR_NOISE_HIGH errors
+    static constexpr int NOISE_HIGH_GPS_DELAY_CYCLES = 20;
+    static constexpr float NOISE_HIGH_MAG_RESOLUTION = 0.01f;
 
     static const std::map<BatteryEmulationType, BatteryData> BATTERY_DATA = {
         {BATTERY_NONE, {Lipo, 0.0, 0}},
@@ -65,8 +90,6 @@ namespace SimDataConstants
 
 SimData::SimData() : isHitlConnected(false)
 {
-    this->gps_lastUpdate = Utils::GetTicks() - 1000;
-    this->sitlHartbeatLastTime = Utils::GetTicks() - 1000;
     this->GPSHasNewData = false;
 
     this->gps_fix = SimDataConstants::GPS_FIX_3D;
@@ -76,42 +99,9 @@ SimData::SimData() : isHitlConnected(false)
 
     this->simulate_mag_failure = false;
 
-    this->df_latitude = XPLMFindDataRef("sim/flightmodel/position/latitude");
-    this->df_longitude = XPLMFindDataRef("sim/flightmodel/position/longitude");
-    this->df_elevation = XPLMFindDataRef("sim/flightmodel/position/elevation");
-    this->df_agl = XPLMFindDataRef("sim/flightmodel/position/y_agl");
-
-    this->df_local_vx = XPLMFindDataRef("sim/flightmodel/position/local_vx");
-    this->df_local_vy = XPLMFindDataRef("sim/flightmodel/position/local_vy");
-    this->df_local_vz = XPLMFindDataRef("sim/flightmodel/position/local_vz");
-
-    this->df_speed = XPLMFindDataRef("sim/flightmodel/position/groundspeed");
-    this->df_airspeed = XPLMFindDataRef("sim/flightmodel/position/true_airspeed");
-
-    this->df_roll = XPLMFindDataRef("sim/flightmodel/position/phi");
-    this->df_pitch = XPLMFindDataRef("sim/flightmodel/position/theta");
-    this->df_yaw = XPLMFindDataRef("sim/flightmodel/position/psi");
-    this->df_hpath = XPLMFindDataRef("sim/flightmodel/position/hpath");
-
-    // Accelerometer
-    this->df_accel_x = XPLMFindDataRef("sim/flightmodel/forces/g_axil");
-    this->df_accel_y = XPLMFindDataRef("sim/flightmodel/forces/g_side");
-    this->df_accel_z = XPLMFindDataRef("sim/flightmodel/forces/g_nrml");
-
-    // Gyro
-    this->df_gyro_x = XPLMFindDataRef("sim/flightmodel/position/P");
-    this->df_gyro_y = XPLMFindDataRef("sim/flightmodel/position/Q");
-    this->df_gyro_z = XPLMFindDataRef("sim/flightmodel/position/R");
-
-    // Barometer
-    this->df_baro = XPLMFindDataRef("sim/weather/barometer_current_inhg");
-
-    // RC Inputs
-    this->df_rc_inputs = XPLMFindDataRef("sim/joystick/joy_mapped_axis_value");
-
-    // Our own Dataref to get INAVs heartbeat in SITL mode
-    this->df_heartbeat = XPLMFindDataRef("inav_xitl/plugin/heartbeat");
-
+    this->xplane = {};
+    this->xplane.simSpeed = 1.0f;
+    std::fill(std::begin(this->rc_inputs), std::end(this->rc_inputs), 0.0f);
 
     // // Velocity
     // xPlane.requestDataRef('sim/flightmodel/forces/vx_acf_axis', 10, function (ref, value) {
@@ -130,8 +120,7 @@ SimData::SimData() : isHitlConnected(false)
 
     this->simulatePitot = TPitotSimulation::Simulate;
     this->simDataFromXplane.airspeed = 0;
-    this->agl = 0;
-    this->sitlHartbeatLastTime = 0;
+    this->sitlHartbeatLastTimeUs = 0;
     this->isSitlConnected = false;
     this->isSitlTcpConnected = false;
 
@@ -140,14 +129,7 @@ SimData::SimData() : isHitlConnected(false)
     this->attitude_use_sensors = false;
     this->control_throttle = -500;
 
-    this->lastUpdateMS = this->lastUpdateTimeFlightLoop = 0;
-
-    this->df_hasJoystick = XPLMFindDataRef("sim/joystick/has_joystick");
-    this->df_override_joystick = XPLMFindDataRef("sim/operation/override/override_joystick");
-    this->df_control_throttle = XPLMFindDataRef("sim/cockpit2/engine/actuators/throttle_ratio_all");
-    this->df_control_roll = XPLMFindDataRef("sim/joystick/yoke_roll_ratio");
-    this->df_control_pitch = XPLMFindDataRef("sim/joystick/yoke_pitch_ratio");
-    this->df_control_yaw = XPLMFindDataRef("sim/joystick/yoke_heading_ratio");
+    this->lastUpdateUs = 0;
 
     this->isAirplane = false;
     this->isArmed = false;
@@ -156,28 +138,92 @@ SimData::SimData() : isHitlConnected(false)
 
     this->setBateryEmulation(BATTERY_3S_LION_INFINITE);
 
+    this->rangefinderSimulation = RANGEFINDER_NONE;
+    this->simDataOut = this->simDataFromXplane;
+    this->configureSensorPipeline();
+    this->configureGpsReceiver();
+
+    fs::path magneticGridFileName = Utils::GetPluginDirectory() / "assets" / "wmm_grid.bin";
+    if (this->magneticModel.load(magneticGridFileName.string()))
+    {
+        Utils::LOG("Magnetic model: loaded {}, epoch {:.1f}", magneticGridFileName.string(), this->magneticModel.getDecimalYear());
+    }
+    else
+    {
+        Utils::LOG("Magnetic model: {} not found, using built-in model for {:.1f}", magneticGridFileName.string(), this->magneticModel.getDecimalYear());
+    }
+
+    this->loadPowerTrainCatalog();
+    // The settings file has lower case section names
+    this->aircraftSection = Utils::ToLower(SettingsSections::SECTION_AIRCRAFT_PREFIX + Utils::GetAircraftName());
+
     auto eventBus = Plugin()->GetEventBus();
 
+    // Runs on the sender thread: only touches the snapshot and the MSP connection, never SimData state
+    this->sensorSender = std::make_unique<SensorSender>(
+        [msp = Plugin()->MSP(), lastGpsSequence = uint32_t(0), extrapolator = SensorExtrapolator()](const TSensorSnapshot &snapshot) mutable
+        {
+            const bool hasNewGpsData = snapshot.gpsSequence != lastGpsSequence;
+            lastGpsSequence = snapshot.gpsSequence;
+
+            TSensorSnapshot sample = snapshot;
+            if (snapshot.extrapolate)
+            {
+                extrapolator.extrapolate(sample, Clock::NowUs());
+            }
+            else
+            {
+                extrapolator.reset();
+            }
+
+            TMSPSimulatorToINAV data = SensorPacket::encode(sample, hasNewGpsData);
+
+            std::vector<uint8_t> msp_message_buffer = std::vector<uint8_t>(sizeof(data));
+            std::memcpy(msp_message_buffer.data(), &data, sizeof(data));
+
+            msp->sendCommandImmediate(MSP_SIMULATOR, msp_message_buffer);
+        });
+
     eventBus->Subscribe<FlightLoopEventArg>(
         "FlightLoop",
         [this](const FlightLoopEventArg &event)
         {
-            if ((Utils::GetTicks() - this->lastUpdateTimeFlightLoop) > SimDataConstants::MSP_PERIOD_MS)
+            this->updateFromXPlane();
+            this->runSensorPipeline();
+
+            this->updateDataRefs();
+
+            if (this->isHitlConnected)
+            {
+                this->sendToINAV_HITL();
+            } 
+            else if (this->isSitlConnected)
             {
-                this->updateFromXPlane();
-                this->updateDataRefs();
+                
+                this->sendToINAV_SITL();
+            }
 
-                if (this->isHitlConnected)
-                {
-                    this->sendToINAV_HITL();
-                } 
-                else if (this->isSitlConnected)
-                {
-                    
-                    this->sendToINAV_SITL();
-                }
-                this->lastUpdateMS = Utils::GetTicks();
+            // Same condition as the send path above, without a packet there is no reply to wait for
+            if (this->lockstep && (this->isHitlConnected || (this->isSitlConnected && this->isSitlTcpConnected)))
+            {
+                // The reply is processed in here, the control outputs are flushed below in the same cycle
+                this->waitForLockstepReply();
             }
+            this->lastUpdateUs = Clock::NowUs();
+
+            this->publishSensorSenderStatistics();
+
+            // MSP replies of this frame have already been processed, so every dataref is written once
+            const auto flushStart = std::chrono::steady_clock::now();
+            this->dataRefs.flush();
+            const auto cycleEnd = std::chrono::steady_clock::now();
+
+            Plugin()->GetEventBus()->Publish<SimDataCycleEventArg>(
+                "SimDataCycle",
+                SimDataCycleEventArg(
+                    this->dataRefReadTimeUs + std::chrono::duration<float, std::micro>(cycleEnd - flushStart).count(),
+                    this->dataRefs.getReadCallsLastCycle(),
+                    this->dataRefs.getWriteCallsLastFlush()));
         });
 
     eventBus->Subscribe<SimulatorConnectedEventArg>(
@@ -190,6 +236,13 @@ SimData::SimData() : isHitlConnected(false)
                 this->isHitlConnected = true;
                 this->rxIsFailsafe = false;
                 this->rxIsFailsafeFromMenu = false;
+                // Every connection starts with the same noise sequence
+                this->configureSensorPipeline();
+                this->configureGpsReceiver();
+                this->resetLockstepStatistics();
+                this->debugAssembler.reset();
+                this->resetAttitudeErrorFlight();
+                this->updateSensorSender();
             }
             else if (event.status == ConnectionStatus::ConnectedSitl)
             {
@@ -201,13 +254,24 @@ SimData::SimData() : isHitlConnected(false)
                 
                 this->setBateryEmulation(this->batEmulation);
                 this->isSitlTcpConnected = true;
+                this->resetLockstepStatistics();
+                this->debugAssembler.reset();
+                this->resetAttitudeErrorFlight();
                 this->rxIsFailsafe = false;
                 this->rxIsFailsafeFromMenu = false;
             }
             else
             {
+                // Disconnected in flight, the FC won't report the disarm
+                if (this->isArmed)
+                {
+                    this->writeAttitudeErrorSummary();
+                    this->resetAttitudeErrorFlight();
+                }
                 this->isHitlConnected = false;
                 this->isSitlTcpConnected = false;
+                this->resetLockstepStatistics();
+                this->updateSensorSender();
                 this->disconnect();
             }
         });
@@ -280,26 +344,54 @@ SimData::SimData() : isHitlConnected(false)
         "SettingsChanged",
         [this](const SettingsChangedEventArg &event)
         {
-            if (event.sectionName != SettingsSections::SECTION_SIMDATA)
+            if (Utils::ToLower(event.sectionName) == this->aircraftSection)
             {
-                return;
-            }
-
-            if (event.settingName == SettingsKeys::SETTINGS_GPS_NUMSAT)
-            {
-                this->simDataFromXplane.numSats = event.getValueAs<int>(12);
-                if (this->simDataFromXplane.numSats == 0)
+                if (event.settingName == SettingsKeys::SETTINGS_AIRCRAFT_MOTOR)
                 {
-                    this->gps_fix = SimDataConstants::GPS_NO_FIX;
+                    this->aircraftMotor = event.value;
                 }
-                else if (this->simDataFromXplane.numSats < 4)
+                else if (event.settingName == SettingsKeys::SETTINGS_AIRCRAFT_PROPELLER)
                 {
-                    this->gps_fix = SimDataConstants::GPS_FIX_2D;
+                    this->aircraftPropeller = event.value;
                 }
-                else
+                else if (event.settingName == SettingsKeys::SETTINGS_AIRCRAFT_BATTERY_PACK)
                 {
-                    this->gps_fix = SimDataConstants::GPS_FIX_3D;
+                    this->aircraftBatteryPack = event.value;
                 }
+                this->setBateryEmulation(this->batEmulation);
+                return;
+            }
+
+            if (event.sectionName != SettingsSections::SECTION_SIMDATA)
+            {
+                return;
+            }
+
+            if (event.settingName == SettingsKeys::SETTINGS_GPS_NUMSAT)
+            {
+                this->gpsNumSats = event.getValueAs<int>(12);
+                this->simDataFromXplane.numSats = this->gpsNumSats;
+                this->gps_fix = SimData::gpsFixFromSatellites(this->gpsNumSats);
+                this->configureGpsReceiver();
+            }
+            else if (event.settingName == SettingsKeys::SETTINGS_GPS_RATE_HZ)
+            {
+                this->gpsRateHz = event.getValueAs<int>(GpsReceiverConstants::DEFAULT_RATE_HZ);
+                this->configureGpsReceiver();
+            }
+            else if (event.settingName == SettingsKeys::SETTINGS_GPS_LATENCY_MS)
+            {
+                this->gpsLatencyMs = event.getValueAs<int>(0);
+                this->configureGpsReceiver();
+            }
+            else if (event.settingName == SettingsKeys::SETTINGS_GPS_JITTER_MS)
+            {
+                this->gpsJitterMs = event.getValueAs<int>(0);
+                this->configureGpsReceiver();
+            }
+            else if (event.settingName == SettingsKeys::SETTINGS_GPS_SEND_VELOCITIES)
+            {
+                this->gpsSendVelocities = event.getValueAs<bool>(true);
             }
             else if (event.settingName == SettingsKeys::SETTINGS_GPS_TIMEOUT)
             {
@@ -308,10 +400,12 @@ SimData::SimData() : isHitlConnected(false)
             else if (event.settingName == SettingsKeys::SETTINGS_GPS_GLITCH)
             {
                 this->gps_glitch = event.getValueAs<int>(0);
+                this->configureSensorPipeline(SENSOR_GPS);
             }
             else if (event.settingName == SettingsKeys::SETTINGS_MAG_FAILURE)
             {
                 this->simulate_mag_failure = event.getValueAs<bool>(false);
+                this->configureSensorPipeline(SENSOR_MAG);
             }
             else if (event.settingName == SettingsKeys::SETTINGS_ATTITUDE_COPY_FROM_XPLANE)
             {
@@ -329,17 +423,86 @@ SimData::SimData() : isHitlConnected(false)
             else if (event.settingName == SettingsKeys::SETTINGS_SIMULATE_PITOT)
             {
                 this->simulatePitot = event.getValueAs<TPitotSimulation>(None);
+                this->configureSensorPipeline(SENSOR_AIRSPEED);
             }
             else if (event.settingName == SettingsKeys::SETTINGS_SIMULATE_RANGEFINDER)
             {
                 this->rangefinderSimulation = event.getValueAs<TRangefinderSimulation>(RANGEFINDER_NONE);
+                this->rangefinder.reset();
+                this->configureSensorPipeline(SENSOR_RANGEFINDER);
+            }
+            else if (event.settingName == SettingsKeys::SETTINGS_DEBUG_INTERPOLATION)
+            {
+                this->debugAssembler.setMode(event.getValueAs<bool>(false) ? DEBUG_ASSEMBLY_INTERPOLATE : DEBUG_ASSEMBLY_HOLD);
+            }
+            else if (event.settingName == SettingsKeys::SETTINGS_RANGEFINDER_RATE_HZ)
+            {
+                this->rangefinderRateHz = event.getValueAs<int>(RangefinderConstants::DEFAULT_RATE_HZ);
+                this->rangefinder.configure(this->rangefinderRateHz);
             }
             else if (event.settingName == SettingsKeys::SETTINGS_RSSI_SIMULATION)
             {
                 this->rxRangeKm = event.getValueAs<float>(SimDataConstants::RSSI_INFINITE_RANGE);
+                this->terrainLineOfSight.reset();
+            }
+            else if (event.settingName == SettingsKeys::SETTINGS_RSSI_TERRAIN)
+            {
+                this->rssiTerrain = event.getValueAs<bool>(true);
+                this->terrainLineOfSight.reset();
+            }
+            else if (event.settingName == SettingsKeys::SETTINGS_SENSOR_RATE_HZ)
+            {
+                this->sensorRateHz = event.getValueAs<int>(0);
+                this->updateSensorSender();
+            }
+            else if (event.settingName == SettingsKeys::SETTINGS_SENSOR_EXTRAPOLATION)
+            {
+                this->sensorExtrapolation = event.getValueAs<bool>(false);
+            }
+            else if (event.settingName == SettingsKeys::SETTINGS_SENSOR_NOISE)
+            {
+                this->sensorNoise = event.getValueAs<int>(SimDataConstants::SENSOR_NOISE_OFF);
+                this->configureSensorPipeline();
+                this->configureGpsReceiver();
+            }
+            else if (event.settingName == SettingsKeys::SETTINGS_LOCKSTEP)
+            {
+                this->lockstep = event.getValueAs<bool>(false);
+                // The sensor timing models change between wall and sim clock, see modelTimeUs()
+                this->gpsReceiver.reset();
+                this->rangefinder.reset();
+                this->resetLockstepStatistics();
+                this->updateSensorSender();
+            }
+            else if (event.settingName == SettingsKeys::SETTINGS_SENSOR_NOISE_SEED)
+            {
+                this->sensorNoiseSeed = event.getValueAs<uint64_t>(1);
+                this->sensorPipeline.setSeed(this->sensorNoiseSeed);
+                this->configureSensorPipeline();
+                this->configureGpsReceiver();
             }
         });
 
+    eventBus->Subscribe(
+        "AirportLoaded",
+        [this]()
+        {
+            // New scenery, cached terrain may be stale
+            this->terrainLineOfSight.clearCache();
+            this->terrainLineOfSight.reset();
+            this->rangefinder.reset();
+            this->selectAircraftPowerTrain();
+        }
+    );
+
+    eventBus->Subscribe(
+        "PlaneLoaded",
+        [this]()
+        {
+            this->selectAircraftPowerTrain();
+        }
+    );
+
     eventBus->Subscribe(
         "MenuRssiToggleFailsafe", 
         [this]()
@@ -349,52 +512,119 @@ SimData::SimData() : isHitlConnected(false)
         }
     );
 
+    eventBus->Subscribe(
+        "PluginDisabled",
+        [this]()
+        {
+            this->sensorSender->stop();
+            this->stopTraceRecording();
+        }
+    );
+
+    eventBus->Subscribe(
+        "MenuRecordTrace",
+        [this]()
+        {
+            if (this->traceWriter.isOpen())
+            {
+                this->stopTraceRecording();
+            }
+            else
+            {
+                this->startTraceRecording();
+            }
+        }
+    );
+
     eventBus->Subscribe(
         "MenuKickStartAutolaunch", 
         [this]()
         { 
-            this->autolaunch_kickStart = Utils::GetTicks();
+            // 0 means no kick
+            this->autolaunch_kickStartUs = std::max<int64_t>(this->simClock.nowUs(), 1);
         }
     );
 }
 
+SimData::~SimData()
+{
+    this->sensorSender->stop();
+    this->traceWriter.close();
+}
+
 void SimData::updateFromXPlane()
 {
     static bool firstUpdate = true;
 
     auto eventBus = Plugin()->GetEventBus();
-    uint32_t t = Utils::GetTicks();
+    const int64_t t = Clock::NowUs();
+    // Paused and sim speed are from the previous cycle, the sensor models below need this cycle's time
+    this->simClock.update(t, this->xplane.paused != 0, this->xplane.simSpeed);
+    const int64_t modelT = this->modelTimeUs();
+
+    const bool gpsSample = this->gpsReceiver.isSampleDue(modelT);
+    const bool rangefinderSample = this->rangefinderSimulation != RANGEFINDER_NONE && this->rangefinder.isSampleDue(modelT);
+
+    uint32_t groups = DATAREF_GROUP_FRAME;
+    if (gpsSample)
+    {
+        groups |= DATAREF_GROUP_GPS;
+    }
+    if (rangefinderSample)
+    {
+        groups |= DATAREF_GROUP_RANGEFINDER;
+    }
+    if (this->isHitlConnected)
+    {
+        groups |= DATAREF_GROUP_RC;
+    }
+
+    const auto readStart = std::chrono::steady_clock::now();
+    this->dataRefs.read(this->xplane, groups);
+    this->dataRefReadTimeUs = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - readStart).count();
+    this->xplaneSampleTimeUs = Clock::NowUs();
 
     // SITL sets heartbeat dataref to a positive value every sitl update cycle
-    const int heartbeat = XPLMGetDatai(this->df_heartbeat);
+    const int heartbeat = this->xplane.heartbeat;
     if (heartbeat >= 1)
     {
         this->isSitlConnected = true;
-        this->sitlHartbeatLastTime = t;
-        XPLMSetDatai(this->df_heartbeat, 0);
+        this->sitlHartbeatLastTimeUs = t;
+        this->dataRefs.setInt(DATAREF_WRITE_HEARTBEAT, 0);
     }
     
-    if (heartbeat == 0 && (t - this->sitlHartbeatLastTime) > SimDataConstants::SITL_HEARTBEAT_TIMEOUT)
+    if (heartbeat == 0 && (t - this->sitlHartbeatLastTimeUs) > SimDataConstants::SITL_HEARTBEAT_TIMEOUT_US)
     {
         this->isSitlConnected = false;
     }
     
-    if ((t - this->gps_lastUpdate) >= (1000 / SimDataConstants::GPS_RATE_HZ))
+    if (gpsSample)
     {
-        this->gps_lastUpdate = t;
-        this->GPSHasNewData = true;
+        this->simDataFromXplane.airspeed = this->xplane.airspeed;
+
+        // X-Plane local OpenGL frame: x east, y up, z south
+        TGpsMeasurement measurement;
+        measurement.latitude = this->xplane.latitude;
+        measurement.longitude = this->xplane.longitude;
+        measurement.elevation = this->xplane.elevation;
+        measurement.velNED = {-this->xplane.local_vz, this->xplane.local_vx, -this->xplane.local_vy};
+        this->gpsReceiver.addMeasurement(measurement, modelT);
+    }
 
-        this->simDataFromXplane.latitude = XPLMGetDatad(this->df_latitude);
-        this->simDataFromXplane.longitude = XPLMGetDatad(this->df_longitude);
-        this->simDataFromXplane.elevation = XPLMGetDatad(this->df_elevation);
-        this->agl = XPLMGetDataf(this->df_agl);
+    TGpsSolution gpsSolution;
+    if (this->gpsReceiver.update(modelT, gpsSolution))
+    {
+        this->GPSHasNewData = true;
 
-        this->simDataFromXplane.velNED.x = XPLMGetDataf(this->df_local_vx);
-        this->simDataFromXplane.velNED.y = XPLMGetDataf(this->df_local_vy);
-        this->simDataFromXplane.velNED.z = XPLMGetDataf(this->df_local_vz);
-        this->simDataFromXplane.speed = XPLMGetDataf(this->df_speed);
-        this->simDataFromXplane.airspeed = XPLMGetDataf(this->df_airspeed);
-        this->simDataFromXplane.course = XPLMGetDataf(this->df_hpath);
+        this->simDataFromXplane.latitude = gpsSolution.latitude;
+        this->simDataFromXplane.longitude = gpsSolution.longitude;
+        this->simDataFromXplane.elevation = gpsSolution.elevation;
+        this->simDataFromXplane.velNED = gpsSolution.velNED;
+        this->simDataFromXplane.speed = gpsSolution.speed;
+        this->simDataFromXplane.course = gpsSolution.course;
+        this->simDataFromXplane.numSats = gpsSolution.numSats;
+        this->gps_fix = SimData::gpsFixFromSatellites(gpsSolution.numSats);
+        this->gpsHdop = gpsSolution.hdop;
 
         if (firstUpdate)
         {
@@ -403,59 +633,75 @@ void SimData::updateFromXPlane()
         }
     }
 
-    if (agl > 0.0f && agl * 100 < SimDataConstants::MAX_RANEGEFINDER_DISTANCE_CM)
+    if (rangefinderSample)
+    {
+        this->rangefinder.measure({this->xplane.local_x, this->xplane.local_y, this->xplane.local_z, this->xplane.roll, this->xplane.pitch, this->xplane.yaw}, modelT);
+    }
+
+    const float rangefinderDistance = this->rangefinder.getDistanceM();
+    if (rangefinderDistance != RangefinderConstants::OUT_OF_RANGE)
     {
-        this->simDataFromXplane.rangefinder_distance_cm = roundf(this->agl * 100.0f);
+        this->simDataFromXplane.rangefinder_distance_cm = roundf(rangefinderDistance * 100.0f);
     }
     else
     {
         this->simDataFromXplane.rangefinder_distance_cm = 0xffff; // out of range
     }
 
-    this->simDataFromXplane.euler.roll = XPLMGetDataf(this->df_roll);
-    this->simDataFromXplane.euler.pitch = XPLMGetDataf(this->df_pitch);
-    this->simDataFromXplane.euler.yaw = XPLMGetDataf(this->df_yaw);
+    if (this->rssiTerrain && this->homeLocation_isSet && this->rxRangeKm != SimDataConstants::RSSI_INFINITE_RANGE)
+    {
+        this->terrainLineOfSight.update(
+            {this->homeLocation_latitude, this->homeLocation_longitude, this->homeLocation_elevation},
+            {this->xplane.latitude, this->xplane.longitude, this->xplane.elevation});
+    }
+
+    this->simDataFromXplane.euler.roll = this->xplane.roll;
+    this->simDataFromXplane.euler.pitch = this->xplane.pitch;
+    this->simDataFromXplane.euler.yaw = this->xplane.yaw;
 
     eventBus->Publish<Double3DPointEventArg>("UpdatePosition", Double3DPointEventArg(this->simDataFromXplane.latitude, this->simDataFromXplane.longitude, this->simDataFromXplane.elevation));
     eventBus->Publish<FloatEventArg>("UpdateRoll", FloatEventArg(this->simDataFromXplane.euler.roll));
     float kick = 0;
-    if (this->autolaunch_kickStart != 0)
+    if (this->autolaunch_kickStartUs != 0)
     {
-        uint32_t dt = t - this->autolaunch_kickStart;
-        if (dt > 1000)
+        const int64_t dt = this->simClock.nowUs() - this->autolaunch_kickStartUs;
+        if (dt > SimDataConstants::AUTOLAUNCH_KICK_US)
         {
-            this->autolaunch_kickStart = 0;
+            this->autolaunch_kickStartUs = 0;
         }
         else
         {
-            kick = 4 * sin(dt / 180.0f * std::numbers::pi);
+            kick = 4 * sin(dt / 1000.0f / 180.0f * std::numbers::pi);
         }
     }
-    this->simDataFromXplane.acceleration.x = XPLMGetDataf(this->df_accel_x) + kick;
-    this->simDataFromXplane.acceleration.y = XPLMGetDataf(this->df_accel_y);
-    this->simDataFromXplane.acceleration.z = XPLMGetDataf(this->df_accel_z);
-
-    this->simDataFromXplane.gyro.x = XPLMGetDataf(this->df_gyro_x);
-    this->simDataFromXplane.gyro.y = XPLMGetDataf(this->df_gyro_y);
-    this->simDataFromXplane.gyro.z = XPLMGetDataf(this->df_gyro_z);
-    this->simDataFromXplane.baro = XPLMGetDataf(this->df_baro);
-
-    vector3D north = {1.0, 0.0, 0.0};
+    this->simDataFromXplane.acceleration.x = this->xplane.accel_x + kick;
+    this->simDataFromXplane.acceleration.y = this->xplane.accel_y;
+    this->simDataFromXplane.acceleration.z = this->xplane.accel_z;
+
+    this->simDataFromXplane.gyro.x = this->xplane.gyro_p;
+    this->simDataFromXplane.gyro.y = this->xplane.gyro_q;
+    this->simDataFromXplane.gyro.z = this->xplane.gyro_r;
+    this->simDataFromXplane.baro = this->xplane.baro;
+
+    // transformVectorEarthToBody expects down negated, see MathUtils
+    const TMagneticField field = this->magneticModel.lookup(this->xplane.latitude, this->xplane.longitude);
+    const vector3D fieldNED = MagneticModel::getFieldVectorNED(field);
+    this->magDeclination = field.declination;
     quaternion quat = computeQuaternionFromEuler(this->simDataFromXplane.euler);
-    this->simDataFromXplane.mag = transformVectorEarthToBody(north, quat);
+    this->simDataFromXplane.mag = transformVectorEarthToBody({fieldNED.x, fieldNED.y, -fieldNED.z}, quat);
 
     if (this->isHitlConnected)
     {
     
-        this->hasJoystick = XPLMGetDatai(this->df_hasJoystick) != 0;      
-        XPLMGetDatavf(this->df_rc_inputs, &this->rc_inputs[SimDataConstants::RC_CHANNEL_PITCH], 1, 1);
-        XPLMGetDatavf(this->df_rc_inputs, &this->rc_inputs[SimDataConstants::RC_CHANNEL_ROLL], 2, 1);
-        XPLMGetDatavf(this->df_rc_inputs, &this->rc_inputs[SimDataConstants::RC_CHANNEL_YAW], 3, 1);
-        XPLMGetDatavf(this->df_rc_inputs, &this->rc_inputs[SimDataConstants::RC_CHANNEL_THROTTLE], 57, 1);
-        XPLMGetDatavf(this->df_rc_inputs, &this->rc_inputs[SimDataConstants::RC_CHANNEL_AUX1], 58, 1);
-        XPLMGetDatavf(this->df_rc_inputs, &this->rc_inputs[SimDataConstants::RC_CHANNEL_AUX2], 59, 1);
-        XPLMGetDatavf(this->df_rc_inputs, &this->rc_inputs[SimDataConstants::RC_CHANNEL_AUX3], 60, 1);
-        XPLMGetDatavf(this->df_rc_inputs, &this->rc_inputs[SimDataConstants::RC_CHANNEL_AUX4], 61, 1);
+        this->hasJoystick = this->xplane.hasJoystick != 0;
+        this->rc_inputs[SimDataConstants::RC_CHANNEL_PITCH] = this->xplane.joyAttitude[0];
+        this->rc_inputs[SimDataConstants::RC_CHANNEL_ROLL] = this->xplane.joyAttitude[1];
+        this->rc_inputs[SimDataConstants::RC_CHANNEL_YAW] = this->xplane.joyAttitude[2];
+        this->rc_inputs[SimDataConstants::RC_CHANNEL_THROTTLE] = this->xplane.joyThrottleAux[0];
+        this->rc_inputs[SimDataConstants::RC_CHANNEL_AUX1] = this->xplane.joyThrottleAux[1];
+        this->rc_inputs[SimDataConstants::RC_CHANNEL_AUX2] = this->xplane.joyThrottleAux[2];
+        this->rc_inputs[SimDataConstants::RC_CHANNEL_AUX3] = this->xplane.joyThrottleAux[3];
+        this->rc_inputs[SimDataConstants::RC_CHANNEL_AUX4] = this->xplane.joyThrottleAux[4];
     }
 
     eventBus->Publish<EulerAnglesEventArgs>(
@@ -492,18 +738,18 @@ float SimData::getControllThrottle() const
 
 void SimData::sendToXPlane_HITL()
 {
-    XPLMSetDatai(this->df_override_joystick, 1);
-    XPLMSetDataf(this->df_control_throttle, getControllThrottle());
-    XPLMSetDataf(this->df_control_roll, SimDataConstants::input_to_float_minus_1_1(this->control_roll));
-    XPLMSetDataf(this->df_control_pitch, -SimDataConstants::input_to_float_minus_1_1(this->control_pitch));
-    XPLMSetDataf(this->df_control_yaw, -SimDataConstants::input_to_float_minus_1_1(this->control_yaw));
+    this->dataRefs.setInt(DATAREF_WRITE_OVERRIDE_JOYSTICK, 1);
+    this->dataRefs.setFloat(DATAREF_WRITE_THROTTLE, getControllThrottle());
+    this->dataRefs.setFloat(DATAREF_WRITE_ROLL, SimDataConstants::input_to_float_minus_1_1(this->control_roll));
+    this->dataRefs.setFloat(DATAREF_WRITE_PITCH, -SimDataConstants::input_to_float_minus_1_1(this->control_pitch));
+    this->dataRefs.setFloat(DATAREF_WRITE_YAW, -SimDataConstants::input_to_float_minus_1_1(this->control_yaw));
 }
 
 void SimData::sendToXPlane_SITL()
 {
     // In SITL mode we just send the throttle command, other controls are handled by INAV itself
-    XPLMSetDatai(this->df_override_joystick, 1);
-    XPLMSetDataf(this->df_control_throttle, getControllThrottle());
+    this->dataRefs.setInt(DATAREF_WRITE_OVERRIDE_JOYSTICK, 1);
+    this->dataRefs.setFloat(DATAREF_WRITE_THROTTLE, getControllThrottle());
 }
 
 void SimData::updateFromINAV(const TMSPSimulatorFromINAV &data)
@@ -527,7 +773,15 @@ void SimData::updateFromINAV(const TMSPSimulatorFromINAV &data)
     {
         Utils::DisableBrakes();
         eventBus->Publish<Double3DPointEventArg>("UpdateHomeLocation", Double3DPointEventArg(this->simDataFromXplane.latitude, this->simDataFromXplane.longitude, this->simDataFromXplane.elevation));
+        this->resetAttitudeErrorFlight();
     }
+    else if (!this->isArmed && prevArmed)
+    {
+        this->writeAttitudeErrorSummary();
+    }
+
+    this->updateAttitudeEstimationError(data);
+    this->recordTraceReply(data);
 
     eventBus->Publish<Vector3EventArgs>(
         "AddEstimatedAttitudeYPR",
@@ -545,23 +799,23 @@ void SimData::updateFromINAV(const TMSPSimulatorFromINAV &data)
             this->control_roll)
     );
 
-    eventBus->Publish<AddDebugEventArg>(
-        "AddDebug",
-        AddDebugEventArg(
-            data.debugIndex & 7,
-            data.debugValue)
-    );
+    const int64_t t = Clock::NowUs();
+
+    TDebugFrame debugFrame;
+    if (this->debugAssembler.add(data.debugIndex & 7, data.debugValue, this->modelTimeUs(), debugFrame))
+    {
+        eventBus->Publish<DebugFrameEventArg>("DebugFrame", DebugFrameEventArg(debugFrame));
+    }
 
-    uint32_t t = Utils::GetTicks();
-    uint32_t delta = t - this->lastUpdateMS;
-    if ((this->lastUpdateMS != 0) && (delta < 300))
+    const int64_t delta = t - this->lastUpdateUs;
+    if ((this->lastUpdateUs != 0) && (delta < SimDataConstants::MAX_UPDATE_PERIOD_US))
     {
-        eventBus->Publish<IntEventArg>(
+        eventBus->Publish<FloatEventArg>(
             "AddUpdatePeriodMS",
-            IntEventArg(delta)
+            FloatEventArg(delta / 1000.0f)
         );
     }
-    this->lastUpdateMS = t;
+    this->lastUpdateUs = t;
 }
 
 
@@ -591,20 +845,37 @@ void SimData::sendToINAV_HITL()
         return;
     }
 
-    auto eventBus = Plugin()->GetEventBus();
+    const TSensorSnapshot snapshot = this->buildSensorSnapshot();
+    this->recordTracePacket(snapshot);
 
-    TSimdata simData = this->simDataFromXplane;
-    this->applyHardwareFailures(simData);
+    if (this->sensorSender && this->sensorSender->isRunning())
+    {
+        this->sensorSender->publish(snapshot);
+        return;
+    }
 
-    TMSPSimulatorToINAV data = {0};
+    const bool hasNewGpsData = snapshot.gpsSequence != this->lastSentGpsSequence;
+    this->lastSentGpsSequence = snapshot.gpsSequence;
 
-    data.header.version = MSPConstants::MSP_SIMULATOR_VERSION;
+    TMSPSimulatorToINAV data = SensorPacket::encode(snapshot, hasNewGpsData);
 
-    data.header.flags = SIMU_ENABLE |
+    std::vector<uint8_t> msp_message_buffer = std::vector<uint8_t>(sizeof(data));
+    std::memcpy(msp_message_buffer.data(), &data, sizeof(data));
+
+    Plugin()->GetEventBus()->Publish<MSPMessageEventArg>("SendMSPMessage", MSPMessageEventArg(MSP_SIMULATOR, msp_message_buffer));
+}
+
+TSensorSnapshot SimData::buildSensorSnapshot()
+{
+    TSensorSnapshot snapshot = {};
+
+    snapshot.simData = this->simDataOut;
+    snapshot.reference = this->simDataFromXplane;
+
+    snapshot.flags = SIMU_ENABLE |
                  ((this->batEmulation != BATTERY_NONE) ? SIMU_SIMULATE_BATTERY : 0) |
                  (this->muteBeeper ? SIMU_MUTE_BEEPER : 0) |
                  (this->attitude_use_sensors ? SIMU_USE_SENSORS : 0) |
-                 (this->GPSHasNewData && !this->gps_timeout ? SIMU_HAS_NEW_GPS_DATA : 0) |
                  (this->batEmulation != BATTERY_NONE ? SIMU_EXT_BATTERY_VOLTAGE : 0) |
                  (this->simulatePitot != TPitotSimulation::None ? SIMU_AIRSPEED : 0) |
                  (this->simulatePitot == TPitotSimulation::Failure ? SIMU2_PITOT_FAILURE : 0) |
@@ -613,75 +884,288 @@ void SimData::sendToINAV_HITL()
                  (this->rangefinderSimulation != RANGEFINDER_NONE ? SIMU3_RANGEFINDER : 0) |
                  (this->rxIsFailsafe ? SIMU3_RX_FAILSAFFE : 0);
 
-    this->GPSHasNewData = false;
-
-    data.fix = this->gps_fix;
-    data.numSat = (uint8_t)simData.numSats;
-    data.lat = (int32_t)round(simData.latitude * 10000000);
-    data.lon = (int32_t)round(simData.longitude * 10000000);
-    data.alt = (int32_t)round(simData.elevation * 100);      // expected by inav: elevation in cm
-    data.speed = (int16_t)round(simData.speed * 100);        // expected by inav: ground speed cm/sec
-    data.airspeed = (uint16_t)round(simData.airspeed * 100); // expected by inav: ground speed cm/sec
-
-    data.course = (int16_t)round(simData.course * 10); // expected by inav: deg * 10
-    if (data.course < 0)
-        data.course += 3600;
-
-    // INAV don't like the velocities from X-Plane and NAV modes go nuts, so send zeroes and let INAV calculate velocities by itself
-    data.velNED[0] = 0; // (int16_t)round(-simData.velNED[X] * 100); // nedVelNorth;
-    data.velNED[1] = 0; // (int16_t)round(simData.velNED[Y] * 100);  // nedVelEast
-    data.velNED[2] = 0; // (int16_t)round(-simData.velNED[Z] * 100); // nedVelDown
-
-    // expected order of rotation from local to global: roll, pitch, yaw
-    data.roll = (int16_t)round(simData.euler.roll * 10);   // expected by inav: left wing down - negative roll, 1 degree = 10, values range: -1800...1800
-    data.pitch = (int16_t)round(-simData.euler.pitch * 10); // expected by inav: stick down/nose up - negative pitch, upside-down: stick down/nose up - positiive pitch, 1 degree = 10 , values range: -1800...1800
-    data.yaw = (int16_t)round(simData.euler.yaw * 10);    // expected by inav: rotate clockwise( top view) - positive yaw+, 1 degreee = 10 , values range: 0...3600 , north = 0
-    if (data.yaw < 0)
-        data.yaw += 3600;
+    if (this->GPSHasNewData)
+    {
+        this->GPSHasNewData = false;
+        if (!this->gps_timeout)
+        {
+            this->gpsSequence++;
+        }
+    }
+    snapshot.gpsSequence = this->gpsSequence;
+    snapshot.fix = this->gps_fix;
+    snapshot.gpsVelocities = this->gpsSendVelocities;
 
-    
-    data.accel_x = Utils::ClampToInt16(-simData.acceleration.x * 1000.0f); // expected by inav: forward - positive
-    data.accel_y = Utils::ClampToInt16(simData.acceleration.y * 1000.0f);  // expected by inav: right - negative
-    data.accel_z = Utils::ClampToInt16(simData.acceleration.z * 1000.0f);  // expected by inav: 1.0f in stable position (1G)
-
-    data.gyro_x = Utils::ClampToInt16(simData.gyro.x * 16.0f);  // expected by inav: roll left wing down rotation -> negative
-    data.gyro_y = Utils::ClampToInt16(-simData.gyro.y * 16.0f); // expected by inav: pitch up rotation -> negative, 1 deerees per second
-    data.gyro_z = Utils::ClampToInt16(-simData.gyro.z * 16.0f); // expected by inav: yaw clockwise rotation (top view) ->negative
-   
-    data.baro = (int32_t)round(simData.baro * 3386.39f);
-    data.mag_x = Utils::ClampToInt16(simData.mag.x * 16000.0f);
-    data.mag_y = Utils::ClampToInt16(simData.mag.y * 16000.0f);
-    data.mag_z = Utils::ClampToInt16(simData.mag.z * 16000.0f);
-
-    data.rangefinder_distance_cm = simData.rangefinder_distance_cm;
-    
     this->recalculatePowerTrain();
-    data.vbat = (uint8_t)round(this->powerTrain->getCurrentBatteryVoltage() * 10);
-    data.current = this->powerTrain->getCurrentBatteryAmps() * 10;
-
-    data.rc_inputs[SimDataConstants::RC_CHANNEL_ROLL] = SimDataConstants::float_minus_1_1_to_pwm(this->rc_inputs[SimDataConstants::RC_CHANNEL_ROLL]);
-    data.rc_inputs[SimDataConstants::RC_CHANNEL_PITCH] = SimDataConstants::float_minus_1_1_to_pwm(this->rc_inputs[SimDataConstants::RC_CHANNEL_PITCH]);
-    data.rc_inputs[SimDataConstants::RC_CHANNEL_THROTTLE] = SimDataConstants::float_0_1_to_pwm(this->rc_inputs[SimDataConstants::RC_CHANNEL_THROTTLE]);
-    data.rc_inputs[SimDataConstants::RC_CHANNEL_YAW] = SimDataConstants::float_minus_1_1_to_pwm(this->rc_inputs[SimDataConstants::RC_CHANNEL_YAW]);
-    data.rc_inputs[SimDataConstants::RC_CHANNEL_AUX1] = SimDataConstants::float_0_1_to_pwm(this->rc_inputs[SimDataConstants::RC_CHANNEL_AUX1]);
-    data.rc_inputs[SimDataConstants::RC_CHANNEL_AUX2] = SimDataConstants::float_0_1_to_pwm(this->rc_inputs[SimDataConstants::RC_CHANNEL_AUX2]);
-    data.rc_inputs[SimDataConstants::RC_CHANNEL_AUX3] = SimDataConstants::float_0_1_to_pwm(this->rc_inputs[SimDataConstants::RC_CHANNEL_AUX3]);
-    data.rc_inputs[SimDataConstants::RC_CHANNEL_AUX4] = SimDataConstants::float_0_1_to_pwm(this->rc_inputs[SimDataConstants::RC_CHANNEL_AUX4]);
+    snapshot.batteryVoltage = this->powerTrain->getCurrentBatteryVoltage();
+    snapshot.batteryCurrent = this->powerTrain->getCurrentBatteryAmps();
+
+    snapshot.rc_inputs[SimDataConstants::RC_CHANNEL_ROLL] = SimDataConstants::float_minus_1_1_to_pwm(this->rc_inputs[SimDataConstants::RC_CHANNEL_ROLL]);
+    snapshot.rc_inputs[SimDataConstants::RC_CHANNEL_PITCH] = SimDataConstants::float_minus_1_1_to_pwm(this->rc_inputs[SimDataConstants::RC_CHANNEL_PITCH]);
+    snapshot.rc_inputs[SimDataConstants::RC_CHANNEL_THROTTLE] = SimDataConstants::float_0_1_to_pwm(this->rc_inputs[SimDataConstants::RC_CHANNEL_THROTTLE]);
+    snapshot.rc_inputs[SimDataConstants::RC_CHANNEL_YAW] = SimDataConstants::float_minus_1_1_to_pwm(this->rc_inputs[SimDataConstants::RC_CHANNEL_YAW]);
+    snapshot.rc_inputs[SimDataConstants::RC_CHANNEL_AUX1] = SimDataConstants::float_0_1_to_pwm(this->rc_inputs[SimDataConstants::RC_CHANNEL_AUX1]);
+    snapshot.rc_inputs[SimDataConstants::RC_CHANNEL_AUX2] = SimDataConstants::float_0_1_to_pwm(this->rc_inputs[SimDataConstants::RC_CHANNEL_AUX2]);
+    snapshot.rc_inputs[SimDataConstants::RC_CHANNEL_AUX3] = SimDataConstants::float_0_1_to_pwm(this->rc_inputs[SimDataConstants::RC_CHANNEL_AUX3]);
+    snapshot.rc_inputs[SimDataConstants::RC_CHANNEL_AUX4] = SimDataConstants::float_0_1_to_pwm(this->rc_inputs[SimDataConstants::RC_CHANNEL_AUX4]);
 
     // Calculate RSSI based on distance to home location (max range 2 km)
-    data.rssi = this->calculateRSSI();
+    snapshot.rssi = this->calculateRSSI();
 
-    std::vector<uint8_t> msp_message_buffer = std::vector<uint8_t>(sizeof(data));
-    std::memcpy(msp_message_buffer.data(), &data, sizeof(data));
+    snapshot.sampleTimeUs = this->xplaneSampleTimeUs;
+    snapshot.extrapolate = this->sensorExtrapolation;
 
-    Plugin()->GetEventBus()->Publish<MSPMessageEventArg>("SendMSPMessage", MSPMessageEventArg(MSP_SIMULATOR, msp_message_buffer));
+    return snapshot;
+}
+
+void SimData::startTraceRecording()
+{
+    fs::path directory = Utils::GetPluginDirectory() / "traces";
+    std::error_code error;
+    fs::create_directories(directory, error);
+
+    const auto now = std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now());
+    const fs::path fileName = directory / std::format("trace_{:%Y%m%d_%H%M%S}{}", now, SimTraceConstants::FILE_EXTENSION);
+    if (!this->traceWriter.open(fileName.string()))
+    {
+        Utils::LOG("Unable to create trace file {}", fileName.string());
+        Plugin()->GetEventBus()->Publish<OsdToastEventArg>("MakeToast", OsdToastEventArg("Trace", "Unable to create file", 3000));
+        return;
+    }
+
+    this->traceRowPending = false;
+    this->updateSensorSender();
+    Utils::LOG("Trace recording started: {}", fileName.string());
+    Plugin()->GetEventBus()->Publish<IntEventArg>("TraceRecordingChanged", IntEventArg(1));
+}
+
+void SimData::stopTraceRecording()
+{
+    if (!this->traceWriter.isOpen())
+    {
+        return;
+    }
+
+    if (this->traceRowPending)
+    {
+        this->traceWriter.append(this->traceRow);
+        this->traceRowPending = false;
+    }
+    const int rows = this->traceWriter.getRowCount();
+    this->traceWriter.close();
+    this->updateSensorSender();
+
+    Utils::LOG("Trace recording stopped, {} packets", rows);
+    Plugin()->GetEventBus()->Publish<OsdToastEventArg>("MakeToast", OsdToastEventArg("Trace saved", std::format("{} packets", rows), 3000));
+    Plugin()->GetEventBus()->Publish<IntEventArg>("TraceRecordingChanged", IntEventArg(0));
+}
+
+// A row is complete when the next packet is sent, so it holds the last reply received in between
+void SimData::recordTracePacket(const TSensorSnapshot &snapshot)
+{
+    if (!this->traceWriter.isOpen())
+    {
+        return;
+    }
+
+    if (this->traceRowPending)
+    {
+        this->traceWriter.append(this->traceRow);
+    }
+
+    this->traceRow = {};
+    this->traceRow.timeUs = this->modelTimeUs();
+    this->traceRow.snapshot = snapshot;
+    this->traceRowPending = true;
+}
+
+void SimData::recordTraceReply(const TMSPSimulatorFromINAV &data)
+{
+    if (!this->traceRowPending)
+    {
+        return;
+    }
+
+    this->traceRow.replyTimeUs = this->modelTimeUs();
+    this->traceRow.outputRoll = data.roll;
+    this->traceRow.outputPitch = data.pitch;
+    this->traceRow.outputYaw = data.yaw;
+    this->traceRow.outputThrottle = data.throttle;
+    this->traceRow.debugIndex = data.debugIndex;
+    this->traceRow.debugValue = data.debugValue;
+    this->traceRow.estimatedRoll = data.estimated_attitude_roll;
+    this->traceRow.estimatedPitch = data.estimated_attitude_pitch;
+    this->traceRow.estimatedYaw = data.estimated_attitude_yaw;
 }
 
+void SimData::updateSensorSender()
+{
+    // In lockstep the flight loop sends exactly one packet per X-Plane cycle. While a trace is
+    // recorded, too: the trace has to hold the packets as sent, the thread extrapolates its own
+    if (this->isHitlConnected && this->sensorRateHz > 0 && !this->lockstep && !this->traceWriter.isOpen())
+    {
+        this->sensorSender->start(this->sensorRateHz);
+    }
+    else
+    {
+        this->sensorSender->stop();
+    }
+}
+
+void SimData::publishSensorSenderStatistics()
+{
+    if (!this->sensorSender->isRunning())
+    {
+        return;
+    }
+
+    TSensorSenderStatistics statistics;
+    const uint32_t sequence = this->sensorSender->getStatistics(statistics);
+    if (sequence == this->sensorSenderStatisticsSequence)
+    {
+        return;
+    }
+    this->sensorSenderStatisticsSequence = sequence;
+
+    Plugin()->GetEventBus()->Publish<SensorSenderStatisticsEventArg>(
+        "SensorSenderStatistics",
+        SensorSenderStatisticsEventArg(statistics.rateHz, statistics.jitterMeanUs, statistics.jitterStdDevUs, statistics.jitterMaxUs, statistics.overruns));
+}
+
+void SimData::waitForLockstepReply()
+{
+    if (Plugin()->MSP()->waitForMessage(MSP_SIMULATOR, SimDataConstants::LOCKSTEP_REPLY_TIMEOUT_US))
+    {
+        this->lockstepSteps++;
+    }
+    else
+    {
+        this->lockstepTimeouts++;
+    }
+
+    const int64_t t = Clock::NowUs();
+    if (this->lockstepWindowStartUs == 0)
+    {
+        this->lockstepWindowStartUs = t;
+        this->lockstepWindowSimStartUs = this->simClock.nowUs();
+        return;
+    }
+
+    const int64_t windowUs = t - this->lockstepWindowStartUs;
+    if (windowUs < SimDataConstants::LOCKSTEP_STATISTICS_WINDOW_US)
+    {
+        return;
+    }
+
+    const int stepsPerSecond = static_cast<int>(roundf(this->lockstepSteps * static_cast<float>(ClockConstants::US_PER_S) / windowUs));
+    const float realtimeFactor = static_cast<float>(this->simClock.nowUs() - this->lockstepWindowSimStartUs) / windowUs;
+
+    Plugin()->GetEventBus()->Publish<LockstepStatisticsEventArg>(
+        "LockstepStatistics",
+        LockstepStatisticsEventArg(stepsPerSecond, realtimeFactor, this->lockstepTimeouts));
+
+    this->lockstepSteps = 0;
+    this->lockstepTimeouts = 0;
+    this->lockstepWindowStartUs = t;
+    this->lockstepWindowSimStartUs = this->simClock.nowUs();
+}
+
+// Lockstep runs the sensor timing models and the trace on the sim clock, so a replay with the
+// same X-Plane frames gets the same GPS delays and sample times independent of the FC speed
+int64_t SimData::modelTimeUs() const
+{
+    return this->lockstep ? this->simClock.nowUs() : Clock::NowUs();
+}
+
+void SimData::resetLockstepStatistics()
+{
+    this->lockstepSteps = 0;
+    this->lockstepTimeouts = 0;
+    this->lockstepWindowStartUs = 0;
+    Plugin()->GetEventBus()->Publish<LockstepStatisticsEventArg>("LockstepStatistics", LockstepStatisticsEventArg(0, 0.0f, 0));
+}
+
+// Compares INAVs attitude estimate (decidegrees, INAV convention) with the current X-Plane attitude (degrees, X-Plane convention),
+// AttitudeErrorStatistics::add scales and flips pitch
+void SimData::updateAttitudeEstimationError(const TMSPSimulatorFromINAV &data)
+{
+    const eulerAngles &real = this->simDataFromXplane.euler;
+    this->attitudeErrorWindow.add(real.roll, real.pitch, real.yaw, data.estimated_attitude_roll, data.estimated_attitude_pitch, data.estimated_attitude_yaw);
+    this->attitudeErrorFlight.add(real.roll, real.pitch, real.yaw, data.estimated_attitude_roll, data.estimated_attitude_pitch, data.estimated_attitude_yaw);
+
+    const int64_t t = Clock::NowUs();
+    if ((t - this->attitudeErrorWindowStartUs) < SimDataConstants::ATTITUDE_ERROR_WINDOW_US)
+    {
+        return;
+    }
+
+    auto eventBus = Plugin()->GetEventBus();
+
+    const TAttitudeErrorSummary window = this->attitudeErrorWindow.summarize();
+    eventBus->Publish<Vector3EventArgs>(
+        "AttitudeEstimationError",
+        Vector3EventArgs(window.meanDeg[0], window.meanDeg[1], window.meanDeg[2]));
+    eventBus->Publish<AttitudeErrorSummaryEventArg>("AttitudeErrorSummary", AttitudeErrorSummaryEventArg(this->attitudeErrorFlight.summarize()));
+
+    this->attitudeErrorWindow.reset();
+    this->attitudeErrorWindowStartUs = t;
+}
+
+void SimData::resetAttitudeErrorFlight()
+{
+    this->attitudeErrorFlight.reset();
+    this->attitudeErrorFlightStartUs = Clock::NowUs();
+}
+
+// One line per flight, to compare the estimator of different firmware builds
+void SimData::writeAttitudeErrorSummary()
+{
+    const TAttitudeErrorSummary summary = this->attitudeErrorFlight.summarize();
+    if (summary.samples == 0)
+    {
+        return;
+    }
+
+    const TMSPFCVersion &version = Plugin()->MSP()->version;
+    const float durationS = (Clock::NowUs() - this->attitudeErrorFlightStartUs) / static_cast<float>(ClockConstants::US_PER_S);
+    Utils::LOG("Attitude error R/P/Y over {:.0f} s, {} samples: RMS {:.2f} / {:.2f} / {:.2f} deg, P95 {:.1f} / {:.1f} / {:.1f} deg, max {:.1f} / {:.1f} / {:.1f} deg",
+               durationS, summary.samples,
+               summary.rmsDeg[0], summary.rmsDeg[1], summary.rmsDeg[2],
+               summary.p95Deg[0], summary.p95Deg[1], summary.p95Deg[2],
+               summary.maxDeg[0], summary.maxDeg[1], summary.maxDeg[2]);
+
+    const fs::path fileName = Utils::GetPluginDirectory() / "attitude_error.csv";
+    const bool writeHeader = !fs::exists(fileName);
+    FILE *file = fopen(fileName.string().c_str(), "a");
+    if (file == nullptr)
+    {
+        Utils::LOG("Unable to write {}", fileName.string());
+        return;
+    }
+
+    if (writeHeader)
+    {
+        fprintf(file, "time,inav_version,duration_s,samples");
+        for (const char *axis : {"roll", "pitch", "yaw"})
+        {
+            fprintf(file, ",%s_mean,%s_rms,%s_p50,%s_p95,%s_p99,%s_max", axis, axis, axis, axis, axis, axis);
+        }
+        fprintf(file, "\n");
+    }
+
+    const auto now = std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now());
+    fprintf(file, "%s,%d.%d.%d,%.1f,%d", std::format("{:%Y-%m-%d %H:%M:%S}", now).c_str(), version.major, version.minor, version.patchVersion, durationS, summary.samples);
+    for (int i = 0; i < AttitudeErrorStatisticsConstants::AXES; i++)
+    {
+        fprintf(file, ",%.2f,%.2f,%.1f,%.1f,%.1f,%.1f", summary.meanDeg[i], summary.rmsDeg[i], summary.p50Deg[i], summary.p95Deg[i], summary.p99Deg[i], summary.maxDeg[i]);
+    }
+    fprintf(file, "\n");
+    fclose(file);
+}
 
 void SimData::updateDataRefs()
 {
-    TSimdata simData = this->simDataFromXplane;
-    this->applyHardwareFailures(simData);
+    const TSimdata &simData = this->simDataOut;
 
     float throttle = SimDataConstants::input_to_float_0_1(this->control_throttle);
     if (this->batEmulation != BATTERY_NONE)
@@ -697,88 +1181,225 @@ void SimData::updateDataRefs()
     eventArgs.gpsLongitude = simData.longitude;
     eventArgs.gpsElevation = simData.elevation;
     eventArgs.gpsVelocities = simData.velNED;
+    eventArgs.gpsHdop = this->gpsHdop;
     eventArgs.groundspeed = simData.speed;
     eventArgs.airspeed = simData.airspeed;
     eventArgs.magnetometer = simData.mag;
+    eventArgs.magDeclination = this->magDeclination;
     eventArgs.rangefinderDistanceCm = simData.rangefinder_distance_cm;
     eventArgs.batteryVoltage = this->powerTrain->getCurrentBatteryVoltage();
     eventArgs.currentConsumption = this->powerTrain->getCurrentBatteryAmps();
+    eventArgs.minCellVoltage = this->powerTrain->getBattery().getMinCellVoltage();
+    eventArgs.batteryTemperature = this->powerTrain->getBattery().getMaxTemperature();
+    if (this->batEmulation != BATTERY_NONE && this->enduranceEstimator.hasPrediction())
+    {
+        eventArgs.predictedTimeRemainingS = this->enduranceEstimator.getPrediction().flightTimeS;
+        eventArgs.predictedMinVoltage = this->enduranceEstimator.getPrediction().minVoltage;
+    }
     eventArgs.rssi = this->calculateRSSI();
     eventArgs.isFailsafe = this->rxIsFailsafe;
+    eventArgs.rssiTerrainLossDb = this->rssiTerrain ? this->terrainLineOfSight.getLossDb() : 0.0f;
     
     Plugin()->GetEventBus()->Publish<UpdateDataRefEventArg>("UpdateDataRef", eventArgs);
 }
-void SimData::applyHardwareFailures(TSimdata &simData)
+void SimData::configureGpsReceiver()
 {
-    if (this->simulatePitot == TPitotSimulation::Failure60)
-    {
-        simData.airspeed = 17.77f; // 60 km/h
-    }
+    this->gpsReceiver.configure(this->gpsRateHz, this->gpsLatencyMs, this->gpsJitterMs);
+    this->gpsReceiver.setSatellites(this->gpsNumSats, this->sensorNoise != SimDataConstants::SENSOR_NOISE_OFF);
+    this->gpsReceiver.seed(this->sensorNoiseSeed, SENSOR_COUNT);
+}
 
-    if (this->gps_glitch != SimDataConstants::GPS_GLITCH_NONE)
+int SimData::gpsFixFromSatellites(int numSats)
+{
+    if (numSats == 0)
     {
-        if (this->glitch_lattitude == 0)
-        {
-            this->glitch_lattitude = this->simDataFromXplane.latitude;
-            this->glitch_longitude = this->simDataFromXplane.longitude;
-            this->glitch_elevation = this->simDataFromXplane.elevation;
-        }
+        return SimDataConstants::GPS_NO_FIX;
     }
-    else
+    else if (numSats < 4)
     {
-        this->glitch_lattitude = 0;
-        this->glitch_longitude = 0;
-        this->glitch_elevation = 0;
+        return SimDataConstants::GPS_FIX_2D;
     }
+    return SimDataConstants::GPS_FIX_3D;
+}
 
-    if (this->gps_glitch == SimDataConstants::GPS_GLITCH_FREEZE)
-    {
-        simData.latitude = this->glitch_lattitude;
-        simData.longitude = this->glitch_longitude;
-        simData.elevation = this->glitch_elevation;
-        simData.speed = 0;
-        simData.velNED.x = 0;
-        simData.velNED.y = 0;
-        simData.velNED.z = 0;
-    }
-    else if (this->gps_glitch == SimDataConstants::GPS_GLITCH_OFFSET)
+void SimData::configureSensorPipeline()
+{
+    for (int sensor = 0; sensor < SENSOR_COUNT; sensor++)
     {
-        simData.latitude = this->simDataFromXplane.latitude + 5.0 / 111.32;
-        simData.longitude = this->simDataFromXplane.longitude;
-        simData.elevation = this->simDataFromXplane.elevation + 50.0f;
+        this->configureSensorPipeline(static_cast<TSensorType>(sensor));
     }
-    else if (this->gps_glitch == SimDataConstants::GPS_GLITCH_LINEAR)
+}
+
+void SimData::configureSensorPipeline(TSensorType sensor)
+{
+    const bool noise = this->sensorNoise != SimDataConstants::SENSOR_NOISE_OFF;
+    const bool high = this->sensorNoise == SimDataConstants::SENSOR_NOISE_HIGH;
+    const float k = high ? SimDataConstants::NOISE_HIGH_FACTOR : 1.0f;
+
+    std::vector<TSensorStageConfig> stages;
+
+    switch (sensor)
     {
-        float k = Utils::GetTicks() / 100000.0f;
-        k -= (int)k;
-        simData.latitude = this->simDataFromXplane.latitude + k / 111.32;
-        simData.longitude = this->simDataFromXplane.longitude;
-        simData.elevation = this->simDataFromXplane.elevation;
-    }
-    else if (this->gps_glitch == SimDataConstants::GPS_GLITCH_ALTITUDE)
+    case SENSOR_GPS:
     {
-        float k = Utils::GetTicks() / 100000.0f;
-        k -= (int)k;
-        simData.elevation = this->glitch_elevation + k * 1000.0f;
-        simData.velNED.z= k * 1000.0f;
-    }
+        if (noise)
+        {
+            const float position = k * SimDataConstants::NOISE_GPS_POSITION_M * SimDataConstants::METERS_TO_DEGREES;
+            const float velocity = k * SimDataConstants::NOISE_GPS_VELOCITY_MS;
+            stages.push_back(TSensorStageConfig::Noise(SENSOR_CHANNEL_GPS_LATITUDE, {position, position, k * SimDataConstants::NOISE_GPS_ELEVATION_M, velocity, velocity, velocity, velocity}));
+        }
+        if (high)
+        {
+            stages.push_back(TSensorStageConfig::Delay(SENSOR_CHANNEL_GPS_LATITUDE, SensorPipelineConstants::SENSOR_CHANNELS[SENSOR_GPS].count, SimDataConstants::NOISE_HIGH_GPS_DELAY_CYCLES));
+        }
 
-    if (this->simulate_mag_failure)
-    {
-        simData.mag.x = 0;
-        simData.mag.y = 0;
-        simData.mag.z = 0;
+        const float period = SimDataConstants::GPS_GLITCH_PERIOD_S;
+        switch (this->gps_glitch)
+        {
+        case SimDataConstants::GPS_GLITCH_FREEZE:
+            stages.push_back(TSensorStageConfig::Stuck(SENSOR_CHANNEL_GPS_LATITUDE, 3));
+            stages.push_back(TSensorStageConfig::Dropout(SENSOR_CHANNEL_GPS_SPEED, {0.0f, 0.0f, 0.0f, 0.0f}, 1.0f));
+            break;
+        case SimDataConstants::GPS_GLITCH_OFFSET:
+            stages.push_back(TSensorStageConfig::Bias(SENSOR_CHANNEL_GPS_LATITUDE, {5.0f / 111.32f, 0.0f, 50.0f}));
+            break;
+        case SimDataConstants::GPS_GLITCH_LINEAR:
+            stages.push_back(TSensorStageConfig::Drift(SENSOR_CHANNEL_GPS_LATITUDE, {1.0f / 111.32f}, period));
+            break;
+        case SimDataConstants::GPS_GLITCH_ALTITUDE:
+            stages.push_back(TSensorStageConfig::Stuck(SENSOR_CHANNEL_GPS_ELEVATION, 1));
+            stages.push_back(TSensorStageConfig::Drift(SENSOR_CHANNEL_GPS_ELEVATION, {1000.0f}, period));
+            stages.push_back(TSensorStageConfig::Dropout(SENSOR_CHANNEL_GPS_VEL_Z, {0.0f}, 1.0f));
+            stages.push_back(TSensorStageConfig::Drift(SENSOR_CHANNEL_GPS_VEL_Z, {1000.0f}, period));
+            break;
+        default:
+            break;
+        }
+        break;
     }
 
-    if (this->rangefinderSimulation == RANGEFINDER_FAILURE)
-    {
-        simData.rangefinder_distance_cm = 0;
-    }
+    case SENSOR_AIRSPEED:
+        if (noise)
+        {
+            stages.push_back(TSensorStageConfig::Noise(SENSOR_CHANNEL_AIRSPEED, {k * SimDataConstants::NOISE_AIRSPEED_MS}));
+        }
+        if (this->simulatePitot == TPitotSimulation::Failure60)
+        {
+            stages.push_back(TSensorStageConfig::Dropout(SENSOR_CHANNEL_AIRSPEED, {SimDataConstants::PITOT_FAILURE_AIRSPEED}, 1.0f));
+        }
+        break;
 
-    if (this->simulatePitot == TPitotSimulation::Failure60)
-    {
-        simData.airspeed = (uint16_t)round(1777);
+    case SENSOR_ACC:
+        if (noise)
+        {
+            const float sigma = k * SimDataConstants::NOISE_ACC_G;
+            stages.push_back(TSensorStageConfig::Noise(SENSOR_CHANNEL_ACC_X, {sigma, sigma, sigma}));
+        }
+        if (high)
+        {
+            stages.push_back(TSensorStageConfig::Scale(SENSOR_CHANNEL_ACC_X, {1.02f, 0.98f, 1.01f}));
+        }
+        break;
+
+    case SENSOR_GYRO:
+        if (noise)
+        {
+            const float sigma = k * SimDataConstants::NOISE_GYRO_DPS;
+            stages.push_back(TSensorStageConfig::Noise(SENSOR_CHANNEL_GYRO_X, {sigma, sigma, sigma}));
+        }
+        if (high)
+        {
+            stages.push_back(TSensorStageConfig::Bias(SENSOR_CHANNEL_GYRO_X, {0.5f, -0.3f, 0.2f}));
+        }
+        break;
+
+    case SENSOR_MAG:
+        if (noise)
+        {
+            const float sigma = k * SimDataConstants::NOISE_MAG;
+            stages.push_back(TSensorStageConfig::Noise(SENSOR_CHANNEL_MAG_X, {sigma, sigma, sigma}));
+        }
+        if (high)
+        {
+            const float step = SimDataConstants::NOISE_HIGH_MAG_RESOLUTION;
+            stages.push_back(TSensorStageConfig::Quantization(SENSOR_CHANNEL_MAG_X, {step, step, step}));
+        }
+        if (this->simulate_mag_failure)
+        {
+            stages.push_back(TSensorStageConfig::Dropout(SENSOR_CHANNEL_MAG_X, {0.0f, 0.0f, 0.0f}, 1.0f));
+        }
+        break;
+
+    case SENSOR_BARO:
+        if (noise)
+        {
+            stages.push_back(TSensorStageConfig::Noise(SENSOR_CHANNEL_BARO, {k * SimDataConstants::NOISE_BARO_INHG}));
+        }
+        break;
+
+    case SENSOR_RANGEFINDER:
+        // No noise, 0xffff is the out of range marker
+        if (this->rangefinderSimulation == RANGEFINDER_FAILURE)
+        {
+            stages.push_back(TSensorStageConfig::Dropout(SENSOR_CHANNEL_RANGEFINDER, {0.0f}, 1.0f));
+        }
+        break;
+
+    default:
+        break;
     }
+
+    this->sensorPipeline.configure(sensor, stages);
+}
+
+void SimData::runSensorPipeline()
+{
+    const TSimdata &in = this->simDataFromXplane;
+
+    SensorPipeline::TChannelValues values;
+    values[SENSOR_CHANNEL_GPS_LATITUDE] = in.latitude;
+    values[SENSOR_CHANNEL_GPS_LONGITUDE] = in.longitude;
+    values[SENSOR_CHANNEL_GPS_ELEVATION] = in.elevation;
+    values[SENSOR_CHANNEL_GPS_SPEED] = in.speed;
+    values[SENSOR_CHANNEL_GPS_VEL_X] = in.velNED.x;
+    values[SENSOR_CHANNEL_GPS_VEL_Y] = in.velNED.y;
+    values[SENSOR_CHANNEL_GPS_VEL_Z] = in.velNED.z;
+    values[SENSOR_CHANNEL_AIRSPEED] = in.airspeed;
+    values[SENSOR_CHANNEL_ACC_X] = in.acceleration.x;
+    values[SENSOR_CHANNEL_ACC_Y] = in.acceleration.y;
+    values[SENSOR_CHANNEL_ACC_Z] = in.acceleration.z;
+    values[SENSOR_CHANNEL_GYRO_X] = in.gyro.x;
+    values[SENSOR_CHANNEL_GYRO_Y] = in.gyro.y;
+    values[SENSOR_CHANNEL_GYRO_Z] = in.gyro.z;
+    values[SENSOR_CHANNEL_MAG_X] = in.mag.x;
+    values[SENSOR_CHANNEL_MAG_Y] = in.mag.y;
+    values[SENSOR_CHANNEL_MAG_Z] = in.mag.z;
+    values[SENSOR_CHANNEL_BARO] = in.baro;
+    values[SENSOR_CHANNEL_RANGEFINDER] = in.rangefinder_distance_cm;
+
+    this->sensorPipeline.process(values, values, this->simClock.nowS());
+
+    TSimdata &out = this->simDataOut;
+    out = in;
+    out.latitude = values[SENSOR_CHANNEL_GPS_LATITUDE];
+    out.longitude = values[SENSOR_CHANNEL_GPS_LONGITUDE];
+    out.elevation = values[SENSOR_CHANNEL_GPS_ELEVATION];
+    out.speed = values[SENSOR_CHANNEL_GPS_SPEED];
+    out.velNED.x = values[SENSOR_CHANNEL_GPS_VEL_X];
+    out.velNED.y = values[SENSOR_CHANNEL_GPS_VEL_Y];
+    out.velNED.z = values[SENSOR_CHANNEL_GPS_VEL_Z];
+    out.airspeed = values[SENSOR_CHANNEL_AIRSPEED];
+    out.acceleration.x = values[SENSOR_CHANNEL_ACC_X];
+    out.acceleration.y = values[SENSOR_CHANNEL_ACC_Y];
+    out.acceleration.z = values[SENSOR_CHANNEL_ACC_Z];
+    out.gyro.x = values[SENSOR_CHANNEL_GYRO_X];
+    out.gyro.y = values[SENSOR_CHANNEL_GYRO_Y];
+    out.gyro.z = values[SENSOR_CHANNEL_GYRO_Z];
+    out.mag.x = values[SENSOR_CHANNEL_MAG_X];
+    out.mag.y = values[SENSOR_CHANNEL_MAG_Y];
+    out.mag.z = values[SENSOR_CHANNEL_MAG_Z];
+    out.baro = values[SENSOR_CHANNEL_BARO];
+    out.rangefinder_distance_cm = static_cast<uint16_t>(std::clamp(roundf(values[SENSOR_CHANNEL_RANGEFINDER]), 0.0f, 65535.0f));
 }
 
 void SimData::disconnect()
@@ -804,16 +1425,67 @@ void SimData::disconnect()
     else if (this->isHitlConnected)
     {
         this->sendToXPlane_HITL();
-    }       
+    }
+
+    // Not necessarily called from within a cycle, write immediately
+    this->dataRefs.flush();
 }
 
 void SimData::setBateryEmulation(BatteryEmulationType type)
 {
     this->batEmulation = type;
-    const BatteryData batteryData = SimDataConstants::BATTERY_DATA.at(type);
 
-    this->powerTrain = std::make_unique<PowerTrain>(batteryData.chemistry, batteryData.capacityMah);
-    this->powerTrainLastUpdate = 0.0f;
+    const TCatalogPropulsion *propulsion = this->powerTrainCatalog.findPropulsion(this->aircraftMotor, this->aircraftPropeller);
+    const TPropulsion &motor = propulsion != nullptr ? propulsion->propulsion : PowerTrain::getBuiltInPropulsion();
+
+    const TCatalogPack *pack = type == BATTERY_AIRCRAFT_PACK ? this->powerTrainCatalog.findPack(this->aircraftBatteryPack) : nullptr;
+    if (pack != nullptr)
+    {
+        this->powerTrain = std::make_unique<PowerTrain>(this->powerTrainCatalog.getChemistry(*pack), pack->capacityMah, pack->cells, motor);
+    }
+    else
+    {
+        // Without a pack selected for the aircraft, fall back to 3S 2200 mAh LiPo
+        const BatteryData batteryData = SimDataConstants::BATTERY_DATA.at(type == BATTERY_AIRCRAFT_PACK ? BATTERY_3S_LIPO_2200MAH : type);
+        this->powerTrain = std::make_unique<PowerTrain>(PowerTrain::getBuiltInChemistry(batteryData.chemistry), batteryData.capacityMah, PowerTrainConstants::DEFAULT_BATTERY_CELLS, motor);
+    }
+    this->powerTrainLastUpdateUs = 0;
+    this->enduranceEstimator.reset();
+}
+
+void SimData::loadPowerTrainCatalog()
+{
+    const fs::path directory = Utils::GetPluginDirectory() / "assets" / "powertrain";
+    const fs::path cacheFile = Utils::GetPluginDirectory() / "powertrain_catalog.bin";
+    if (!this->powerTrainCatalog.load(directory, cacheFile))
+    {
+        Utils::LOG("Power train catalog: {}, using the built-in motor and batteries", this->powerTrainCatalog.getError());
+        return;
+    }
+
+    Utils::LOG("Power train catalog: {} motor / propeller combinations, {} packs{}", this->powerTrainCatalog.getPropulsions().size(),
+               this->powerTrainCatalog.getPacks().size(), this->powerTrainCatalog.isLoadedFromCache() ? " (cached)" : "");
+
+    auto eventBus = Plugin()->GetEventBus();
+    for (const TCatalogPropulsion &propulsion : this->powerTrainCatalog.getPropulsions())
+    {
+        eventBus->Publish("PowerTrainCatalogEntry", PowerTrainCatalogEntryEventArg("propulsion", propulsion.motor, propulsion.propeller));
+    }
+    for (const TCatalogPack &pack : this->powerTrainCatalog.getPacks())
+    {
+        eventBus->Publish("PowerTrainCatalogEntry", PowerTrainCatalogEntryEventArg("pack", pack.name));
+    }
+}
+
+void SimData::selectAircraftPowerTrain()
+{
+    this->aircraftSection = Utils::ToLower(SettingsSections::SECTION_AIRCRAFT_PREFIX + Utils::GetAircraftName());
+
+    auto settings = Plugin()->Settings();
+    this->aircraftMotor = settings->GetSettingAs<std::string>(this->aircraftSection, SettingsKeys::SETTINGS_AIRCRAFT_MOTOR, "");
+    this->aircraftPropeller = settings->GetSettingAs<std::string>(this->aircraftSection, SettingsKeys::SETTINGS_AIRCRAFT_PROPELLER, "");
+    this->aircraftBatteryPack = settings->GetSettingAs<std::string>(this->aircraftSection, SettingsKeys::SETTINGS_AIRCRAFT_BATTERY_PACK, "");
+    this->setBateryEmulation(this->batEmulation);
 }
 
 uint16_t SimData::calculateRSSI()
@@ -838,8 +1510,13 @@ uint16_t SimData::calculateRSSI()
 
     // Inverse proportional RSSI falloff: RSSI = RSSI_MAX / (1 + (distance / reference_distance))
     const double reference_distance = this->rxRangeKm / 2.0;
-    const double rssi_value = SimDataConstants::RSSI_MAX_VALUE /
-                              (1.0 + (distance_km / reference_distance));
+    double rssi_value = SimDataConstants::RSSI_MAX_VALUE /
+                        (1.0 + (distance_km / reference_distance));
+
+    if (this->rssiTerrain)
+    {
+        rssi_value *= pow(10.0, -this->terrainLineOfSight.getLossDb() / 20.0);
+    }
 
     const uint16_t rssi = std::max(0, std::min(SimDataConstants::RSSI_MAX_VALUE, (int)round(rssi_value)));
     
@@ -862,14 +1539,19 @@ void SimData::recalculatePowerTrain()
         return;
     }
 
-    if (this->powerTrainLastUpdate == 0.0)
+    const int64_t t = this->simClock.nowUs();
+    if (this->powerTrainLastUpdateUs == 0)
     {
-        this->powerTrainLastUpdate = Utils::GetTicks() / 1000.0;
+        this->powerTrainLastUpdateUs = t;
         return;
     }
 
-    const float t = Utils::GetTicks() / 1000.0f; // seconds
-    const float dt = t - this->powerTrainLastUpdate;
-    this->powerTrainLastUpdate = t;
-    this->powerTrain->update(SimDataConstants::input_to_float_0_1(this->control_throttle), this->simDataFromXplane.euler.pitch, dt);
+    const double dt = Clock::UsToS(t - this->powerTrainLastUpdateUs);
+    this->powerTrainLastUpdateUs = t;
+    const double throttle = SimDataConstants::input_to_float_0_1(this->control_throttle);
+    this->powerTrain->update(throttle, this->simDataFromXplane.euler.pitch, dt);
+
+    // Bounded number of prediction steps per call
+    this->enduranceEstimator.record(throttle, this->simDataFromXplane.euler.pitch, dt);
+    this->enduranceEstimator.update(*this->powerTrain);
 }
@@ -5,9 +5,22 @@
 #include <array>
 
 #include "PowerTrain.h"
+#include "PowerTrainCatalog.h"
+#include "EnduranceEstimator.h"
 #include "MSP.h"
 #include "Utils.h"
 #include "MathUtils.h"
+#include "SimDataRefs.h"
+#include "SensorPipeline.h"
+#include "MagneticModel.h"
+#include "GpsReceiver.h"
+#include "TerrainLineOfSight.h"
+#include "Rangefinder.h"
+#include "SensorPacket.h"
+#include "SimTrace.h"
+#include "DebugAssembler.h"
+#include "AttitudeErrorStatistics.h"
+#include "core/Clock.h"
 
 using namespace MathUtils;
 
@@ -29,8 +42,13 @@ namespace SimDataConstants
     static constexpr int GPS_GLITCH_OFFSET = 2;
     static constexpr int GPS_GLITCH_LINEAR = 3;
     static constexpr int GPS_GLITCH_ALTITUDE = 4;
+
+    // Sensor noise levels
+    static constexpr int SENSOR_NOISE_OFF = 0;
+    static constexpr int SENSOR_NOISE_LOW = 1;
+    static constexpr int SENSOR_NOISE_HIGH = 2;
     // RC Input
-    static constexpr int RC_INPUT_CHANNELS = 8;
+    static constexpr int RC_INPUT_CHANNELS = SensorPacketConstants::RC_INPUT_CHANNELS;
 
     // RC Channel indices
     static constexpr int RC_CHANNEL_ROLL = 0;
@@ -53,6 +71,7 @@ typedef enum
     BATTERY_3S_LIPO_4400MAH = 3,
     BATTERY_3S_LION_5200MAH = 4,
     BATTERY_3S_LION_10400MAH = 5,
+    BATTERY_AIRCRAFT_PACK = 6,      // pack from the catalog, selected per aircraft in the settings
 } BatteryEmulationType;
 
 typedef enum
@@ -70,91 +89,18 @@ typedef enum
     RANGEFINDER_FAILURE = 2
 } TRangefinderSimulation;
 
-// In Xplane format: floating point data
-struct TSimdata
-{
-    int numSats;
-    int fixType;
-    float airspeed;
-    float latitude;
-    float longitude;
-    float elevation;
-    float speed;
-    float course;
-    vector3D acceleration;
-    vector3D gyro;
-    eulerAngles euler;
-    vector3D velNED;
-    vector3D mag;
-    float baro;
-    uint16_t rangefinder_distance_cm;
-    float battery_voltage;
-    float current_consumption;
-};
-
-#pragma pack(1)
-
-struct TMSPSimultatorToINAVHeader
-{
-    uint8_t version; // MSP_SIMULATOR_VERSION
-    uint16_t flags; // TSimulatorFlags
-};
-
-struct TMSPSimulatorToINAV
-{
-    TMSPSimultatorToINAVHeader header;
-
-    uint8_t fix;
-    uint8_t numSat;
-    int32_t lat;
-    int32_t lon;
-    int32_t alt;
-    int16_t speed;
-    int16_t course;
-    int16_t velNED[3];
-
-    int16_t roll;
-    int16_t pitch;
-    int16_t yaw;
-
-    int16_t accel_x;
-    int16_t accel_y;
-    int16_t accel_z;
-
-    int16_t gyro_x;
-    int16_t gyro_y;
-    int16_t gyro_z;
-
-    int32_t baro;
-
-    int16_t mag_x;
-    int16_t mag_y;
-    int16_t mag_z;
-
-    // SIMU_EXT_BATTERY_VOLTAGE in format 2
-    uint8_t vbat;      // 126->12.6V
-    uint16_t airspeed; // cm/s
-
-    uint16_t rangefinder_distance_cm; // cm
-
-    uint16_t current;
-
-    // RC inputs
-    uint16_t rc_inputs[SimDataConstants::RC_INPUT_CHANNELS];
-    uint16_t rssi;
-};
-#pragma pack()
+class SensorSender;
 
 class SimData
 {
 public:
     SimData();
+    ~SimData();
 
 private:
     //---- gps ---
 
     bool GPSHasNewData;
-    uint32_t gps_lastUpdate;
 
     int gps_fix;
     int gps_glitch;
@@ -162,95 +108,42 @@ private:
 
     bool simulate_mag_failure;
 
-    // degrees, the latitude of the aircraft
-    XPLMDataRef df_latitude;
-
-    // degrees, the longitude of the aircraft
-    XPLMDataRef df_longitude;
-
-    // meters, the elevation above MSL of the aircraft
-    XPLMDataRef df_elevation;
-    XPLMDataRef df_agl;
-
-    // meters/s, The velocity in local OGL coordinates
-    XPLMDataRef df_local_vx;
-
-    XPLMDataRef df_local_vy;
-
-    XPLMDataRef df_local_vz;
-
-    // meters, altitude Above Ground Level
-    // XPLMDataRef df_agl;
-    // float agl;
-
-    // meters/sec, the ground speed of the aircraft
-    XPLMDataRef df_speed;
-
-    // degrees, the true heading of the aircraft in degrees from the Z axis - OpenGL coordinates
-    XPLMDataRef df_hpath;
-
-    // degrees, the roll of the aircraft in degrees - OpenGL coordinates
-    XPLMDataRef df_roll;
-    // degrees, the pitch relative to the plane normal to the Y axis in degrees - OpenGL coordinates
-    XPLMDataRef df_pitch;
-
-    // degrees, the true heading of the aircraft in degrees from the Z axis - OpenGL coordinates
-    XPLMDataRef df_yaw;
-
-    // accel
-    // Gs, total g-forces on the plane as a multiple, along the plane, forward - negative
-    XPLMDataRef df_accel_x;
-
-    // Gs, total g-forces on the plane as a multiple, sideways, right - negative
-    XPLMDataRef df_accel_y;
-
-    // Gs, Total g-forces on the plane as a multiple, downward
-    XPLMDataRef df_accel_z;
-
-    // gyro
-    // degrees, the roll of the aircraft in degrees - OpenGL coordinates
-    XPLMDataRef df_gyro_x;
-    // deg/sec, the pitch rotation rates (relative to the flight)
-    XPLMDataRef df_gyro_y;
-    float gyro_y;
-
-    // deg/sec	The yaw rotation rates (relative to the flight)
-    XPLMDataRef df_gyro_z;
-
-    // baro
-    // 29.92+-....	This is the barometric pressure at the point the current flight is at.
-    XPLMDataRef df_baro;
+    // Batched reads and coalesced writes of all X-Plane datarefs
+    SimDataRefs dataRefs;
+    TXPlaneSnapshot xplane;
+    float dataRefReadTimeUs = 0.0f;
 
     // RC Inputs
-    XPLMDataRef df_hasJoystick;
     bool hasJoystick = false;
-    XPLMDataRef df_rc_inputs;
     float rc_inputs[SimDataConstants::RC_INPUT_CHANNELS];
 
     TPitotSimulation simulatePitot;
 
-    // meters/sec, the ground speed of the aircraft
-    XPLMDataRef df_airspeed;
+    // Failures and noise, applied once per cycle to simDataFromXplane, result in simDataOut
+    SensorPipeline sensorPipeline;
+    int sensorNoise = SimDataConstants::SENSOR_NOISE_OFF;
+    uint64_t sensorNoiseSeed = 1;
 
-    double glitch_lattitude = 0;
-    double glitch_longitude = 0;
-    double glitch_elevation = 0;
+    // Rate, latency and satellites of the simulated receiver, feeds the GPS values of simDataFromXplane
+    GpsReceiver gpsReceiver;
+    int gpsNumSats = 12;
+    int gpsRateHz = GpsReceiverConstants::DEFAULT_RATE_HZ;
+    int gpsLatencyMs = 0;
+    int gpsJitterMs = 0;
+    bool gpsSendVelocities = true;
+    float gpsHdop = 0.0f;
 
-    //---- from inav --------
+    // Earth field at the aircraft position, from assets/wmm_grid.bin or the built-in model
+    MagneticModel magneticModel;
+    float magDeclination = 0.0f;
 
-    XPLMDataRef df_override_joystick;
+    //---- from inav --------
 
-    XPLMDataRef df_control_throttle;
     int16_t control_throttle;
-    XPLMDataRef df_control_roll;
     int16_t control_roll;
-    XPLMDataRef df_control_pitch;
     int16_t control_pitch;
-    XPLMDataRef df_control_yaw;
     int16_t control_yaw;
 
-    XPLMDataRef df_heartbeat;
-
     bool isAirplane;
     bool isArmed;
     bool isOSDDisabled;
@@ -266,17 +159,28 @@ private:
     // SITL MSP TCP connection state
     bool isSitlTcpConnected;
 
-    uint32_t lastUpdateMS;
-    uint32_t lastUpdateTimeFlightLoop;
-    uint32_t sitlHartbeatLastTime;
+    int64_t lastUpdateUs;
+    int64_t sitlHartbeatLastTimeUs;
 
     // Powertrain state
 
     BatteryEmulationType batEmulation;
-    double powerTrainLastUpdate = 0;
+    int64_t powerTrainLastUpdateUs = 0; // sim time
     std::unique_ptr<PowerTrain> powerTrain;
+    // Predicted time remaining with the throttle / climb profile of the last minutes
+    EnduranceEstimator enduranceEstimator;
+    // Motors, propellers and packs from assets/powertrain, the power train references its tables
+    PowerTrainCatalog powerTrainCatalog;
+    // Settings section of the user's aircraft and its selection from the catalog
+    std::string aircraftSection;
+    std::string aircraftMotor;
+    std::string aircraftPropeller;
+    std::string aircraftBatteryPack;
 
     TRangefinderSimulation rangefinderSimulation;
+    // Measured along the body down axis at its own rate, feeds rangefinder_distance_cm
+    Rangefinder rangefinder;
+    int rangefinderRateHz = RangefinderConstants::DEFAULT_RATE_HZ;
 
     // Home Location for RSSI emulation
     double homeLocation_latitude = 0.0;
@@ -286,13 +190,51 @@ private:
     double rxRangeKm = SimDataConstants::RSSI_INFINITE_RANGE;
     bool rxIsFailsafe = false;
     bool rxIsFailsafeFromMenu = false;
+    // Diffraction loss of ridges between home and aircraft, applied on top of the range falloff
+    TerrainLineOfSight terrainLineOfSight;
+    bool rssiTerrain = true;
 
-    uint32_t autolaunch_kickStart = 0;
-    float agl;
+    int64_t autolaunch_kickStartUs = 0; // sim time
 
     TSimdata simDataFromXplane;
     TSimdata simDataOut;
 
+    // Fixed rate sender thread, 0 = send synchronous with the flight loop
+    int sensorRateHz = 0;
+    std::unique_ptr<SensorSender> sensorSender;
+    uint32_t sensorSenderStatisticsSequence = 0;
+    uint32_t gpsSequence = 0;
+    uint32_t lastSentGpsSequence = 0;
+    bool sensorExtrapolation = false;
+    int64_t xplaneSampleTimeUs = 0;
+
+    // Wall clock: Clock::NowUs(). Physical processes (battery, sensor drift, autolaunch kick) use
+    // the sim clock, which stops while X-Plane is paused and follows time acceleration. In lockstep
+    // the sensor timing models and the trace use it as well, see modelTimeUs()
+    SimClock simClock;
+
+    // Lockstep: every flight loop cycle waits for the FC reply before X-Plane continues
+    bool lockstep = false;
+    int lockstepSteps = 0;
+    int lockstepTimeouts = 0;
+    int64_t lockstepWindowStartUs = 0;
+    int64_t lockstepWindowSimStartUs = 0;
+
+    // One debug[] channel per reply, assembled into a complete frame per reply
+    DebugAssembler debugAssembler;
+
+    // Every HITL packet and the FC reply to it, played back without X-Plane by tools/TracePlayer.cpp
+    SimTraceWriter traceWriter;
+    TTraceRow traceRow = {};
+    bool traceRowPending = false;
+
+    // Real vs. INAV estimated attitude: over one second for the graph, and since the last arm
+    // (or connection) for the datarefs and the summary written on disarm
+    AttitudeErrorStatistics attitudeErrorWindow;
+    AttitudeErrorStatistics attitudeErrorFlight;
+    int64_t attitudeErrorWindowStartUs = 0;
+    int64_t attitudeErrorFlightStartUs = 0;
+
     void updateFromXPlane();
     void sendToXPlane_HITL();
     void sendToXPlane_SITL();
@@ -302,14 +244,34 @@ private:
 
     void updateFromINAV(const TMSPSimulatorFromINAV &data);
 
+    TSensorSnapshot buildSensorSnapshot();
+    void updateSensorSender();
+    void publishSensorSenderStatistics();
+    void waitForLockstepReply();
+    void resetLockstepStatistics();
+    int64_t modelTimeUs() const;
+    void updateAttitudeEstimationError(const TMSPSimulatorFromINAV &data);
+    void resetAttitudeErrorFlight();
+    void writeAttitudeErrorSummary();
+    void startTraceRecording();
+    void stopTraceRecording();
+    void recordTracePacket(const TSensorSnapshot &snapshot);
+    void recordTraceReply(const TMSPSimulatorFromINAV &data);
+
     float getControllThrottle() const;
     uint16_t calculateRSSI();
 
     void updateDataRefs();
-    void applyHardwareFailures(TSimdata& simData);
+    void configureGpsReceiver();
+    static int gpsFixFromSatellites(int numSats);
+    void configureSensorPipeline();
+    void configureSensorPipeline(TSensorType sensor);
+    void runSensorPipeline();
 
     void disconnect();
 
     void setBateryEmulation(BatteryEmulationType type);
+    void loadPowerTrainCatalog();
+    void selectAircraftPowerTrain();
     void recalculatePowerTrain();
 };
@@ -0,0 +1,171 @@
+#include "SimDataRefs.h"
+
+#include "Utils.h"
+
+namespace SimDataRefsConstants
+{
+    // Declarative list of everything SimData reads from X-Plane.
+    // Array ranges are read with a single XPLMGetDatavf call.
+    static constexpr TDataRefBinding READ_BINDINGS[] = {
+        // Our own Dataref to get INAVs heartbeat in SITL mode
+        {"inav_xitl/plugin/heartbeat", DATAREF_KIND_INT, offsetof(TXPlaneSnapshot, heartbeat), 0, 1, DATAREF_GROUP_FRAME},
+        // Sim clock
+        {"sim/time/paused", DATAREF_KIND_INT, offsetof(TXPlaneSnapshot, paused), 0, 1, DATAREF_GROUP_FRAME},
+        {"sim/time/sim_speed_actual", DATAREF_KIND_FLOAT, offsetof(TXPlaneSnapshot, simSpeed), 0, 1, DATAREF_GROUP_FRAME},
+
+        {"sim/flightmodel/position/latitude", DATAREF_KIND_DOUBLE, offsetof(TXPlaneSnapshot, latitude), 0, 1, DATAREF_GROUP_GPS},
+        {"sim/flightmodel/position/longitude", DATAREF_KIND_DOUBLE, offsetof(TXPlaneSnapshot, longitude), 0, 1, DATAREF_GROUP_GPS},
+        {"sim/flightmodel/position/elevation", DATAREF_KIND_DOUBLE, offsetof(TXPlaneSnapshot, elevation), 0, 1, DATAREF_GROUP_GPS},
+        {"sim/flightmodel/position/local_vx", DATAREF_KIND_FLOAT, offsetof(TXPlaneSnapshot, local_vx), 0, 1, DATAREF_GROUP_GPS},
+        {"sim/flightmodel/position/local_vy", DATAREF_KIND_FLOAT, offsetof(TXPlaneSnapshot, local_vy), 0, 1, DATAREF_GROUP_GPS},
+        {"sim/flightmodel/position/local_vz", DATAREF_KIND_FLOAT, offsetof(TXPlaneSnapshot, local_vz), 0, 1, DATAREF_GROUP_GPS},
+        {"sim/flightmodel/position/groundspeed", DATAREF_KIND_FLOAT, offsetof(TXPlaneSnapshot, groundspeed), 0, 1, DATAREF_GROUP_GPS},
+        {"sim/flightmodel/position/true_airspeed", DATAREF_KIND_FLOAT, offsetof(TXPlaneSnapshot, airspeed), 0, 1, DATAREF_GROUP_GPS},
+        {"sim/flightmodel/position/hpath", DATAREF_KIND_FLOAT, offsetof(TXPlaneSnapshot, hpath), 0, 1, DATAREF_GROUP_GPS},
+
+        {"sim/flightmodel/position/phi", DATAREF_KIND_FLOAT, offsetof(TXPlaneSnapshot, roll), 0, 1, DATAREF_GROUP_FRAME},
+        {"sim/flightmodel/position/theta", DATAREF_KIND_FLOAT, offsetof(TXPlaneSnapshot, pitch), 0, 1, DATAREF_GROUP_FRAME},
+        {"sim/flightmodel/position/psi", DATAREF_KIND_FLOAT, offsetof(TXPlaneSnapshot, yaw), 0, 1, DATAREF_GROUP_FRAME},
+        // Accelerometer
+        {"sim/flightmodel/forces/g_axil", DATAREF_KIND_FLOAT, offsetof(TXPlaneSnapshot, accel_x), 0, 1, DATAREF_GROUP_FRAME},
+        {"sim/flightmodel/forces/g_side", DATAREF_KIND_FLOAT, offsetof(TXPlaneSnapshot, accel_y), 0, 1, DATAREF_GROUP_FRAME},
+        {"sim/flightmodel/forces/g_nrml", DATAREF_KIND_FLOAT, offsetof(TXPlaneSnapshot, accel_z), 0, 1, DATAREF_GROUP_FRAME},
+        // Gyro
+        {"sim/flightmodel/position/P", DATAREF_KIND_FLOAT, offsetof(TXPlaneSnapshot, gyro_p), 0, 1, DATAREF_GROUP_FRAME},
+        {"sim/flightmodel/position/Q", DATAREF_KIND_FLOAT, offsetof(TXPlaneSnapshot, gyro_q), 0, 1, DATAREF_GROUP_FRAME},
+        {"sim/flightmodel/position/R", DATAREF_KIND_FLOAT, offsetof(TXPlaneSnapshot, gyro_r), 0, 1, DATAREF_GROUP_FRAME},
+        // Barometer
+        {"sim/weather/barometer_current_inhg", DATAREF_KIND_FLOAT, offsetof(TXPlaneSnapshot, baro), 0, 1, DATAREF_GROUP_FRAME},
+
+        // Rangefinder
+        {"sim/flightmodel/position/local_x", DATAREF_KIND_DOUBLE, offsetof(TXPlaneSnapshot, local_x), 0, 1, DATAREF_GROUP_RANGEFINDER},
+        {"sim/flightmodel/position/local_y", DATAREF_KIND_DOUBLE, offsetof(TXPlaneSnapshot, local_y), 0, 1, DATAREF_GROUP_RANGEFINDER},
+        {"sim/flightmodel/position/local_z", DATAREF_KIND_DOUBLE, offsetof(TXPlaneSnapshot, local_z), 0, 1, DATAREF_GROUP_RANGEFINDER},
+
+        // RC Inputs
+        {"sim/joystick/has_joystick", DATAREF_KIND_INT, offsetof(TXPlaneSnapshot, hasJoystick), 0, 1, DATAREF_GROUP_RC},
+        {"sim/joystick/joy_mapped_axis_value", DATAREF_KIND_FLOAT_ARRAY, offsetof(TXPlaneSnapshot, joyAttitude), JOY_AXIS_ATTITUDE_FIRST, JOY_AXIS_ATTITUDE_COUNT, DATAREF_GROUP_RC},
+        {"sim/joystick/joy_mapped_axis_value", DATAREF_KIND_FLOAT_ARRAY, offsetof(TXPlaneSnapshot, joyThrottleAux), JOY_AXIS_THROTTLE_AUX_FIRST, JOY_AXIS_THROTTLE_AUX_COUNT, DATAREF_GROUP_RC},
+    };
+
+    static constexpr size_t READ_BINDING_COUNT = sizeof(READ_BINDINGS) / sizeof(READ_BINDINGS[0]);
+    static_assert(READ_BINDING_COUNT <= MAX_READ_BINDINGS, "Increase MAX_READ_BINDINGS");
+
+    struct TWriteBinding
+    {
+        const char *name;
+        bool isInt;
+    };
+
+    // Indexed by TDataRefWriteSlot
+    static constexpr TWriteBinding WRITE_BINDINGS[DATAREF_WRITE_COUNT] = {
+        {"inav_xitl/plugin/heartbeat", true},
+        {"sim/operation/override/override_joystick", true},
+        {"sim/cockpit2/engine/actuators/throttle_ratio_all", false},
+        {"sim/joystick/yoke_roll_ratio", false},
+        {"sim/joystick/yoke_pitch_ratio", false},
+        {"sim/joystick/yoke_heading_ratio", false},
+    };
+}
+
+SimDataRefs::SimDataRefs()
+{
+    this->readDataRefs.fill(nullptr);
+    for (size_t i = 0; i < SimDataRefsConstants::READ_BINDING_COUNT; i++)
+    {
+        this->readDataRefs[i] = XPLMFindDataRef(SimDataRefsConstants::READ_BINDINGS[i].name);
+        if (this->readDataRefs[i] == nullptr)
+        {
+            Utils::LOG("Dataref not found: {}", SimDataRefsConstants::READ_BINDINGS[i].name);
+        }
+    }
+
+    for (int i = 0; i < DATAREF_WRITE_COUNT; i++)
+    {
+        this->writeSlots[i].dataRef = XPLMFindDataRef(SimDataRefsConstants::WRITE_BINDINGS[i].name);
+        this->writeSlots[i].isInt = SimDataRefsConstants::WRITE_BINDINGS[i].isInt;
+        this->writeSlots[i].dirty = false;
+        this->writeSlots[i].intValue = 0;
+        this->writeSlots[i].floatValue = 0.0f;
+    }
+}
+
+void SimDataRefs::read(TXPlaneSnapshot &snapshot, uint32_t groups) const
+{
+    uint8_t *base = reinterpret_cast<uint8_t *>(&snapshot);
+    int calls = 0;
+
+    for (size_t i = 0; i < SimDataRefsConstants::READ_BINDING_COUNT; i++)
+    {
+        const TDataRefBinding &binding = SimDataRefsConstants::READ_BINDINGS[i];
+        XPLMDataRef dataRef = this->readDataRefs[i];
+
+        if ((binding.groups & groups) == 0 || dataRef == nullptr)
+        {
+            continue;
+        }
+
+        void *target = base + binding.offset;
+        switch (binding.kind)
+        {
+        case DATAREF_KIND_INT:
+            *static_cast<int *>(target) = XPLMGetDatai(dataRef);
+            break;
+        case DATAREF_KIND_FLOAT:
+            *static_cast<float *>(target) = XPLMGetDataf(dataRef);
+            break;
+        case DATAREF_KIND_DOUBLE:
+            *static_cast<double *>(target) = XPLMGetDatad(dataRef);
+            break;
+        case DATAREF_KIND_FLOAT_ARRAY:
+            XPLMGetDatavf(dataRef, static_cast<float *>(target), binding.index, binding.count);
+            break;
+        }
+        calls++;
+    }
+
+    this->readCallsLastCycle = calls;
+}
+
+void SimDataRefs::setInt(TDataRefWriteSlot slot, int value)
+{
+    TWriteSlot &writeSlot = this->writeSlots[slot];
+    writeSlot.intValue = value;
+    writeSlot.dirty = true;
+}
+
+void SimDataRefs::setFloat(TDataRefWriteSlot slot, float value)
+{
+    TWriteSlot &writeSlot = this->writeSlots[slot];
+    writeSlot.floatValue = value;
+    writeSlot.dirty = true;
+}
+
+void SimDataRefs::flush()
+{
+    int calls = 0;
+    for (TWriteSlot &slot : this->writeSlots)
+    {
+        if (!slot.dirty)
+        {
+            continue;
+        }
+
+        slot.dirty = false;
+        if (slot.dataRef == nullptr)
+        {
+            continue;
+        }
+
+        if (slot.isInt)
+        {
+            XPLMSetDatai(slot.dataRef, slot.intValue);
+        }
+        else
+        {
+            XPLMSetDataf(slot.dataRef, slot.floatValue);
+        }
+        calls++;
+    }
+    this->writeCallsLastFlush = calls;
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "platform.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <XPLMDataAccess.h>
+
+// Groups of datarefs that are read together, SimData decides per cycle which groups are needed
+typedef enum
+{
+    DATAREF_GROUP_FRAME = 1 << 0, // every cycle
+    DATAREF_GROUP_GPS = 1 << 1,   // at GPS rate only
+    DATAREF_GROUP_RC = 1 << 2,    // HITL only, joystick as RC input
+    DATAREF_GROUP_RANGEFINDER = 1 << 3, // at rangefinder rate only
+} TDataRefGroup;
+
+typedef enum
+{
+    DATAREF_KIND_INT,
+    DATAREF_KIND_FLOAT,
+    DATAREF_KIND_DOUBLE,
+    DATAREF_KIND_FLOAT_ARRAY,
+} TDataRefKind;
+
+// Datarefs written back to X-Plane, each slot is flushed at most once per frame
+typedef enum
+{
+    DATAREF_WRITE_HEARTBEAT = 0,
+    DATAREF_WRITE_OVERRIDE_JOYSTICK,
+    DATAREF_WRITE_THROTTLE,
+    DATAREF_WRITE_ROLL,
+    DATAREF_WRITE_PITCH,
+    DATAREF_WRITE_YAW,
+    DATAREF_WRITE_COUNT
+} TDataRefWriteSlot;
+
+namespace SimDataRefsConstants
+{
+    // sim/joystick/joy_mapped_axis_value: 1 = pitch, 2 = roll, 3 = yaw
+    static constexpr int JOY_AXIS_ATTITUDE_FIRST = 1;
+    static constexpr int JOY_AXIS_ATTITUDE_COUNT = 3;
+    // sim/joystick/joy_mapped_axis_value: 57 = throttle, 58 - 61 = AUX1 - AUX4
+    static constexpr int JOY_AXIS_THROTTLE_AUX_FIRST = 57;
+    static constexpr int JOY_AXIS_THROTTLE_AUX_COUNT = 5;
+
+    static constexpr size_t MAX_READ_BINDINGS = 32;
+}
+
+// Plain copy of all X-Plane datarefs SimData needs in one cycle
+struct TXPlaneSnapshot
+{
+    int heartbeat;
+    int paused;
+    float simSpeed; // actual time acceleration achieved by X-Plane
+
+    // GPS group
+    double latitude;
+    double longitude;
+    double elevation;
+    float local_vx;
+    float local_vy;
+    float local_vz;
+    float groundspeed;
+    float airspeed;
+    float hpath;
+
+    // Frame group
+    float roll;
+    float pitch;
+    float yaw;
+    float accel_x;
+    float accel_y;
+    float accel_z;
+    float gyro_p;
+    float gyro_q;
+    float gyro_r;
+    float baro;
+
+    // Rangefinder group, X-Plane local OpenGL coordinates
+    double local_x;
+    double local_y;
+    double local_z;
+
+    // RC group
+    int hasJoystick;
+    float joyAttitude[SimDataRefsConstants::JOY_AXIS_ATTITUDE_COUNT];      // pitch, roll, yaw
+    float joyThrottleAux[SimDataRefsConstants::JOY_AXIS_THROTTLE_AUX_COUNT]; // throttle, AUX1 - AUX4
+};
+
+struct TDataRefBinding
+{
+    const char *name;
+    TDataRefKind kind;
+    size_t offset; // offset into TXPlaneSnapshot
+    int index;     // first array element, arrays only
+    int count;     // number of array elements, arrays only
+    uint32_t groups;
+};
+
+class SimDataRefs
+{
+public:
+    SimDataRefs();
+
+    // Reads all bindings belonging to one of the given groups into the snapshot
+    void read(TXPlaneSnapshot &snapshot, uint32_t groups) const;
+
+    void setInt(TDataRefWriteSlot slot, int value);
+    void setFloat(TDataRefWriteSlot slot, float value);
+
+    // Writes every slot set since the last flush once, the last value set wins
+    void flush();
+
+    int getReadCallsLastCycle() const { return this->readCallsLastCycle; }
+    int getWriteCallsLastFlush() const { return this->writeCallsLastFlush; }
+
+private:
+    struct TWriteSlot
+    {
+        XPLMDataRef dataRef;
+        bool isInt;
+        bool dirty;
+        int intValue;
+        float floatValue;
+    };
+
+    std::array<XPLMDataRef, SimDataRefsConstants::MAX_READ_BINDINGS> readDataRefs;
+    std::array<TWriteSlot, DATAREF_WRITE_COUNT> writeSlots;
+
+    mutable int readCallsLastCycle = 0;
+    int writeCallsLastFlush = 0;
+};
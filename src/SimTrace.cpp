@@ -0,0 +1,304 @@
+#include "SimTrace.h"
+
+#include <bit>
+#include <cstddef>
+#include <cstring>
+
+static_assert(std::endian::native == std::endian::little, "Trace files are written in host byte order");
+
+namespace SimTrace
+{
+    static const std::vector<TTraceColumn> COLUMNS = {
+        {"time_us", TRACE_I64, offsetof(TTraceRow, timeUs)},
+
+        // TSimdata after the sensor pipeline, as sent to INAV
+        {"num_sats", TRACE_I32, offsetof(TTraceRow, snapshot.simData.numSats)},
+        {"fix_type", TRACE_I32, offsetof(TTraceRow, snapshot.simData.fixType)},
+        {"airspeed", TRACE_F32, offsetof(TTraceRow, snapshot.simData.airspeed)},
+        {"latitude", TRACE_F32, offsetof(TTraceRow, snapshot.simData.latitude)},
+        {"longitude", TRACE_F32, offsetof(TTraceRow, snapshot.simData.longitude)},
+        {"elevation", TRACE_F32, offsetof(TTraceRow, snapshot.simData.elevation)},
+        {"speed", TRACE_F32, offsetof(TTraceRow, snapshot.simData.speed)},
+        {"course", TRACE_F32, offsetof(TTraceRow, snapshot.simData.course)},
+        {"acc_x", TRACE_F32, offsetof(TTraceRow, snapshot.simData.acceleration.x)},
+        {"acc_y", TRACE_F32, offsetof(TTraceRow, snapshot.simData.acceleration.y)},
+        {"acc_z", TRACE_F32, offsetof(TTraceRow, snapshot.simData.acceleration.z)},
+        {"gyro_x", TRACE_F32, offsetof(TTraceRow, snapshot.simData.gyro.x)},
+        {"gyro_y", TRACE_F32, offsetof(TTraceRow, snapshot.simData.gyro.y)},
+        {"gyro_z", TRACE_F32, offsetof(TTraceRow, snapshot.simData.gyro.z)},
+        {"roll", TRACE_F32, offsetof(TTraceRow, snapshot.simData.euler.roll)},
+        {"pitch", TRACE_F32, offsetof(TTraceRow, snapshot.simData.euler.pitch)},
+        {"yaw", TRACE_F32, offsetof(TTraceRow, snapshot.simData.euler.yaw)},
+        {"vel_n", TRACE_F32, offsetof(TTraceRow, snapshot.simData.velNED.x)},
+        {"vel_e", TRACE_F32, offsetof(TTraceRow, snapshot.simData.velNED.y)},
+        {"vel_d", TRACE_F32, offsetof(TTraceRow, snapshot.simData.velNED.z)},
+        {"mag_x", TRACE_F32, offsetof(TTraceRow, snapshot.simData.mag.x)},
+        {"mag_y", TRACE_F32, offsetof(TTraceRow, snapshot.simData.mag.y)},
+        {"mag_z", TRACE_F32, offsetof(TTraceRow, snapshot.simData.mag.z)},
+        {"baro", TRACE_F32, offsetof(TTraceRow, snapshot.simData.baro)},
+        {"rangefinder_cm", TRACE_U16, offsetof(TTraceRow, snapshot.simData.rangefinder_distance_cm)},
+
+        // Rest of the packet
+        {"flags", TRACE_U16, offsetof(TTraceRow, snapshot.flags)},
+        {"fix", TRACE_U8, offsetof(TTraceRow, snapshot.fix)},
+        {"gps_sequence", TRACE_U32, offsetof(TTraceRow, snapshot.gpsSequence)},
+        {"gps_velocities", TRACE_U8, offsetof(TTraceRow, snapshot.gpsVelocities)},
+        {"battery_voltage", TRACE_F32, offsetof(TTraceRow, snapshot.batteryVoltage)},
+        {"battery_current", TRACE_F32, offsetof(TTraceRow, snapshot.batteryCurrent)},
+        {"rc_1", TRACE_U16, offsetof(TTraceRow, snapshot.rc_inputs[0])},
+        {"rc_2", TRACE_U16, offsetof(TTraceRow, snapshot.rc_inputs[1])},
+        {"rc_3", TRACE_U16, offsetof(TTraceRow, snapshot.rc_inputs[2])},
+        {"rc_4", TRACE_U16, offsetof(TTraceRow, snapshot.rc_inputs[3])},
+        {"rc_5", TRACE_U16, offsetof(TTraceRow, snapshot.rc_inputs[4])},
+        {"rc_6", TRACE_U16, offsetof(TTraceRow, snapshot.rc_inputs[5])},
+        {"rc_7", TRACE_U16, offsetof(TTraceRow, snapshot.rc_inputs[6])},
+        {"rc_8", TRACE_U16, offsetof(TTraceRow, snapshot.rc_inputs[7])},
+        {"rssi", TRACE_U16, offsetof(TTraceRow, snapshot.rssi)},
+
+        // FC reply
+        {"reply_time_us", TRACE_I64, offsetof(TTraceRow, replyTimeUs)},
+        {"output_roll", TRACE_I16, offsetof(TTraceRow, outputRoll)},
+        {"output_pitch", TRACE_I16, offsetof(TTraceRow, outputPitch)},
+        {"output_yaw", TRACE_I16, offsetof(TTraceRow, outputYaw)},
+        {"output_throttle", TRACE_I16, offsetof(TTraceRow, outputThrottle)},
+        {"debug_index", TRACE_U8, offsetof(TTraceRow, debugIndex)},
+        {"debug_value", TRACE_I32, offsetof(TTraceRow, debugValue)},
+        {"estimated_roll", TRACE_I16, offsetof(TTraceRow, estimatedRoll)},
+        {"estimated_pitch", TRACE_I16, offsetof(TTraceRow, estimatedPitch)},
+        {"estimated_yaw", TRACE_I16, offsetof(TTraceRow, estimatedYaw)},
+    };
+
+    const std::vector<TTraceColumn> &columns()
+    {
+        return COLUMNS;
+    }
+
+    size_t columnTypeSize(TTraceColumnType type)
+    {
+        switch (type)
+        {
+        case TRACE_U8:
+            return 1;
+        case TRACE_I16:
+        case TRACE_U16:
+            return 2;
+        case TRACE_I32:
+        case TRACE_U32:
+        case TRACE_F32:
+            return 4;
+        case TRACE_I64:
+            return 8;
+        default:
+            return 0;
+        }
+    }
+}
+
+SimTraceWriter::~SimTraceWriter()
+{
+    this->close();
+}
+
+bool SimTraceWriter::open(const std::string &fileName)
+{
+    this->close();
+
+    this->file = fopen(fileName.c_str(), "wb");
+    if (this->file == nullptr)
+    {
+        return false;
+    }
+
+    const std::vector<TTraceColumn> &columns = SimTrace::columns();
+    const uint16_t version = SimTraceConstants::FILE_VERSION;
+    const uint16_t columnCount = static_cast<uint16_t>(columns.size());
+    fwrite(SimTraceConstants::FILE_MAGIC, sizeof(SimTraceConstants::FILE_MAGIC), 1, this->file);
+    fwrite(&version, sizeof(version), 1, this->file);
+    fwrite(&columnCount, sizeof(columnCount), 1, this->file);
+    for (const TTraceColumn &column : columns)
+    {
+        const uint8_t type = column.type;
+        const uint8_t nameLength = static_cast<uint8_t>(strlen(column.name));
+        fwrite(&type, sizeof(type), 1, this->file);
+        fwrite(&nameLength, sizeof(nameLength), 1, this->file);
+        fwrite(column.name, nameLength, 1, this->file);
+    }
+
+    this->rows.clear();
+    this->rows.reserve(SimTraceConstants::BLOCK_ROWS);
+    this->rowCount = 0;
+    return true;
+}
+
+void SimTraceWriter::close()
+{
+    if (this->file == nullptr)
+    {
+        return;
+    }
+
+    this->writeBlock();
+    fclose(this->file);
+    this->file = nullptr;
+}
+
+void SimTraceWriter::append(const TTraceRow &row)
+{
+    if (this->file == nullptr)
+    {
+        return;
+    }
+
+    this->rows.push_back(row);
+    this->rowCount++;
+    if (this->rows.size() >= SimTraceConstants::BLOCK_ROWS)
+    {
+        this->writeBlock();
+    }
+}
+
+void SimTraceWriter::writeBlock()
+{
+    if (this->rows.empty())
+    {
+        return;
+    }
+
+    const uint32_t count = static_cast<uint32_t>(this->rows.size());
+    fwrite(&count, sizeof(count), 1, this->file);
+
+    for (const TTraceColumn &column : SimTrace::columns())
+    {
+        const size_t size = SimTrace::columnTypeSize(column.type);
+        this->blockBuffer.resize(size * count);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            std::memcpy(this->blockBuffer.data() + i * size, reinterpret_cast<const uint8_t *>(&this->rows[i]) + column.offset, size);
+        }
+        fwrite(this->blockBuffer.data(), this->blockBuffer.size(), 1, this->file);
+    }
+
+    this->rows.clear();
+}
+
+SimTraceReader::~SimTraceReader()
+{
+    this->close();
+}
+
+bool SimTraceReader::open(const std::string &fileName)
+{
+    this->close();
+
+    this->file = fopen(fileName.c_str(), "rb");
+    if (this->file == nullptr)
+    {
+        return false;
+    }
+
+    char magic[sizeof(SimTraceConstants::FILE_MAGIC)];
+    uint16_t version = 0;
+    uint16_t columnCount = 0;
+    if (fread(magic, sizeof(magic), 1, this->file) != 1 ||
+        std::memcmp(magic, SimTraceConstants::FILE_MAGIC, sizeof(magic)) != 0 ||
+        fread(&version, sizeof(version), 1, this->file) != 1 ||
+        version != SimTraceConstants::FILE_VERSION ||
+        fread(&columnCount, sizeof(columnCount), 1, this->file) != 1)
+    {
+        this->close();
+        return false;
+    }
+
+    for (int i = 0; i < columnCount; i++)
+    {
+        uint8_t type = 0;
+        uint8_t nameLength = 0;
+        char name[256];
+        if (fread(&type, sizeof(type), 1, this->file) != 1 ||
+            fread(&nameLength, sizeof(nameLength), 1, this->file) != 1 ||
+            fread(name, 1, nameLength, this->file) != nameLength ||
+            SimTrace::columnTypeSize(static_cast<TTraceColumnType>(type)) == 0)
+        {
+            this->close();
+            return false;
+        }
+        name[nameLength] = '\0';
+
+        TFileColumn fileColumn = {static_cast<TTraceColumnType>(type), nullptr};
+        for (const TTraceColumn &column : SimTrace::columns())
+        {
+            if (column.type == fileColumn.type && strcmp(column.name, name) == 0)
+            {
+                fileColumn.column = &column;
+                break;
+            }
+        }
+        if (fileColumn.column == nullptr)
+        {
+            this->unknownColumns.push_back(name);
+        }
+        this->fileColumns.push_back(fileColumn);
+    }
+
+    return true;
+}
+
+void SimTraceReader::close()
+{
+    if (this->file != nullptr)
+    {
+        fclose(this->file);
+        this->file = nullptr;
+    }
+    this->fileColumns.clear();
+    this->unknownColumns.clear();
+    this->rows.clear();
+    this->rowIndex = 0;
+}
+
+bool SimTraceReader::read(TTraceRow &row)
+{
+    if (this->rowIndex >= this->rows.size() && !this->readBlock())
+    {
+        return false;
+    }
+
+    row = this->rows[this->rowIndex++];
+    return true;
+}
+
+bool SimTraceReader::readBlock()
+{
+    this->rows.clear();
+    this->rowIndex = 0;
+
+    uint32_t count = 0;
+    if (this->file == nullptr || fread(&count, sizeof(count), 1, this->file) != 1 || count == 0)
+    {
+        return false;
+    }
+
+    // Columns this version doesn't know stay zero
+    this->rows.assign(count, TTraceRow{});
+    for (const TFileColumn &fileColumn : this->fileColumns)
+    {
+        const size_t size = SimTrace::columnTypeSize(fileColumn.type);
+        this->blockBuffer.resize(size * count);
+        if (fread(this->blockBuffer.data(), this->blockBuffer.size(), 1, this->file) != 1)
+        {
+            this->rows.clear();
+            return false;
+        }
+
+        if (fileColumn.column == nullptr)
+        {
+            continue;
+        }
+        for (uint32_t i = 0; i < count; i++)
+        {
+            std::memcpy(reinterpret_cast<uint8_t *>(&this->rows[i]) + fileColumn.column->offset, this->blockBuffer.data() + i * size, size);
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "SensorPacket.h"
+
+namespace SimTraceConstants
+{
+    static constexpr char FILE_MAGIC[4] = {'X', 'T', 'R', 'C'};
+    static constexpr uint16_t FILE_VERSION = 1;
+    static constexpr const char *FILE_EXTENSION = ".xtrace";
+
+    // Rows per block, every block stores its columns one after another
+    static constexpr int BLOCK_ROWS = 1024;
+}
+
+typedef enum : uint8_t
+{
+    TRACE_U8,
+    TRACE_I16,
+    TRACE_U16,
+    TRACE_I32,
+    TRACE_U32,
+    TRACE_I64,
+    TRACE_F32,
+} TTraceColumnType;
+
+// One HITL cycle: the packet sent to INAV and the last reply received before the next one
+struct TTraceRow
+{
+    int64_t timeUs; // Clock::NowUs() when the packet was sent
+    TSensorSnapshot snapshot;
+
+    int64_t replyTimeUs; // 0 if no reply arrived before the next packet
+    int16_t outputRoll;
+    int16_t outputPitch;
+    int16_t outputYaw;
+    int16_t outputThrottle;
+    uint8_t debugIndex;
+    int32_t debugValue;
+    int16_t estimatedRoll;
+    int16_t estimatedPitch;
+    int16_t estimatedYaw;
+};
+
+struct TTraceColumn
+{
+    const char *name;
+    TTraceColumnType type;
+    size_t offset; // in TTraceRow
+};
+
+/**
+ * @brief Binary columnar trace of the HITL sensor packets and the FC control outputs.
+ *
+ * File layout, little endian: magic, version, column count, then per column its type and name.
+ * Rows follow in blocks of up to BLOCK_ROWS: the row count, then all values of the first column,
+ * all values of the second column and so on. Columns are matched by name when reading, so traces
+ * stay readable when columns are added or removed.
+ */
+class SimTraceWriter
+{
+public:
+    SimTraceWriter() = default;
+    ~SimTraceWriter();
+
+    bool open(const std::string &fileName);
+    void close();
+    bool isOpen() const { return this->file != nullptr; }
+
+    void append(const TTraceRow &row);
+    int getRowCount() const { return this->rowCount; }
+
+private:
+    FILE *file = nullptr;
+    std::vector<TTraceRow> rows;
+    std::vector<uint8_t> blockBuffer;
+    int rowCount = 0;
+
+    void writeBlock();
+};
+
+class SimTraceReader
+{
+public:
+    SimTraceReader() = default;
+    ~SimTraceReader();
+
+    bool open(const std::string &fileName);
+    void close();
+
+    // False at the end of the file or on a truncated block
+    bool read(TTraceRow &row);
+
+    // Columns of the file that this version does not know, for diagnostics
+    const std::vector<std::string> &getUnknownColumns() const { return this->unknownColumns; }
+
+private:
+    struct TFileColumn
+    {
+        TTraceColumnType type;
+        const TTraceColumn *column; // nullptr if unknown, skipped
+    };
+
+    FILE *file = nullptr;
+    std::vector<TFileColumn> fileColumns;
+    std::vector<std::string> unknownColumns;
+    std::vector<TTraceRow> rows;
+    std::vector<uint8_t> blockBuffer;
+    size_t rowIndex = 0;
+
+    bool readBlock();
+};
+
+namespace SimTrace
+{
+    const std::vector<TTraceColumn> &columns();
+    size_t columnTypeSize(TTraceColumnType type);
+}
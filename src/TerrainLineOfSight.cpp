@@ -0,0 +1,173 @@
+#include "TerrainLineOfSight.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <XPLMGraphics.h>
+
+#include "MathUtils.h"
+
+TerrainLineOfSight::TerrainLineOfSight()
+{
+    this->probe = XPLMCreateProbe(xplm_ProbeY);
+    this->clearCache();
+}
+
+TerrainLineOfSight::~TerrainLineOfSight()
+{
+    if (this->probe != nullptr)
+    {
+        XPLMDestroyProbe(this->probe);
+    }
+}
+
+void TerrainLineOfSight::reset()
+{
+    this->scanActive = false;
+    this->lossDb = 0.0f;
+    this->clearanceM = 0.0f;
+    this->probesLastUpdate = 0;
+}
+
+void TerrainLineOfSight::clearCache()
+{
+    for (TTile &tile : this->cache)
+    {
+        tile.valid = false;
+    }
+}
+
+void TerrainLineOfSight::update(const TGeoPoint &home, const TGeoPoint &aircraft)
+{
+    using namespace TerrainLineOfSightConstants;
+
+    int probes = 0;
+
+    if (!this->scanActive)
+    {
+        this->startScan(home, aircraft);
+    }
+
+    while (this->scanIndex < PATH_SAMPLES)
+    {
+        const double t = static_cast<double>(this->scanIndex) / PATH_SAMPLES;
+        const double latitude = this->scanFrom.latitude + (this->scanTo.latitude - this->scanFrom.latitude) * t;
+        const double longitude = this->scanFrom.longitude + (this->scanTo.longitude - this->scanFrom.longitude) * t;
+
+        double terrain;
+        const TTerrainResult result = this->terrainElevation(latitude, longitude, probes, terrain);
+        if (result == TERRAIN_NO_BUDGET)
+        {
+            this->probesLastUpdate = probes;
+            return;
+        }
+
+        if (result == TERRAIN_FOUND)
+        {
+            const double d1 = this->scanDistanceM * t;
+            const double d2 = this->scanDistanceM - d1;
+            // Earth bulge raises the terrain relative to the straight line
+            const double bulge = d1 * d2 / (2.0 * EFFECTIVE_EARTH_RADIUS_M);
+            const double line = this->scanFrom.elevation + (this->scanTo.elevation - this->scanFrom.elevation) * t;
+            const double clearance = line - (terrain + bulge);
+
+            // Fresnel-Kirchhoff diffraction parameter, obstacle height is -clearance
+            const double v = -clearance * sqrt(2.0 * this->scanDistanceM / (WAVELENGTH_M * d1 * d2));
+            this->scanMaxV = std::max(this->scanMaxV, v);
+            this->scanMinClearanceM = std::min(this->scanMinClearanceM, clearance);
+        }
+
+        this->scanIndex++;
+    }
+
+    this->probesLastUpdate = probes;
+    this->finishScan();
+}
+
+void TerrainLineOfSight::startScan(const TGeoPoint &home, const TGeoPoint &aircraft)
+{
+    this->scanFrom = home;
+    this->scanFrom.elevation += TerrainLineOfSightConstants::HOME_ANTENNA_HEIGHT_M;
+    this->scanTo = aircraft;
+
+    const double north = (aircraft.latitude - home.latitude) * TerrainLineOfSightConstants::METERS_PER_DEGREE;
+    const double east = (aircraft.longitude - home.longitude) * TerrainLineOfSightConstants::METERS_PER_DEGREE * cos(MathUtils::degreesToRadians(home.latitude));
+    this->scanDistanceM = sqrt(north * north + east * east);
+
+    this->scanIndex = 1;
+    this->scanMaxV = -std::numeric_limits<double>::infinity();
+    this->scanMinClearanceM = std::numeric_limits<double>::infinity();
+    this->scanActive = true;
+
+    // Home and aircraft within one tile, nothing in between
+    if (this->scanDistanceM < TerrainLineOfSightConstants::TILE_SIZE_DEG * TerrainLineOfSightConstants::METERS_PER_DEGREE)
+    {
+        this->scanIndex = TerrainLineOfSightConstants::PATH_SAMPLES;
+    }
+}
+
+void TerrainLineOfSight::finishScan()
+{
+    this->scanActive = false;
+    this->lossDb = TerrainLineOfSight::knifeEdgeLossDb(this->scanMaxV);
+    this->clearanceM = std::isfinite(this->scanMinClearanceM) ? static_cast<float>(this->scanMinClearanceM) : 0.0f;
+}
+
+TerrainLineOfSight::TTerrainResult TerrainLineOfSight::terrainElevation(double latitude, double longitude, int &probes, double &elevation)
+{
+    using namespace TerrainLineOfSightConstants;
+
+    const int32_t latitudeIndex = static_cast<int32_t>(floor(latitude / TILE_SIZE_DEG));
+    const int32_t longitudeIndex = static_cast<int32_t>(floor(longitude / TILE_SIZE_DEG));
+    const uint32_t hash = static_cast<uint32_t>(latitudeIndex) * 73856093u ^ static_cast<uint32_t>(longitudeIndex) * 19349663u;
+    TTile &tile = this->cache[hash & (CACHE_SIZE - 1)];
+
+    if (tile.valid && tile.latitudeIndex == latitudeIndex && tile.longitudeIndex == longitudeIndex)
+    {
+        elevation = tile.elevation;
+        return TERRAIN_FOUND;
+    }
+
+    if (this->probe == nullptr)
+    {
+        return TERRAIN_UNKNOWN;
+    }
+    if (probes >= PROBES_PER_UPDATE)
+    {
+        return TERRAIN_NO_BUDGET;
+    }
+    probes++;
+
+    // Tile center, so every sample in the tile gets the same elevation
+    double x, y, z;
+    XPLMWorldToLocal((latitudeIndex + 0.5) * TILE_SIZE_DEG, (longitudeIndex + 0.5) * TILE_SIZE_DEG, 0.0, &x, &y, &z);
+
+    XPLMProbeInfo_t info;
+    info.structSize = sizeof(XPLMProbeInfo_t);
+    if (XPLMProbeTerrainXYZ(this->probe, static_cast<float>(x), static_cast<float>(y), static_cast<float>(z), &info) != xplm_ProbeHitTerrain)
+    {
+        return TERRAIN_UNKNOWN;
+    }
+
+    double tileLatitude, tileLongitude;
+    XPLMLocalToWorld(info.locationX, info.locationY, info.locationZ, &tileLatitude, &tileLongitude, &elevation);
+
+    tile.latitudeIndex = latitudeIndex;
+    tile.longitudeIndex = longitudeIndex;
+    tile.elevation = static_cast<float>(elevation);
+    tile.valid = true;
+
+    return TERRAIN_FOUND;
+}
+
+// Single knife edge approximation, ITU-R P.526
+float TerrainLineOfSight::knifeEdgeLossDb(double v)
+{
+    if (v <= -0.78)
+    {
+        return 0.0f;
+    }
+    const double loss = 6.9 + 20.0 * log10(sqrt((v - 0.1) * (v - 0.1) + 1.0) + v - 0.1);
+    return std::clamp(static_cast<float>(loss), 0.0f, TerrainLineOfSightConstants::MAX_LOSS_DB);
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "platform.h"
+
+#include <array>
+#include <cstdint>
+
+#include <XPLMScenery.h>
+
+namespace TerrainLineOfSightConstants
+{
+    // Terrain samples between home and aircraft, independent of the distance
+    static constexpr int PATH_SAMPLES = 64;
+    // XPLMProbeTerrainXYZ calls per update, cached tiles are free
+    static constexpr int PROBES_PER_UPDATE = 8;
+
+    // Terrain elevation is cached per tile, ~55 m in latitude
+    static constexpr double TILE_SIZE_DEG = 0.0005;
+    // Direct mapped, power of two
+    static constexpr int CACHE_SIZE = 4096;
+
+    // 2.4 GHz RC link
+    static constexpr double WAVELENGTH_M = 0.125;
+    static constexpr double HOME_ANTENNA_HEIGHT_M = 1.5;
+    // 4/3 earth radius for the usual atmospheric refraction
+    static constexpr double EFFECTIVE_EARTH_RADIUS_M = 8500000.0;
+    static constexpr double METERS_PER_DEGREE = 111320.0;
+
+    static constexpr float MAX_LOSS_DB = 60.0f;
+}
+
+struct TGeoPoint
+{
+    double latitude;
+    double longitude;
+    double elevation; // m MSL
+};
+
+/**
+ * @brief Radio line of sight between home and aircraft over X-Plane terrain.
+ *
+ * The path is sampled at PATH_SAMPLES points, the worst obstruction gives the knife edge
+ * diffraction loss (ITU-R P.526). A scan is spread over as many updates as needed to stay
+ * within PROBES_PER_UPDATE terrain probes, the previous result is kept meanwhile. Terrain
+ * elevations are cached per tile, so the cost per update is bounded at any distance and
+ * mostly zero once the area is known. Main thread only.
+ */
+class TerrainLineOfSight
+{
+public:
+    TerrainLineOfSight();
+    ~TerrainLineOfSight();
+
+    // Advances the current scan, starts a new one with these end points when it is complete
+    void update(const TGeoPoint &home, const TGeoPoint &aircraft);
+    void reset();
+
+    // Scenery reloaded
+    void clearCache();
+
+    float getLossDb() const { return this->lossDb; }
+    // Smallest distance of the direct line above terrain, negative if blocked
+    float getClearanceM() const { return this->clearanceM; }
+    int getProbesLastUpdate() const { return this->probesLastUpdate; }
+
+    static float knifeEdgeLossDb(double v);
+
+private:
+    typedef enum
+    {
+        TERRAIN_FOUND,
+        TERRAIN_UNKNOWN,   // scenery not loaded there, sample is skipped
+        TERRAIN_NO_BUDGET, // continue in the next update
+    } TTerrainResult;
+
+    struct TTile
+    {
+        int32_t latitudeIndex;
+        int32_t longitudeIndex;
+        float elevation;
+        bool valid;
+    };
+
+    XPLMProbeRef probe = nullptr;
+    std::array<TTile, TerrainLineOfSightConstants::CACHE_SIZE> cache;
+
+    bool scanActive = false;
+    int scanIndex = 0;
+    TGeoPoint scanFrom = {};
+    TGeoPoint scanTo = {};
+    double scanDistanceM = 0.0;
+    double scanMaxV = 0.0;
+    double scanMinClearanceM = 0.0;
+
+    float lossDb = 0.0f;
+    float clearanceM = 0.0f;
+    int probesLastUpdate = 0;
+
+    void startScan(const TGeoPoint &home, const TGeoPoint &aircraft);
+    void finishScan();
+    TTerrainResult terrainElevation(double latitude, double longitude, int &probes, double &elevation);
+};
@@ -35,6 +35,7 @@
 #include <XPLMUtilities.h>
 #include <XPLMPlugin.h>
 #include <XPLMDisplay.h>
+#include <XPLMPlanes.h>
 #include "XPLMDataAccess.h"
 
 
@@ -240,6 +241,15 @@ namespace Utils
     }
 #endif
 
+    // File name of the user's aircraft without extension, e.g. "NK_FPVSW"
+    static std::string GetAircraftName()
+    {
+        char fileName[256] = {0};
+        char path[MAX_PATH] = {0};
+        XPLMGetNthAircraftModel(0, fileName, path);
+        return fs::path(fileName).stem().string();
+    }
+
     // subPath = "assets\\fonts"
     static std::vector<fs::path> GetFontPaths(fs::path subPath, bool directories)
     {
@@ -0,0 +1,41 @@
+#include "Clock.h"
+
+#include <algorithm>
+#include <chrono>
+
+int64_t Clock::NowUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void SimClock::update(int64_t wallUs, bool paused, float speed)
+{
+    this->paused = paused;
+    this->speed = std::max(speed, 0.0f);
+
+    if (this->lastWallUs == 0)
+    {
+        this->lastWallUs = wallUs;
+        return;
+    }
+
+    const int64_t wallStepUs = std::clamp<int64_t>(wallUs - this->lastWallUs, 0, ClockConstants::SIM_CLOCK_MAX_STEP_US);
+    this->lastWallUs = wallUs;
+
+    if (this->paused)
+    {
+        return;
+    }
+
+    const double stepUs = wallStepUs * static_cast<double>(this->speed) + this->fractionUs;
+    const int64_t wholeUs = static_cast<int64_t>(stepUs);
+    this->fractionUs = stepUs - wholeUs;
+    this->simUs += wholeUs;
+}
+
+void SimClock::reset()
+{
+    this->simUs = 0;
+    this->lastWallUs = 0;
+    this->fractionUs = 0.0;
+}
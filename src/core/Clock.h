@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+
+namespace ClockConstants
+{
+    static constexpr int64_t US_PER_MS = 1000;
+    static constexpr int64_t US_PER_S = 1000000;
+    // Longer wall time steps (loading, debugger break) don't advance the sim clock by more than this
+    static constexpr int64_t SIM_CLOCK_MAX_STEP_US = 100000;
+}
+
+namespace Clock
+{
+    // Monotonic wall clock in microseconds, 64 bit: doesn't wrap, no 1 ms quantization
+    int64_t NowUs();
+
+    inline double UsToS(int64_t us)
+    {
+        return us / static_cast<double>(ClockConstants::US_PER_S);
+    }
+}
+
+/**
+ * @brief Simulation time, advances with the wall clock scaled by X-Plane's actual sim speed.
+ *
+ * Stops while X-Plane is paused and runs faster with time acceleration. Updated once per
+ * cycle by SimData; everything modelling physical processes (battery drain, sensor drift)
+ * uses this instead of the wall clock.
+ */
+class SimClock
+{
+public:
+    void update(int64_t wallUs, bool paused, float speed);
+    void reset();
+
+    int64_t nowUs() const { return this->simUs; }
+    double nowS() const { return Clock::UsToS(this->simUs); }
+
+    bool isPaused() const { return this->paused; }
+    float getSpeed() const { return this->speed; }
+
+private:
+    int64_t simUs = 0;
+    int64_t lastWallUs = 0;
+    // Sub-microsecond remainder of the scaled steps, keeps slow speeds exact
+    double fractionUs = 0.0;
+    bool paused = false;
+    float speed = 1.0f;
+};
@@ -15,6 +15,9 @@
 #include "../MathUtils.h"
 #include "../MSP_Commands.h"
 #include "../MSP.h"
+#include "../DebugAssembler.h"
+#include "../AttitudeErrorStatistics.h"
+#include "../OsdLatencyStatistics.h"
 
 using namespace MathUtils;
 
@@ -152,6 +155,17 @@ class FontEventArg
     FontEventArg(const std::string& name, std::string type) : fontName(name), type(type) {}
 };
 
+class PowerTrainCatalogEntryEventArg
+{
+    public:
+    std::string type; // "propulsion" or "pack"
+    std::string name; // motor or pack
+    std::string propeller;
+
+    PowerTrainCatalogEntryEventArg() = default;
+    PowerTrainCatalogEntryEventArg(const std::string &type, const std::string &name, const std::string &propeller = "") : type(type), name(name), propeller(propeller) {}
+};
+
 class SettingsChangedEventArg
 {
 public:
@@ -266,14 +280,99 @@ public:
     IntEventArg(int val) : value(val) {}
 };
 
-class AddDebugEventArg
+class AttitudeErrorSummaryEventArg
 {
 public:
-    int index = 0;
-    float value = 0.0f;
+    TAttitudeErrorSummary summary = {};
+
+    AttitudeErrorSummaryEventArg() = default;
+    AttitudeErrorSummaryEventArg(const TAttitudeErrorSummary &summary) : summary(summary) {}
+};
+
+class DebugFrameEventArg
+{
+public:
+    TDebugFrame frame = {};
+
+    DebugFrameEventArg() = default;
+    DebugFrameEventArg(const TDebugFrame &frame) : frame(frame) {}
+};
+
+class SimDataCycleEventArg
+{
+public:
+    float dataRefTimeUs = 0.0f;
+    int dataRefReads = 0;
+    int dataRefWrites = 0;
+
+    SimDataCycleEventArg() = default;
+    SimDataCycleEventArg(float timeUs, int reads, int writes) : dataRefTimeUs(timeUs), dataRefReads(reads), dataRefWrites(writes) {}
+};
+
+class SensorSenderStatisticsEventArg
+{
+public:
+    int rateHz = 0;
+    float jitterMeanUs = 0.0f;
+    float jitterStdDevUs = 0.0f;
+    float jitterMaxUs = 0.0f;
+    int overruns = 0;
+
+    SensorSenderStatisticsEventArg() = default;
+    SensorSenderStatisticsEventArg(int rate, float meanUs, float stdDevUs, float maxUs, int overrunCount)
+        : rateHz(rate), jitterMeanUs(meanUs), jitterStdDevUs(stdDevUs), jitterMaxUs(maxUs), overruns(overrunCount) {}
+};
+
+class LockstepStatisticsEventArg
+{
+public:
+    int stepsPerSecond = 0;
+    float realtimeFactor = 0.0f;
+    int timeouts = 0;
+
+    LockstepStatisticsEventArg() = default;
+    LockstepStatisticsEventArg(int steps, float factor, int timeoutCount)
+        : stepsPerSecond(steps), realtimeFactor(factor), timeouts(timeoutCount) {}
+};
+
+class SerialTrafficEventArg
+{
+public:
+    int bytes = 0;
+    int packets = 0;
+
+    SerialTrafficEventArg() = default;
+    SerialTrafficEventArg(int byteCount, int packetCount) : bytes(byteCount), packets(packetCount) {}
+};
+
+// Published when INAV completed an OSD frame (the row counter wrapped)
+class OsdFrameUpdatedEventArg
+{
+public:
+    // One bitmap per OSD row, bit n = column n changed since the last frame. Valid during the event only.
+    const uint64_t *dirtyRows = nullptr;
+    int rows = 0;
+    int changedCells = 0; // distinct cells with a new character or mode
+    int writtenCells = 0; // cells sent by INAV, changed or not
+    int updates = 0;      // MSP OSD messages of the frame
+    int tornDraws = 0;      // draws of a partly updated OSD (not double buffered)
+    int tearsPrevented = 0; // draws that showed the previous complete frame instead (double buffered)
+
+    OsdFrameUpdatedEventArg() = default;
+    OsdFrameUpdatedEventArg(const uint64_t *dirty, int rowCount, int changed, int written, int updateCount, int torn, int prevented)
+        : dirtyRows(dirty), rows(rowCount), changedCells(changed), writtenCells(written), updates(updateCount), tornDraws(torn), tearsPrevented(prevented) {}
+
+    bool isRowDirty(int row) const { return this->dirtyRows[row] != 0; }
+    bool isDirty(int row, int col) const { return ((this->dirtyRows[row] >> col) & 1) != 0; }
+};
+
+class OsdLatencySummaryEventArg
+{
+public:
+    TOsdLatencySummary summary = {};
 
-    AddDebugEventArg() = default;
-    AddDebugEventArg(int idx, float val) : index(idx), value(val) {}
+    OsdLatencySummaryEventArg() = default;
+    OsdLatencySummaryEventArg(const TOsdLatencySummary &summary) : summary(summary) {}
 };
 
 class UpdateDataRefEventArg
@@ -286,14 +385,21 @@ public:
     float gpsElevation = 0.0f;
     float groundspeed = 0.0f;
     vector3D gpsVelocities;
+    float gpsHdop = 0.0f;
     vector3D magnetometer;
+    float magDeclination = 0.0f;
     int rangefinderDistanceCm = 0;
     float airspeed = 0.0f;
     float batteryVoltage = 0.0f;
     float currentConsumption = 0.0f;
+    float minCellVoltage = 0.0f;
+    float batteryTemperature = 0.0f;
+    float predictedTimeRemainingS = -1.0f; // -1: no prediction
+    float predictedMinVoltage = 0.0f;
     float scaledThrottle = 0.0f;
     int rssi = 0;
     bool isFailsafe = false;
+    float rssiTerrainLossDb = 0.0f;
 
     UpdateDataRefEventArg() = default;
     UpdateDataRefEventArg(int sats, int fix, float lat, float lon, float ele, const vector3D& vel, const vector3D& mag,
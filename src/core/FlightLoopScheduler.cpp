@@ -0,0 +1,124 @@
+#include "FlightLoopScheduler.h"
+
+#include "PluginContext.h"
+#include "../settings/SettingNames.h"
+#include "../Utils.h"
+
+FlightLoopScheduler::FlightLoopScheduler()
+{
+    using namespace FlightLoopSchedulerConstants;
+
+    this->slots[FLIGHTLOOP_SLOT_SENSORS] = {"FlightLoop", &SettingsKeys::SETTINGS_LOOP_SENSORS_INTERVAL, &SettingsKeys::SETTINGS_LOOP_SENSORS_PHASE, EVERY_FRAME, xplm_FlightLoop_Phase_AfterFlightModel, nullptr};
+    // Replies are decoded before the flight model, so INAV's control outputs apply in the same frame
+    this->slots[FLIGHTLOOP_SLOT_MSP] = {"MspLoop", &SettingsKeys::SETTINGS_LOOP_MSP_INTERVAL, &SettingsKeys::SETTINGS_LOOP_MSP_PHASE, EVERY_FRAME, xplm_FlightLoop_Phase_BeforeFlightModel, nullptr};
+    this->slots[FLIGHTLOOP_SLOT_STATISTICS] = {"StatisticsLoop", &SettingsKeys::SETTINGS_LOOP_STATISTICS_INTERVAL, &SettingsKeys::SETTINGS_LOOP_STATISTICS_PHASE, STATISTICS_INTERVAL_S, xplm_FlightLoop_Phase_AfterFlightModel, nullptr};
+    this->slots[FLIGHTLOOP_SLOT_TOASTS] = {"ToastLoop", &SettingsKeys::SETTINGS_LOOP_TOASTS_INTERVAL, &SettingsKeys::SETTINGS_LOOP_TOASTS_PHASE, TOASTS_INTERVAL_S, xplm_FlightLoop_Phase_AfterFlightModel, nullptr};
+
+    for (TSlot &slot : this->slots)
+    {
+        this->create(slot);
+    }
+
+    auto eventBus = Plugin()->GetEventBus();
+
+    eventBus->Subscribe<SettingsChangedEventArg>("SettingsChanged", [this](const SettingsChangedEventArg &event)
+    {
+        if (event.sectionName != SettingsSections::SECTION_GENERAL)
+        {
+            return;
+        }
+
+        for (int i = 0; i < FLIGHTLOOP_SLOT_COUNT; i++)
+        {
+            TSlot &slot = this->slots[i];
+            if (event.settingName == *slot.intervalKey)
+            {
+                this->setInterval(static_cast<TFlightLoopSlot>(i), event.getValueAs<float>(slot.interval));
+            }
+            else if (event.settingName == *slot.phaseKey)
+            {
+                this->setPhase(static_cast<TFlightLoopSlot>(i), event.getValueAs<int>(slot.phase));
+            }
+        }
+    });
+
+    eventBus->Subscribe("PluginDisabled", [this]()
+    {
+        this->destroyAll();
+    });
+}
+
+FlightLoopScheduler::~FlightLoopScheduler()
+{
+    this->destroyAll();
+}
+
+void FlightLoopScheduler::setInterval(TFlightLoopSlot slot, float interval)
+{
+    TSlot &s = this->slots[slot];
+    // 0 would unschedule the loop and stop the subsystem for good
+    s.interval = interval == 0.0f ? FlightLoopSchedulerConstants::EVERY_FRAME : interval;
+    if (s.id != nullptr)
+    {
+        XPLMScheduleFlightLoop(s.id, s.interval, true);
+    }
+    Utils::LOG("Flight loop {}: interval {}", s.eventName, s.interval);
+}
+
+void FlightLoopScheduler::setPhase(TFlightLoopSlot slot, XPLMFlightLoopPhaseType phase)
+{
+    TSlot &s = this->slots[slot];
+    if (phase != xplm_FlightLoop_Phase_BeforeFlightModel && phase != xplm_FlightLoop_Phase_AfterFlightModel)
+    {
+        Utils::LOG("Flight loop {}: invalid phase {}", s.eventName, phase);
+        return;
+    }
+
+    if (phase == s.phase)
+    {
+        return;
+    }
+
+    // The phase can only be set on creation
+    s.phase = phase;
+    if (s.id != nullptr)
+    {
+        this->destroy(s);
+        this->create(s);
+    }
+}
+
+void FlightLoopScheduler::create(TSlot &slot)
+{
+    XPLMCreateFlightLoop_t params;
+    params.structSize = sizeof(XPLMCreateFlightLoop_t);
+    params.callbackFunc = &FlightLoopScheduler::callback;
+    params.phase = slot.phase;
+    params.refcon = &slot;
+    slot.id = XPLMCreateFlightLoop(&params);
+    XPLMScheduleFlightLoop(slot.id, slot.interval, true);
+}
+
+void FlightLoopScheduler::destroy(TSlot &slot)
+{
+    if (slot.id != nullptr)
+    {
+        XPLMDestroyFlightLoop(slot.id);
+        slot.id = nullptr;
+    }
+}
+
+void FlightLoopScheduler::destroyAll()
+{
+    for (TSlot &slot : this->slots)
+    {
+        this->destroy(slot);
+    }
+}
+
+float FlightLoopScheduler::callback(float elapsedSinceLastCall, float elapsedSinceLastFlightLoop, int counter, void *refcon)
+{
+    const TSlot *slot = static_cast<const TSlot *>(refcon);
+    Plugin()->GetEventBus()->Publish(slot->eventName, FlightLoopEventArg{elapsedSinceLastCall, counter});
+    return slot->interval;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "../platform.h"
+
+#include <XPLMProcessing.h>
+
+#include <array>
+#include <string>
+
+namespace FlightLoopSchedulerConstants
+{
+    // Intervals as in XPLMScheduleFlightLoop: seconds, negative values are flight loop frames
+    static constexpr float EVERY_FRAME = -1.0f;
+    static constexpr float STATISTICS_INTERVAL_S = 1.0f;
+    static constexpr float TOASTS_INTERVAL_S = 0.1f;
+}
+
+typedef enum
+{
+    FLIGHTLOOP_SLOT_SENSORS = 0,    // "FlightLoop": X-Plane -> INAV sensor data, every frame after the flight model
+    FLIGHTLOOP_SLOT_MSP,            // "MspLoop": serial/TCP I/O and connection state, every frame before the flight model
+    FLIGHTLOOP_SLOT_STATISTICS,     // "StatisticsLoop": per second rates, 1 s
+    FLIGHTLOOP_SLOT_TOASTS,         // "ToastLoop": OSD toast expiry, 100 ms
+    FLIGHTLOOP_SLOT_COUNT
+} TFlightLoopSlot;
+
+/**
+ * @brief One X-Plane flight loop per subsystem, each with its own interval and phase.
+ *
+ * Every slot publishes its event on the EventBus (FlightLoopEventArg, elapsed time since the
+ * last call of this slot), so low priority work is only called as often as it has to be and
+ * doesn't cost time in every frame. Intervals and phases can be changed in the settings
+ * (`loop_<slot>_interval`, `loop_<slot>_phase` in the `general` section) at runtime.
+ */
+class FlightLoopScheduler
+{
+public:
+    FlightLoopScheduler();
+    ~FlightLoopScheduler();
+
+    void setInterval(TFlightLoopSlot slot, float interval);
+    void setPhase(TFlightLoopSlot slot, XPLMFlightLoopPhaseType phase);
+
+private:
+    struct TSlot
+    {
+        const char *eventName;
+        const std::string *intervalKey;
+        const std::string *phaseKey;
+        float interval;
+        XPLMFlightLoopPhaseType phase;
+        XPLMFlightLoopID id;
+    };
+
+    std::array<TSlot, FLIGHTLOOP_SLOT_COUNT> slots;
+
+    void create(TSlot &slot);
+    void destroy(TSlot &slot);
+    void destroyAll();
+
+    static float callback(float elapsedSinceLastCall, float elapsedSinceLastFlightLoop, int counter, void *refcon);
+};
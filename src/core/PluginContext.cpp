@@ -1,5 +1,6 @@
 #include "PluginContext.h"
 #include "../Utils.h"
+#include "FlightLoopScheduler.h"
 #include "../settings/Settings.h"
 #include "../Menu.h"
 #include "../fonts/Fonts.h"
@@ -37,6 +38,7 @@ void PluginContext::Initialize()
     ConfigureImgWindow::configure();
 
     // Initialize components to ensure they are created
+    instance->_scheduler = std::make_shared<::FlightLoopScheduler>();
     instance->_dataRefs = std::make_shared<::DataRefs>();
     instance->_menu = std::make_shared<::Menu>();
     instance->_fonts = std::make_shared<::Fonts>();
@@ -16,6 +16,7 @@ class OSD;
 class Graph;
 class DataRefs;
 class Map;
+class FlightLoopScheduler;
 
 class PluginContext
 {
@@ -23,6 +24,7 @@ private:
     static std::unique_ptr<PluginContext> instance;
     
     std::shared_ptr<::EventBus> _eventBus;
+    std::shared_ptr<::FlightLoopScheduler> _scheduler;
     std::shared_ptr<::Fonts> _fonts;
     std::shared_ptr<::MSP> _mspConnection;
     std::shared_ptr<::SimData> _simData;
@@ -44,6 +46,7 @@ public:
 
     std::shared_ptr<::EventBus> GetEventBus() const { return _eventBus; }
     std::shared_ptr<::Fonts> Fonts() const { return _fonts; }
+    std::shared_ptr<::MSP> MSP() const { return _mspConnection; }
     std::shared_ptr<::Menu> Menu() const { return _menu; }
     std::shared_ptr<::Settings> Settings() const { return _settings; }
     static PluginContext CreateForTesting();
@@ -0,0 +1,175 @@
+#include "RandomStream.h"
+
+#include <cmath>
+
+namespace
+{
+    // Ziggurat tables for the standard normal distribution (Marsaglia & Tsang 2000), built once
+    struct TZigguratTables
+    {
+        uint32_t kn[RandomStreamConstants::ZIGGURAT_LAYERS];
+        float wn[RandomStreamConstants::ZIGGURAT_LAYERS];
+        float fn[RandomStreamConstants::ZIGGURAT_LAYERS];
+
+        TZigguratTables()
+        {
+            const int n = RandomStreamConstants::ZIGGURAT_LAYERS;
+            const double m1 = 2147483648.0;
+            const double vn = 9.91256303526217e-3;
+            double dn = 3.442619855899;
+            double tn = dn;
+
+            const double q = vn / exp(-0.5 * dn * dn);
+            kn[0] = static_cast<uint32_t>((dn / q) * m1);
+            kn[1] = 0;
+            wn[0] = static_cast<float>(q / m1);
+            wn[n - 1] = static_cast<float>(dn / m1);
+            fn[0] = 1.0f;
+            fn[n - 1] = static_cast<float>(exp(-0.5 * dn * dn));
+
+            for (int i = n - 2; i >= 1; i--)
+            {
+                dn = sqrt(-2.0 * log(vn / dn + exp(-0.5 * dn * dn)));
+                kn[i + 1] = static_cast<uint32_t>((dn / tn) * m1);
+                tn = dn;
+                fn[i] = static_cast<float>(exp(-0.5 * dn * dn));
+                wn[i] = static_cast<float>(dn / m1);
+            }
+        }
+    };
+
+    const TZigguratTables &zigguratTables()
+    {
+        static const TZigguratTables tables;
+        return tables;
+    }
+
+    static constexpr float ZIGGURAT_R = 3.442620f;
+
+    uint64_t splitMix64(uint64_t &x)
+    {
+        uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    inline uint64_t rotl(uint64_t x, int k)
+    {
+        return (x << k) | (x >> (64 - k));
+    }
+}
+
+RandomStream::RandomStream(uint64_t seed, uint32_t stream)
+{
+    this->seed(seed, stream);
+}
+
+void RandomStream::seed(uint64_t seed, uint32_t stream)
+{
+    uint64_t x = seed;
+    for (uint64_t &s : this->state)
+    {
+        s = splitMix64(x);
+    }
+
+    for (uint32_t i = 0; i < stream; i++)
+    {
+        this->jump();
+    }
+}
+
+uint64_t RandomStream::next()
+{
+    uint64_t *s = this->state.data();
+    const uint64_t result = rotl(s[1] * 5, 7) * 9;
+    const uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+
+    return result;
+}
+
+// Equivalent to 2^128 calls to next()
+void RandomStream::jump()
+{
+    static constexpr uint64_t JUMP[] = {0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL};
+
+    std::array<uint64_t, 4> s = {0, 0, 0, 0};
+    for (uint64_t jump : JUMP)
+    {
+        for (int b = 0; b < 64; b++)
+        {
+            if (jump & (1ULL << b))
+            {
+                for (int i = 0; i < 4; i++)
+                {
+                    s[i] ^= this->state[i];
+                }
+            }
+            this->next();
+        }
+    }
+    this->state = s;
+}
+
+float RandomStream::uniform()
+{
+    // Upper 24 bits, exactly representable as float
+    return (this->next() >> 40) * (1.0f / 16777216.0f);
+}
+
+float RandomStream::normal()
+{
+    const TZigguratTables &tables = zigguratTables();
+
+    // Layer and value from independent bits of one draw
+    const uint64_t bits = this->next();
+    const int iz = static_cast<int>(bits & (RandomStreamConstants::ZIGGURAT_LAYERS - 1));
+    const int32_t hz = static_cast<int32_t>(bits >> 32);
+
+    if (static_cast<uint32_t>(std::abs(static_cast<int64_t>(hz))) < tables.kn[iz])
+    {
+        return hz * tables.wn[iz];
+    }
+    return this->normalTail(hz, iz);
+}
+
+float RandomStream::normalTail(int64_t hz, int iz)
+{
+    const TZigguratTables &tables = zigguratTables();
+
+    for (;;)
+    {
+        float x = hz * tables.wn[iz];
+
+        if (iz == 0)
+        {
+            float y;
+            do
+            {
+                x = -logf(1.0f - this->uniform()) / ZIGGURAT_R;
+                y = -logf(1.0f - this->uniform());
+            } while (y + y < x * x);
+            return hz > 0 ? ZIGGURAT_R + x : -ZIGGURAT_R - x;
+        }
+
+        if (tables.fn[iz] + this->uniform() * (tables.fn[iz - 1] - tables.fn[iz]) < expf(-0.5f * x * x))
+        {
+            return x;
+        }
+
+        const uint64_t bits = this->next();
+        iz = static_cast<int>(bits & (RandomStreamConstants::ZIGGURAT_LAYERS - 1));
+        hz = static_cast<int32_t>(bits >> 32);
+        if (static_cast<uint32_t>(std::abs(hz)) < tables.kn[iz])
+        {
+            return hz * tables.wn[iz];
+        }
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+namespace RandomStreamConstants
+{
+    static constexpr int ZIGGURAT_LAYERS = 128;
+}
+
+/**
+ * @brief Deterministic random number stream: xoshiro256** with a ziggurat normal generator.
+ *
+ * Streams created with the same seed and different stream ids are non-overlapping
+ * (each id jumps 2^128 steps ahead), so every consumer can own its stream and a
+ * run can be replayed bit-for-bit from the seed. Satisfies UniformRandomBitGenerator.
+ */
+class RandomStream
+{
+public:
+    typedef uint64_t result_type;
+
+    RandomStream(uint64_t seed = 1, uint32_t stream = 0);
+
+    void seed(uint64_t seed, uint32_t stream = 0);
+
+    uint64_t next();
+
+    // [0, 1)
+    float uniform();
+
+    // Standard normal deviate
+    float normal();
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+    result_type operator()() { return this->next(); }
+
+private:
+    std::array<uint64_t, 4> state;
+
+    void jump();
+    float normalTail(int64_t hz, int iz);
+};
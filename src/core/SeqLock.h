@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * @brief Single writer, multiple reader sequence lock over a double buffer.
+ *
+ * The writer never blocks: it fills the slot readers are not pointed at and then
+ * bumps the sequence. Readers copy the current slot and retry if the sequence
+ * moved in the meantime. T must be trivially copyable.
+ *
+ * The payload is stored as relaxed atomic words, so a reader racing with the writer
+ * reads stale or mixed words (and retries) instead of being a data race.
+ */
+
+template <typename T>
+class SeqLock
+{
+    static_assert(std::is_trivially_copyable_v<T>, "SeqLock requires a trivially copyable type");
+
+private:
+    static constexpr size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint32_t> sequence{0};
+    std::atomic<uint64_t> buffers[2][WORDS] = {};
+
+public:
+    SeqLock() = default;
+    SeqLock(const SeqLock &) = delete;
+    SeqLock &operator=(const SeqLock &) = delete;
+
+    // Writer side, must only be called from one thread
+    void store(const T &value)
+    {
+        uint64_t words[WORDS] = {};
+        std::memcpy(words, &value, sizeof(T));
+
+        const uint32_t seq = this->sequence.load(std::memory_order_relaxed);
+        // Orders the previous sequence update before the slot writes: a reader still on this
+        // slot that sees one of the new words also sees the sequence moved
+        std::atomic_thread_fence(std::memory_order_release);
+        std::atomic<uint64_t> *slot = this->buffers[(seq + 1) & 1];
+        for (size_t i = 0; i < WORDS; i++)
+        {
+            slot[i].store(words[i], std::memory_order_relaxed);
+        }
+        this->sequence.store(seq + 1, std::memory_order_release);
+    }
+
+    // Reader side, returns the sequence number the value belongs to
+    uint32_t load(T &value) const
+    {
+        uint64_t words[WORDS];
+        uint32_t before;
+        uint32_t after;
+        do
+        {
+            before = this->sequence.load(std::memory_order_acquire);
+            const std::atomic<uint64_t> *slot = this->buffers[before & 1];
+            for (size_t i = 0; i < WORDS; i++)
+            {
+                words[i] = slot[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = this->sequence.load(std::memory_order_relaxed);
+        } while (before != after);
+
+        std::memcpy(&value, words, sizeof(T));
+
+        return before;
+    }
+
+    uint32_t getSequence() const
+    {
+        return this->sequence.load(std::memory_order_acquire);
+    }
+};
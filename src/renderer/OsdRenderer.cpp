@@ -143,7 +143,7 @@ OsdRenderer::~OsdRenderer()
     glDeleteBuffers(1, &this->EBO);
 }
 
-void OsdRenderer::drawOSD(const std::vector<uint16_t> &osdData, int rows, int cols, int cellWidth, int cellHeight, int xOffset, int yOffset, bool blink)
+void OsdRenderer::drawOSD(const TOsdLayer *layers, int layerCount, int rows, int cols, int cellWidth, int cellHeight, int xOffset, int yOffset, bool blink)
 {
     this->shader->Use();
     glBindVertexArray(this->VAO);
@@ -153,8 +153,23 @@ void OsdRenderer::drawOSD(const std::vector<uint16_t> &osdData, int rows, int co
     {
         for (int x = 0; x < cols; x++)
         {
-
-            int code = osdData[y * 60 + x];
+            int code = 0;
+            for (int l = layerCount - 1; l >= 0; l--)
+            {
+                const TOsdLayer &layer = layers[l];
+                const int layerRow = y - layer.row;
+                const int layerCol = x - layer.col;
+                if (!layer.visible || layerRow < 0 || layerRow >= layer.rows || layerCol < 0 || layerCol >= layer.cols)
+                {
+                    continue;
+                }
+
+                code = layer.data[layerRow * layer.stride + layerCol];
+                if (layer.opaque || !OSDConstants::charIsBlank(code))
+                {
+                    break;
+                }
+            }
 
             if (OSDConstants::charIsBlank(code))
                 continue;
@@ -7,6 +7,8 @@
 
 namespace fs = std::filesystem;
 
+struct TOsdLayer;
+
 class OsdRenderer
 {
 private:
@@ -30,7 +32,8 @@ public:
 
   int loadInterferenceTexture(fs::path& filename, bool smoothed);
   void loadOSDTextures(const std::vector<std::vector<uint8_t>>& textures, int width, int height, bool smoothed);
-  void drawOSD(const std::vector<uint16_t>& osdData, int rows, int cols, int cellWidth, int cellHeight, int xOffset, int yOffset, bool blink);
+  // Layers from bottom to top, the top most non-blank (or opaque) layer wins per cell
+  void drawOSD(const TOsdLayer* layers, int layerCount, int rows, int cols, int cellWidth, int cellHeight, int xOffset, int yOffset, bool blink);
   void drawInterferenceTexture(int textureId, int x, int y, int width, int height, float transparency);
 };
 
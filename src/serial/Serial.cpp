@@ -185,8 +185,6 @@ std::vector<uint8_t> Serial::ReadData()
 
 void Serial::flushOut()
 {
-    auto plugin = Plugin();
-    auto eventBus = plugin->GetEventBus();
     if (this->writeBuffer.size() > 0)
     {
 #if IBM
@@ -208,7 +206,8 @@ void Serial::flushOut()
         {
             Utils::LOG("WARN: {} bytes written, but {} bytes requested", bytesSend, this->writeBuffer.size());
         }
-        eventBus->Publish<IntEventArg>("SerialBytesSent", IntEventArg(static_cast<int>(bytesSend)));
+        this->bytesSent += static_cast<int>(bytesSend);
+        this->packetsSent++;
         
         SerialBase::flushOut();
     }
@@ -60,3 +60,9 @@ void SerialBase::flushOut()
 {
     this->writeBuffer.clear();
 }
+
+void SerialBase::takeSentCounters(int &bytes, int &packets)
+{
+    bytes = this->bytesSent.exchange(0);
+    packets = this->packetsSent.exchange(0);
+}
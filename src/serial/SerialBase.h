@@ -6,6 +6,7 @@
 #include <sys/types.h>
 #include <fcntl.h>
 #endif
+#include <atomic>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -19,6 +20,10 @@ protected:
 	bool connected = false;
   std::vector<uint8_t> writeBuffer;
 
+  // Written from whichever thread flushes, collected on the main thread
+  std::atomic<int> bytesSent{0};
+  std::atomic<int> packetsSent{0};
+
 public:
     
   SerialBase();
@@ -32,5 +37,7 @@ public:
   virtual ~SerialBase();
   virtual std::vector<uint8_t> ReadData() = 0;
   virtual void flushOut();
+
+  void takeSentCounters(int &bytes, int &packets);
   
 };
@@ -20,6 +20,8 @@ namespace SettingsSections
     static const std::string SECTION_SIMDATA = "simdata";
     static const std::string SECTION_OSD = "osd";
     static const std::string SECTION_GENERAL = "general";
+    // Per aircraft settings, followed by the aircraft name
+    static const std::string SECTION_AIRCRAFT_PREFIX = "aircraft_";
 }
 
 namespace SettingsKeys
@@ -27,10 +29,15 @@ namespace SettingsKeys
     static const std::string SETTINGS_GPS_NUMSAT                = "gps_numsat";
     static const std::string SETTINGS_GPS_TIMEOUT               = "gps_timeout";
     static const std::string SETTINGS_GPS_GLITCH                = "gps_glitch";
+    static const std::string SETTINGS_GPS_RATE_HZ               = "gps_rate_hz";
+    static const std::string SETTINGS_GPS_LATENCY_MS            = "gps_latency_ms";
+    static const std::string SETTINGS_GPS_JITTER_MS             = "gps_jitter_ms";
+    static const std::string SETTINGS_GPS_SEND_VELOCITIES       = "gps_send_velocities";
     static const std::string SETTINGS_MAG_FAILURE               = "mag_failure";
     static const std::string SETTINGS_ATTITUDE_COPY_FROM_XPLANE = "attitude_use_sensors";
     static const std::string SETTINGS_OSD_VISIBLE               = "osd_visible";
     static const std::string SETTINGS_OSD_FILTER_MODE           = "osd_smoothed";
+    static const std::string SETTINGS_OSD_DOUBLE_BUFFER         = "osd_double_buffer";
     static const std::string SETTINGS_BATTERY_EMULATION         = "battery_emulation";
     static const std::string SETTINGS_MUTE_BEEPER               = "mute_beeper";
     static const std::string SETTINGS_SIMULATE_PITOT            = "simulate_pitot";
@@ -45,8 +52,27 @@ namespace SettingsKeys
     static const std::string SETTINGS_AUTODETECT_FC             = "autodetect_fc";
     static const std::string SETTINGS_COM_PORT                  = "com_port";
     static const std::string SETTINGS_SIMULATE_RANGEFINDER      = "simulate_rangefinder";
+    static const std::string SETTINGS_RANGEFINDER_RATE_HZ       = "rangefinder_rate_hz";
+    static const std::string SETTINGS_DEBUG_INTERPOLATION       = "debug_interpolation";
     static const std::string SETTINGS_RSSI_SIMULATION           = "rssi_simulation";
+    static const std::string SETTINGS_RSSI_TERRAIN              = "rssi_terrain";
     static const std::string SETTINGS_RESTART_ON_AIRPORT_LOAD     = "restart_on_plane_load";
+    static const std::string SETTINGS_SENSOR_RATE_HZ            = "sensor_rate_hz";
+    static const std::string SETTINGS_SENSOR_EXTRAPOLATION      = "sensor_extrapolation";
+    static const std::string SETTINGS_SENSOR_NOISE              = "sensor_noise";
+    static const std::string SETTINGS_SENSOR_NOISE_SEED         = "sensor_noise_seed";
+    static const std::string SETTINGS_LOCKSTEP                  = "lockstep";
+    static const std::string SETTINGS_AIRCRAFT_MOTOR            = "motor";
+    static const std::string SETTINGS_AIRCRAFT_PROPELLER        = "propeller";
+    static const std::string SETTINGS_AIRCRAFT_BATTERY_PACK     = "battery_pack";
+    static const std::string SETTINGS_LOOP_SENSORS_INTERVAL     = "loop_sensors_interval";
+    static const std::string SETTINGS_LOOP_SENSORS_PHASE        = "loop_sensors_phase";
+    static const std::string SETTINGS_LOOP_MSP_INTERVAL         = "loop_msp_interval";
+    static const std::string SETTINGS_LOOP_MSP_PHASE            = "loop_msp_phase";
+    static const std::string SETTINGS_LOOP_STATISTICS_INTERVAL  = "loop_statistics_interval";
+    static const std::string SETTINGS_LOOP_STATISTICS_PHASE     = "loop_statistics_phase";
+    static const std::string SETTINGS_LOOP_TOASTS_INTERVAL      = "loop_toasts_interval";
+    static const std::string SETTINGS_LOOP_TOASTS_PHASE         = "loop_toasts_phase";
 }
 
 namespace DefaultSetting
@@ -61,6 +87,10 @@ namespace DefaultSetting
         { SettingsKeys::SETTINGS_GPS_NUMSAT, DefaultSettingKey(SettingsSections::SECTION_SIMDATA, "12") },
         { SettingsKeys::SETTINGS_GPS_TIMEOUT, DefaultSettingKey(SettingsSections::SECTION_SIMDATA, "0") },
         { SettingsKeys::SETTINGS_GPS_GLITCH, DefaultSettingKey(SettingsSections::SECTION_SIMDATA, "0") },
+        { SettingsKeys::SETTINGS_GPS_RATE_HZ, DefaultSettingKey(SettingsSections::SECTION_SIMDATA, "5") },
+        { SettingsKeys::SETTINGS_GPS_LATENCY_MS, DefaultSettingKey(SettingsSections::SECTION_SIMDATA, "0") },
+        { SettingsKeys::SETTINGS_GPS_JITTER_MS, DefaultSettingKey(SettingsSections::SECTION_SIMDATA, "0") },
+        { SettingsKeys::SETTINGS_GPS_SEND_VELOCITIES, DefaultSettingKey(SettingsSections::SECTION_SIMDATA, "1") },
         { SettingsKeys::SETTINGS_MAG_FAILURE, DefaultSettingKey(SettingsSections::SECTION_SIMDATA, "0") },
         { SettingsKeys::SETTINGS_ATTITUDE_COPY_FROM_XPLANE, DefaultSettingKey(SettingsSections::SECTION_SIMDATA, "1") },
         { SettingsKeys::SETTINGS_BATTERY_EMULATION, DefaultSettingKey(SettingsSections::SECTION_SIMDATA, "0") },
@@ -74,12 +104,29 @@ namespace DefaultSetting
         { SettingsKeys::SETTINGS_HDZERO_OSD_FONT, DefaultSettingKey(SettingsSections::SECTION_OSD, "SNEAKY_FPV_INAV(6)_CONTRAX_1080_v1.1")},
         { SettingsKeys::SETTINGS_OSD_VISIBLE, DefaultSettingKey(SettingsSections::SECTION_OSD, "1") },
         { SettingsKeys::SETTINGS_OSD_FILTER_MODE, DefaultSettingKey(SettingsSections::SECTION_OSD, "0") },
+        { SettingsKeys::SETTINGS_OSD_DOUBLE_BUFFER, DefaultSettingKey(SettingsSections::SECTION_OSD, "1") },
         { SettingsKeys::SETTINGS_SITL_IP, DefaultSettingKey(SettingsSections::SECTION_GENERAL, "127.0.0.1")},
         { SettingsKeys::SETTINGS_SITL_PORT, DefaultSettingKey(SettingsSections::SECTION_GENERAL, "5760")},
         { SettingsKeys::SETTINGS_AUTODETECT_FC, DefaultSettingKey(SettingsSections::SECTION_GENERAL, "1")},
         { SettingsKeys::SETTINGS_COM_PORT, DefaultSettingKey(SettingsSections::SECTION_GENERAL, defaultComPort)},
         { SettingsKeys::SETTINGS_RESTART_ON_AIRPORT_LOAD, DefaultSettingKey(SettingsSections::SECTION_GENERAL, "1")},
         { SettingsKeys::SETTINGS_SIMULATE_RANGEFINDER, DefaultSettingKey(SettingsSections::SECTION_SIMDATA, "0")},
-        { SettingsKeys::SETTINGS_RSSI_SIMULATION, DefaultSettingKey(SettingsSections::SECTION_SIMDATA, "-1")}
+        { SettingsKeys::SETTINGS_RANGEFINDER_RATE_HZ, DefaultSettingKey(SettingsSections::SECTION_SIMDATA, "25")},
+        { SettingsKeys::SETTINGS_DEBUG_INTERPOLATION, DefaultSettingKey(SettingsSections::SECTION_SIMDATA, "0")},
+        { SettingsKeys::SETTINGS_RSSI_SIMULATION, DefaultSettingKey(SettingsSections::SECTION_SIMDATA, "-1")},
+        { SettingsKeys::SETTINGS_RSSI_TERRAIN, DefaultSettingKey(SettingsSections::SECTION_SIMDATA, "1")},
+        { SettingsKeys::SETTINGS_SENSOR_RATE_HZ, DefaultSettingKey(SettingsSections::SECTION_SIMDATA, "0")},
+        { SettingsKeys::SETTINGS_SENSOR_EXTRAPOLATION, DefaultSettingKey(SettingsSections::SECTION_SIMDATA, "0")},
+        { SettingsKeys::SETTINGS_SENSOR_NOISE, DefaultSettingKey(SettingsSections::SECTION_SIMDATA, "0")},
+        { SettingsKeys::SETTINGS_SENSOR_NOISE_SEED, DefaultSettingKey(SettingsSections::SECTION_SIMDATA, "1")},
+        { SettingsKeys::SETTINGS_LOCKSTEP, DefaultSettingKey(SettingsSections::SECTION_SIMDATA, "0")},
+        { SettingsKeys::SETTINGS_LOOP_SENSORS_INTERVAL, DefaultSettingKey(SettingsSections::SECTION_GENERAL, "-1")},
+        { SettingsKeys::SETTINGS_LOOP_SENSORS_PHASE, DefaultSettingKey(SettingsSections::SECTION_GENERAL, "1")},
+        { SettingsKeys::SETTINGS_LOOP_MSP_INTERVAL, DefaultSettingKey(SettingsSections::SECTION_GENERAL, "-1")},
+        { SettingsKeys::SETTINGS_LOOP_MSP_PHASE, DefaultSettingKey(SettingsSections::SECTION_GENERAL, "0")},
+        { SettingsKeys::SETTINGS_LOOP_STATISTICS_INTERVAL, DefaultSettingKey(SettingsSections::SECTION_GENERAL, "1")},
+        { SettingsKeys::SETTINGS_LOOP_STATISTICS_PHASE, DefaultSettingKey(SettingsSections::SECTION_GENERAL, "1")},
+        { SettingsKeys::SETTINGS_LOOP_TOASTS_INTERVAL, DefaultSettingKey(SettingsSections::SECTION_GENERAL, "0.1")},
+        { SettingsKeys::SETTINGS_LOOP_TOASTS_PHASE, DefaultSettingKey(SettingsSections::SECTION_GENERAL, "1")}
     };
 }
@@ -1,4 +1,5 @@
 #include "SettingsWindow.h"
+#include <algorithm>
 #include <cstring>
 
 #include <fa-solid-900.inc>
@@ -9,6 +10,8 @@
 #include "../core/PluginContext.h"
 #include "../core/EventBus.h"
 #include "../Utils.h"
+#include "../GpsReceiver.h"
+#include "../Rangefinder.h"
 
 std::shared_ptr<SettingsWindow> SettingsWindow::Instance = nullptr;
 
@@ -41,6 +44,7 @@ void SettingsWindow::loadSettings()
     restartOnAirportLoad = setting->GetSettingAs<bool>(SettingsSections::SECTION_GENERAL, SettingsKeys::SETTINGS_RESTART_ON_AIRPORT_LOAD, false);
     
     osdFilteringMode = setting->GetSettingAs<int>(SettingsSections::SECTION_OSD, SettingsKeys::SETTINGS_OSD_FILTER_MODE, 1);
+    osdDoubleBuffer = setting->GetSettingAs<bool>(SettingsSections::SECTION_OSD, SettingsKeys::SETTINGS_OSD_DOUBLE_BUFFER, true);
 
     std::string analogFont = setting->GetSettingAs<std::string>(SettingsSections::SECTION_OSD, SettingsKeys::SETTINGS_ANALOG_OSD_FONT, "");
     auto font = std::find(analogFonts.begin(), analogFonts.end(), analogFont);
@@ -88,6 +92,38 @@ void SettingsWindow::loadSettings()
 
     copyAttitudeFromXPlane = setting->GetSettingAs<bool>(SettingsSections::SECTION_SIMDATA, SettingsKeys::SETTINGS_ATTITUDE_COPY_FROM_XPLANE, true);
     muteBeeper = setting->GetSettingAs<bool>(SettingsSections::SECTION_GENERAL, SettingsKeys::SETTINGS_MUTE_BEEPER, true);
+
+    int sensorRateHz = setting->GetSettingAs<int>(SettingsSections::SECTION_SIMDATA, SettingsKeys::SETTINGS_SENSOR_RATE_HZ, 0);
+    auto rate = std::find(std::begin(SENSOR_RATES_HZ), std::end(SENSOR_RATES_HZ), sensorRateHz);
+    sensorRateIndex = rate != std::end(SENSOR_RATES_HZ) ? rate - std::begin(SENSOR_RATES_HZ) : 0;
+    sensorExtrapolation = setting->GetSettingAs<bool>(SettingsSections::SECTION_SIMDATA, SettingsKeys::SETTINGS_SENSOR_EXTRAPOLATION, false);
+    sensorNoiseSeed = setting->GetSettingAs<int>(SettingsSections::SECTION_SIMDATA, SettingsKeys::SETTINGS_SENSOR_NOISE_SEED, 1);
+    sensorNoise = std::clamp(setting->GetSettingAs<int>(SettingsSections::SECTION_SIMDATA, SettingsKeys::SETTINGS_SENSOR_NOISE, 0), 0, (int)IM_ARRAYSIZE(SENSOR_NOISE_LEVELS) - 1);
+    gpsRateHz = setting->GetSettingAs<int>(SettingsSections::SECTION_SIMDATA, SettingsKeys::SETTINGS_GPS_RATE_HZ, GpsReceiverConstants::DEFAULT_RATE_HZ);
+    gpsLatencyMs = setting->GetSettingAs<int>(SettingsSections::SECTION_SIMDATA, SettingsKeys::SETTINGS_GPS_LATENCY_MS, 0);
+    gpsJitterMs = setting->GetSettingAs<int>(SettingsSections::SECTION_SIMDATA, SettingsKeys::SETTINGS_GPS_JITTER_MS, 0);
+    gpsSendVelocities = setting->GetSettingAs<bool>(SettingsSections::SECTION_SIMDATA, SettingsKeys::SETTINGS_GPS_SEND_VELOCITIES, true);
+    lockstep = setting->GetSettingAs<bool>(SettingsSections::SECTION_SIMDATA, SettingsKeys::SETTINGS_LOCKSTEP, false);
+    rangefinderRateHz = setting->GetSettingAs<int>(SettingsSections::SECTION_SIMDATA, SettingsKeys::SETTINGS_RANGEFINDER_RATE_HZ, RangefinderConstants::DEFAULT_RATE_HZ);
+    debugInterpolation = setting->GetSettingAs<bool>(SettingsSections::SECTION_SIMDATA, SettingsKeys::SETTINGS_DEBUG_INTERPOLATION, false);
+
+    aircraftName = Utils::GetAircraftName();
+    aircraftSection = Utils::ToLower(SettingsSections::SECTION_AIRCRAFT_PREFIX + aircraftName);
+    std::string motor = setting->GetSettingAs<std::string>(aircraftSection, SettingsKeys::SETTINGS_AIRCRAFT_MOTOR, "");
+    std::string propeller = setting->GetSettingAs<std::string>(aircraftSection, SettingsKeys::SETTINGS_AIRCRAFT_PROPELLER, "");
+    propulsionIndex = 0;
+    for (size_t i = 1; i < propulsionMotors.size(); i++)
+    {
+        if (propulsionMotors[i] == motor && propulsionPropellers[i] == propeller)
+        {
+            propulsionIndex = i;
+            break;
+        }
+    }
+
+    std::string batteryPack = setting->GetSettingAs<std::string>(aircraftSection, SettingsKeys::SETTINGS_AIRCRAFT_BATTERY_PACK, "");
+    auto pack = std::find(batteryPacks.begin() + 1, batteryPacks.end(), batteryPack);
+    batteryPackIndex = pack != batteryPacks.end() ? pack - batteryPacks.begin() : 0;
 }
 
 void SettingsWindow::saveSettings()
@@ -101,6 +137,7 @@ void SettingsWindow::saveSettings()
     setting->SetSetting(SettingsSections::SECTION_GENERAL, SettingsKeys::SETTINGS_SITL_PORT, SITL_FIRST_PORT + sitlPortIndex);
 
     setting->SetSetting(SettingsSections::SECTION_OSD, SettingsKeys::SETTINGS_OSD_FILTER_MODE, osdFilteringMode);
+    setting->SetSetting(SettingsSections::SECTION_OSD, SettingsKeys::SETTINGS_OSD_DOUBLE_BUFFER, osdDoubleBuffer);
 
     setting->SetSetting(SettingsSections::SECTION_OSD, SettingsKeys::SETTINGS_ANALOG_OSD_FONT, std::string(analogFonts[analogFontIndex]));
     setting->SetSetting(SettingsSections::SECTION_OSD, SettingsKeys::SETTINGS_HDZERO_OSD_FONT, std::string(hdZeroFonts[hdZeroFontIndex]));
@@ -110,6 +147,20 @@ void SettingsWindow::saveSettings()
     setting->SetSetting(SettingsSections::SECTION_SIMDATA, SettingsKeys::SETTINGS_ATTITUDE_COPY_FROM_XPLANE, copyAttitudeFromXPlane);
     setting->SetSetting(SettingsSections::SECTION_GENERAL, SettingsKeys::SETTINGS_MUTE_BEEPER, muteBeeper);
     setting->SetSetting(SettingsSections::SECTION_GENERAL, SettingsKeys::SETTINGS_RESTART_ON_AIRPORT_LOAD, restartOnAirportLoad);
+    setting->SetSetting(SettingsSections::SECTION_SIMDATA, SettingsKeys::SETTINGS_SENSOR_RATE_HZ, SENSOR_RATES_HZ[sensorRateIndex]);
+    setting->SetSetting(SettingsSections::SECTION_SIMDATA, SettingsKeys::SETTINGS_SENSOR_EXTRAPOLATION, sensorExtrapolation);
+    setting->SetSetting(SettingsSections::SECTION_SIMDATA, SettingsKeys::SETTINGS_SENSOR_NOISE, sensorNoise);
+    setting->SetSetting(SettingsSections::SECTION_SIMDATA, SettingsKeys::SETTINGS_SENSOR_NOISE_SEED, sensorNoiseSeed);
+    setting->SetSetting(SettingsSections::SECTION_SIMDATA, SettingsKeys::SETTINGS_GPS_RATE_HZ, std::clamp(gpsRateHz, GpsReceiverConstants::MIN_RATE_HZ, GpsReceiverConstants::MAX_RATE_HZ));
+    setting->SetSetting(SettingsSections::SECTION_SIMDATA, SettingsKeys::SETTINGS_GPS_LATENCY_MS, std::clamp(gpsLatencyMs, 0, GpsReceiverConstants::MAX_LATENCY_MS));
+    setting->SetSetting(SettingsSections::SECTION_SIMDATA, SettingsKeys::SETTINGS_GPS_JITTER_MS, std::clamp(gpsJitterMs, 0, GpsReceiverConstants::MAX_JITTER_MS));
+    setting->SetSetting(SettingsSections::SECTION_SIMDATA, SettingsKeys::SETTINGS_GPS_SEND_VELOCITIES, gpsSendVelocities);
+    setting->SetSetting(SettingsSections::SECTION_SIMDATA, SettingsKeys::SETTINGS_LOCKSTEP, lockstep);
+    setting->SetSetting(SettingsSections::SECTION_SIMDATA, SettingsKeys::SETTINGS_RANGEFINDER_RATE_HZ, std::clamp(rangefinderRateHz, RangefinderConstants::MIN_RATE_HZ, RangefinderConstants::MAX_RATE_HZ));
+    setting->SetSetting(SettingsSections::SECTION_SIMDATA, SettingsKeys::SETTINGS_DEBUG_INTERPOLATION, debugInterpolation);
+    setting->SetSetting(aircraftSection, SettingsKeys::SETTINGS_AIRCRAFT_MOTOR, propulsionMotors[propulsionIndex]);
+    setting->SetSetting(aircraftSection, SettingsKeys::SETTINGS_AIRCRAFT_PROPELLER, propulsionPropellers[propulsionIndex]);
+    setting->SetSetting(aircraftSection, SettingsKeys::SETTINGS_AIRCRAFT_BATTERY_PACK, batteryPacks[batteryPackIndex]);
 
     setting->save();
 }
@@ -207,6 +258,34 @@ SettingsWindow::SettingsWindow(int left, int top, int right, int bot, XPLMWindow
     };
 
     Plugin()->GetEventBus()->Subscribe<FontEventArg>("FontLoaded", fontLoadedHandler);
+
+    propulsionMotors.push_back("");
+    propulsionPropellers.push_back("");
+    propulsionDisplayNames.push_back("Built-in (T-Motor AT2312 1400KV / APC 8x6)");
+    batteryPacks.push_back("");
+    batteryPacksDisplayNames.push_back("Built-in (3S LiPo 2200mAh)");
+
+    auto powerTrainCatalogEntryHandler = [this](const PowerTrainCatalogEntryEventArg &eventArg)
+    {
+        if (eventArg.type == "propulsion")
+        {
+            propulsionMotors.push_back(eventArg.name);
+            propulsionPropellers.push_back(eventArg.propeller);
+
+            std::string displayName = eventArg.name + " / " + eventArg.propeller;
+            propulsionDisplayNames.push_back(new char[displayName.size() + 1]);
+            std::strcpy(const_cast<char *>(propulsionDisplayNames.back()), displayName.c_str());
+        }
+        else if (eventArg.type == "pack")
+        {
+            batteryPacks.push_back(eventArg.name);
+
+            batteryPacksDisplayNames.push_back(new char[eventArg.name.size() + 1]);
+            std::strcpy(const_cast<char *>(batteryPacksDisplayNames.back()), eventArg.name.c_str());
+        }
+    };
+
+    Plugin()->GetEventBus()->Subscribe<PowerTrainCatalogEntryEventArg>("PowerTrainCatalogEntry", powerTrainCatalogEntryHandler);
 }
 
 SettingsWindow::~SettingsWindow()
@@ -278,6 +357,10 @@ void SettingsWindow::buildInterface()
     ImGui::SameLine();
     HelpMarker("Filtering mode for OSD textures when scaling. \"Auto\": best filtering mode will be selected automatically (\"Nearest\" for Analog, \"Linear\" for Digital OSD).");
 
+    ImGui::Checkbox("Tear-free OSD", &osdDoubleBuffer);
+    ImGui::SameLine();
+    HelpMarker("INAV sends the OSD in chunks over several updates. If checked, only complete OSD screens are shown, otherwise the OSD is drawn while it is updated and may show parts of two screens.");
+
     ImGui::Combo("Analog Font", &analogFontIndex, analogFontsDisplayNames.data(), analogFontsDisplayNames.size());
     ImGui::Combo("HDZero Font", &hdZeroFontIndex, hdZeroFontsDisplayNames.data(), hdZeroFontsDisplayNames.size());
     ImGui::Combo("Avatar / DJI O3 Font", &avatarFontIndex, avatarFontsDisplayNames.data(), avatarFontsDisplayNames.size());
@@ -296,6 +379,49 @@ void SettingsWindow::buildInterface()
     ImGui::Checkbox("Reboot INAV on X-Plane airport reload", &restartOnAirportLoad);
     ImGui::SameLine();
     HelpMarker("If enabled, INAV will be rebooted automatically when a new airport (new flight) is loaded in X-Plane.");
+    ImGui::Combo("HITL Sensor Update Rate", &sensorRateIndex, SENSOR_RATES, IM_ARRAYSIZE(SENSOR_RATES));
+    ImGui::SameLine();
+    HelpMarker("Rate at which sensor data is sent to the FC in HITL mode. \"X-Plane frame rate\": one packet per rendered frame. Fixed rates use a separate thread and give INAV evenly spaced samples.");
+    ImGui::Checkbox("Extrapolate between X-Plane frames", &sensorExtrapolation);
+    ImGui::SameLine();
+    HelpMarker("Only with a fixed sensor update rate. Attitude, gyroscope and accelerometer are extrapolated from the last X-Plane frames to the send time instead of repeating the last frame. Compare the attitude error in the \"Attitude estimation\" graph with and without.");
+    ImGui::Checkbox("Lockstep", &lockstep);
+    ImGui::SameLine();
+    HelpMarker("X-Plane waits for the FC reply after every sensor packet before it continues. No frames are dropped or processed twice, the simulation runs as fast as sim and FC manage together. Disables the fixed sensor update rate. Achieved steps per second: inav_xitl/lockstep/stepsPerSecond.");
+    ImGui::Combo("Sensor Noise", &sensorNoise, SENSOR_NOISE_LEVELS, IM_ARRAYSIZE(SENSOR_NOISE_LEVELS));
+    ImGui::SameLine();
+    HelpMarker("Adds noise to GPS, airspeed, accelerometer, gyroscope, magnetometer and barometer. \"High\" triples the noise and adds gyroscope bias, accelerometer scale errors, magnetometer quantization and GPS latency.");
+    ImGui::InputInt("Sensor Noise Seed", &sensorNoiseSeed);
+    ImGui::SameLine();
+    HelpMarker("The noise sequence restarts from this seed on every HITL connection. Same seed and same flight give the same sensor noise.");
+    ImGui::Checkbox("Interpolate debug[] values", &debugInterpolation);
+    ImGui::SameLine();
+    HelpMarker("INAV sends one of the eight debug[] values per reply. If enabled, the debug graphs and inav_xitl/debug show all eight values interpolated to the same moment, delayed by 7 replies. Otherwise they show the latest value of each.");
+
+    ImGui::Dummy(ImVec2(0.0f, 20.0f));
+    ImGui::Text("GPS Receiver");
+    ImGui::SliderInt("GPS Update Rate (Hz)", &gpsRateHz, GpsReceiverConstants::MIN_RATE_HZ, GpsReceiverConstants::MAX_RATE_HZ);
+    ImGui::SliderInt("GPS Latency (ms)", &gpsLatencyMs, 0, GpsReceiverConstants::MAX_LATENCY_MS);
+    ImGui::SameLine();
+    HelpMarker("Time from the position sample to the solution being sent to the FC. Typical u-blox receivers: 50-150 ms.");
+    ImGui::SliderInt("GPS Jitter (ms)", &gpsJitterMs, 0, GpsReceiverConstants::MAX_JITTER_MS);
+    ImGui::SameLine();
+    HelpMarker("Random additional latency per solution, 0 to this value. The order of the solutions is kept.");
+    ImGui::Checkbox("Send GPS velocities", &gpsSendVelocities);
+    ImGui::SameLine();
+    HelpMarker("Send the smoothed north/east/down velocities of the receiver. If disabled, zeros are sent and INAV calculates the velocities from the positions. With sensor noise enabled, the number of satellites and the HDOP vary over time.");
+    ImGui::SliderInt("Rangefinder Rate (Hz)", &rangefinderRateHz, RangefinderConstants::MIN_RATE_HZ, RangefinderConstants::MAX_RATE_HZ);
+    ImGui::SameLine();
+    HelpMarker("Measurement rate of the simulated rangefinder, independent of the X-Plane frame rate (at most one measurement per frame). The distance is measured along the aircraft's down axis, with a 10 degree beam.");
+
+    ImGui::Dummy(ImVec2(0.0f, 20.0f));
+    ImGui::Text("Power Train (%s)", aircraftName.c_str());
+    ImGui::SameLine();
+    HelpMarker("Saved per aircraft. Motors, propellers and battery packs come from the CSV files in assets/powertrain and can be extended without recompiling the plugin.");
+    ImGui::Combo("Motor / Propeller", &propulsionIndex, propulsionDisplayNames.data(), propulsionDisplayNames.size());
+    ImGui::Combo("Battery Pack", &batteryPackIndex, batteryPacksDisplayNames.data(), batteryPacksDisplayNames.size());
+    ImGui::SameLine();
+    HelpMarker("Used if \"Aircraft battery pack (Settings)\" is selected in the battery menu. The motor / propeller is used with every battery.");
 
     ImGui::Dummy(ImVec2(0.0f, 20.0f));
 
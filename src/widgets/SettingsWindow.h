@@ -31,6 +31,23 @@ static const char* OSD_MODES[] = {
     "Avatar (53x20)"
 };
 
+static const char* SENSOR_RATES[] = {
+    "X-Plane frame rate",
+    "100 Hz",
+    "200 Hz",
+    "250 Hz",
+    "500 Hz"
+};
+
+static constexpr int SENSOR_RATES_HZ[] = { 0, 100, 200, 250, 500 };
+
+// Index is the SETTINGS_SENSOR_NOISE value
+static const char* SENSOR_NOISE_LEVELS[] = {
+    "Off",
+    "Low",
+    "High"
+};
+
 class SettingsWindow : public ImgWindow
 {
 public:
@@ -64,6 +81,15 @@ private:
     std::vector<std::string> wtfOSFonts;
     std::vector<const char*> wtfOSFontsDisplayNames;
 
+    // Power train catalog, index 0 is the built-in default
+    std::vector<std::string> propulsionMotors;
+    std::vector<std::string> propulsionPropellers;
+    std::vector<const char*> propulsionDisplayNames;
+    std::vector<std::string> batteryPacks;
+    std::vector<const char*> batteryPacksDisplayNames;
+    std::string aircraftName;
+    std::string aircraftSection;
+
     bool ipAddressValid = true;
     bool hasInvalidIpAddressDecoration = false;
 
@@ -77,10 +103,24 @@ private:
     int sitlPortIndex = 0;
     char sitlIpAddress[16] = "127.0.0.1";
     int osdFilteringMode = 0;
+    bool osdDoubleBuffer = true;
     int analogFontIndex = 0;
     int hdZeroFontIndex = 0;
     int avatarFontIndex = 0;
     int wtfOSFontIndex = 0;
+    int sensorRateIndex = 0;
+    bool sensorExtrapolation = false;
+    int sensorNoise = 0;
+    int sensorNoiseSeed = 1;
+    int gpsRateHz = 5;
+    int gpsLatencyMs = 0;
+    int gpsJitterMs = 0;
+    bool gpsSendVelocities = true;
+    bool lockstep = false;
+    int rangefinderRateHz = 25;
+    bool debugInterpolation = false;
+    int propulsionIndex = 0;
+    int batteryPackIndex = 0;
 
     static void HelpMarker(const char* desc);
 
@@ -0,0 +1,236 @@
+// Predicts flight time, minimum voltage and remaining capacity of a power train for constant and random flight profiles.
+// Build with -DBUILD_TOOLS=ON, run ./endurance_calculator [--catalog assets/powertrain] [--motor name --propeller name] [--pack name]
+//                                                         [--profiles n] [--threads n] [--csv results.csv]
+// Without a catalog, the built-in T-Motor AT2312 / APC 8x6 with a 3S 2200 mAh LiPo is used.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "EnduranceEstimator.h"
+#include "PowerTrainCatalog.h"
+
+namespace EnduranceCalculatorConstants
+{
+    static constexpr int DEFAULT_PROFILES = 10000;
+    // Constant profile grid
+    static constexpr int GRID_THROTTLE_MIN = 20;
+    static constexpr int GRID_THROTTLE_STEP = 10;
+    static constexpr int GRID_ANGLE_MIN = -20;
+    static constexpr int GRID_ANGLE_STEP = 10;
+    static constexpr int GRID_ANGLES = 5;
+}
+
+// Full throttle climb, then cruise segments with random throttle and climb angle. Seeded with the
+// profile number, so the results are reproducible.
+static TFlightProfile randomProfile(unsigned int seed)
+{
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<double> climbAngle(10.0, 30.0);
+    std::uniform_real_distribution<double> cruiseThrottle(0.3, 0.8);
+    std::uniform_real_distribution<double> cruiseAngle(-10.0, 10.0);
+    std::uniform_int_distribution<int> climbSeconds(10, 40);
+    std::uniform_int_distribution<int> segmentSeconds(10, 120);
+    std::uniform_int_distribution<int> segments(4, 20);
+
+    TFlightProfile profile;
+    profile.sampleIntervalS = 1.0;
+    profile.samples.insert(profile.samples.end(), climbSeconds(random), {1.0, climbAngle(random)});
+    for (int i = segments(random); i > 0; i--)
+    {
+        profile.samples.insert(profile.samples.end(), segmentSeconds(random), {cruiseThrottle(random), cruiseAngle(random)});
+    }
+    return profile;
+}
+
+static double percentile(std::vector<double> values, double p)
+{
+    if (values.empty())
+    {
+        return 0.0;
+    }
+    const size_t index = std::min(values.size() - 1, static_cast<size_t>(p * values.size()));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+int main(int argc, char **argv)
+{
+    using namespace EnduranceCalculatorConstants;
+
+    std::string catalogDirectory;
+    std::string motor;
+    std::string propeller;
+    std::string packName;
+    std::string csvFile;
+    int profileCount = DEFAULT_PROFILES;
+    unsigned int threads = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const bool hasValue = i + 1 < argc;
+        if (!strcmp(argv[i], "--catalog") && hasValue)
+        {
+            catalogDirectory = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--motor") && hasValue)
+        {
+            motor = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--propeller") && hasValue)
+        {
+            propeller = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--pack") && hasValue)
+        {
+            packName = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--profiles") && hasValue)
+        {
+            profileCount = std::max(0, atoi(argv[++i]));
+        }
+        else if (!strcmp(argv[i], "--threads") && hasValue)
+        {
+            threads = static_cast<unsigned int>(std::max(0, atoi(argv[++i])));
+        }
+        else if (!strcmp(argv[i], "--csv") && hasValue)
+        {
+            csvFile = argv[++i];
+        }
+        else
+        {
+            printf("Usage: %s [--catalog dir] [--motor name --propeller name] [--pack name] [--profiles n] [--threads n] [--csv file]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // The power train references the tables, the catalog has to stay in scope
+    PowerTrainCatalog catalog;
+    const TPropulsion *propulsion = &PowerTrain::getBuiltInPropulsion();
+    const TBatteryChemistry *chemistry = &PowerTrain::getBuiltInChemistry(Lipo);
+    double capacityMah = PowerTrainConstants::DEFAULT_BATTERY_CAPACITY_MAH;
+    int cells = PowerTrainConstants::DEFAULT_BATTERY_CELLS;
+
+    if (!catalogDirectory.empty())
+    {
+        if (!catalog.load(catalogDirectory, std::filesystem::temp_directory_path() / "powertrain_catalog.bin"))
+        {
+            printf("Unable to load the catalog: %s\n", catalog.getError().c_str());
+            return 1;
+        }
+
+        if (!motor.empty() || !propeller.empty())
+        {
+            const TCatalogPropulsion *entry = catalog.findPropulsion(motor, propeller);
+            if (entry == nullptr)
+            {
+                printf("Motor / propeller \"%s\" / \"%s\" not in the catalog\n", motor.c_str(), propeller.c_str());
+                return 1;
+            }
+            propulsion = &entry->propulsion;
+        }
+
+        if (!packName.empty())
+        {
+            const TCatalogPack *pack = catalog.findPack(packName);
+            if (pack == nullptr)
+            {
+                printf("Battery pack \"%s\" not in the catalog\n", packName.c_str());
+                return 1;
+            }
+            chemistry = &catalog.getChemistry(*pack);
+            capacityMah = pack->capacityMah;
+            cells = pack->cells;
+        }
+    }
+    else if (!motor.empty() || !propeller.empty() || !packName.empty())
+    {
+        printf("--motor, --propeller and --pack need --catalog\n");
+        return 1;
+    }
+
+    const PowerTrain powerTrain(*chemistry, capacityMah, cells, *propulsion);
+
+    // Constant throttle / climb angle grid first, then the random profiles
+    std::vector<TFlightProfile> profiles;
+    const int gridThrottles = (100 - GRID_THROTTLE_MIN) / GRID_THROTTLE_STEP + 1;
+    for (int t = 0; t < gridThrottles; t++)
+    {
+        for (int a = 0; a < GRID_ANGLES; a++)
+        {
+            TFlightProfile profile;
+            profile.samples.push_back({(GRID_THROTTLE_MIN + t * GRID_THROTTLE_STEP) / 100.0, static_cast<double>(GRID_ANGLE_MIN + a * GRID_ANGLE_STEP)});
+            profiles.push_back(profile);
+        }
+    }
+    const size_t gridCount = profiles.size();
+    for (int i = 0; i < profileCount; i++)
+    {
+        profiles.push_back(randomProfile(i));
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const std::vector<TEnduranceResult> results = EnduranceEstimator::estimateAll(powerTrain, profiles, threads);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("%d cells, %.0f mAh, %zu profiles in %.2f s (%.0f profiles/s, %u threads)\n\n", cells, capacityMah, profiles.size(), seconds,
+           profiles.size() / seconds, threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency()));
+
+    printf("Flight time [min] at constant throttle / climb angle\n");
+    printf("Throttle");
+    for (int a = 0; a < GRID_ANGLES; a++)
+    {
+        printf("  %+4d deg", GRID_ANGLE_MIN + a * GRID_ANGLE_STEP);
+    }
+    printf("\n");
+    for (int t = 0; t < gridThrottles; t++)
+    {
+        printf("   %3d %%", GRID_THROTTLE_MIN + t * GRID_THROTTLE_STEP);
+        for (int a = 0; a < GRID_ANGLES; a++)
+        {
+            printf("  %8.1f", results[t * GRID_ANGLES + a].flightTimeS / 60.0);
+        }
+        printf("\n");
+    }
+
+    if (profileCount > 0)
+    {
+        std::vector<double> flightTimes;
+        std::vector<double> minVoltages;
+        for (size_t i = gridCount; i < results.size(); i++)
+        {
+            flightTimes.push_back(results[i].flightTimeS / 60.0);
+            minVoltages.push_back(results[i].minVoltage);
+        }
+        printf("\n%d random profiles           min      5 %%   median     95 %%      max\n", profileCount);
+        printf("Flight time [min]     %8.1f %8.1f %8.1f %8.1f %8.1f\n", percentile(flightTimes, 0.0), percentile(flightTimes, 0.05), percentile(flightTimes, 0.5),
+               percentile(flightTimes, 0.95), percentile(flightTimes, 1.0));
+        printf("Min voltage [V]       %8.2f %8.2f %8.2f %8.2f %8.2f\n", percentile(minVoltages, 0.0), percentile(minVoltages, 0.05), percentile(minVoltages, 0.5),
+               percentile(minVoltages, 0.95), percentile(minVoltages, 1.0));
+    }
+
+    if (!csvFile.empty())
+    {
+        FILE *file = fopen(csvFile.c_str(), "w");
+        if (file == nullptr)
+        {
+            printf("Unable to write %s\n", csvFile.c_str());
+            return 1;
+        }
+        fprintf(file, "profile,type,flight_time_s,min_voltage,remaining_capacity_mah,discharged\n");
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            fprintf(file, "%zu,%s,%.1f,%.3f,%.1f,%d\n", i, i < gridCount ? "constant" : "random", results[i].flightTimeS, results[i].minVoltage,
+                    results[i].remainingCapacityMah, results[i].discharged ? 1 : 0);
+        }
+        fclose(file);
+    }
+    return 0;
+}
@@ -0,0 +1,268 @@
+// Plays an OSD recorded with "Record OSD" without X-Plane, rendered as text.
+// Build with -DBUILD_TOOLS=ON, run ./osd_player recording.xosd [--at s] [--to s] [--every s] [--seeks n]
+// Without --at, the recording is summarized. --at prints the OSD at that time, with --to and --every
+// one screen per step. --seeks measures random seeks.
+// ./osd_player --self-test records a simulated session and checks that it plays back exactly.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "OsdRecording.h"
+
+namespace OsdPlayerConstants
+{
+    static constexpr int DEFAULT_SEEKS = 1000;
+
+    // Self test: 30 s at 10 frames per second, so the recording has several keyframe intervals
+    static constexpr int SELF_TEST_ROWS = 18;
+    static constexpr int SELF_TEST_COLS = 50;
+    static constexpr int SELF_TEST_FRAMES = 300;
+    static constexpr int64_t SELF_TEST_FRAME_US = 100000;
+    static constexpr int SELF_TEST_LAYOUT_CHANGE_FRAME = 150;
+}
+
+// INAV fonts have ASCII at the ASCII positions, everything else is a symbol
+static char cellToChar(uint16_t cell)
+{
+    const uint8_t c = static_cast<uint8_t>(cell >> 8);
+    const bool extended = (cell & (1 << 2)) != 0;
+    if (extended)
+    {
+        return '#';
+    }
+    if (c == 0x00 || c == 0x20)
+    {
+        return ' ';
+    }
+    return (c > 0x20 && c < 0x7F) ? static_cast<char>(c) : '#';
+}
+
+static void printScreen(const OsdRecordingReader &reader)
+{
+    const int rows = std::min(reader.getVisibleRows(), reader.getGridRows());
+    const int cols = std::min(reader.getVisibleCols(), reader.getGridCols());
+    const std::vector<uint16_t> &grid = reader.getGrid();
+
+    printf("%.1f s\n+%s+\n", reader.getTimeUs() / 1e6, std::string(cols, '-').c_str());
+    for (int row = 0; row < rows; row++)
+    {
+        std::string line;
+        for (int col = 0; col < cols; col++)
+        {
+            line += cellToChar(grid[row * reader.getGridCols() + col]);
+        }
+        printf("|%s|\n", line.c_str());
+    }
+    printf("+%s+\n", std::string(cols, '-').c_str());
+}
+
+// Records a session that starts with an OSD already on screen, like "Record OSD" while connected: the
+// first frame has no dirty bits. Later frames change a few cells with their dirty bits set (plus some
+// unchanged ones), the layout change frame changes cells without. Every frame must play back exactly,
+// read in order and after a seek.
+static int selfTest()
+{
+    using namespace OsdPlayerConstants;
+
+    const std::string fileName = (std::filesystem::temp_directory_path() / "osd_player_self_test.xosd").string();
+    OsdRecordingWriter writer;
+    if (!writer.open(fileName, SELF_TEST_ROWS, SELF_TEST_COLS))
+    {
+        printf("Unable to write %s\n", fileName.c_str());
+        return 1;
+    }
+
+    struct TExpectedFrame
+    {
+        int64_t timeUs;
+        int visibleRows;
+        int visibleCols;
+        std::vector<uint16_t> cells;
+    };
+
+    std::mt19937 random(0);
+    std::uniform_int_distribution<int> row(0, SELF_TEST_ROWS - 1);
+    std::uniform_int_distribution<int> col(0, SELF_TEST_COLS - 1);
+    std::uniform_int_distribution<int> cell(1, 0xFFFF);
+
+    std::vector<uint16_t> screen(SELF_TEST_ROWS * SELF_TEST_COLS, 0);
+    for (int i = 0; i < SELF_TEST_ROWS * SELF_TEST_COLS / 4; i++)
+    {
+        screen[row(random) * SELF_TEST_COLS + col(random)] = static_cast<uint16_t>(cell(random));
+    }
+
+    std::vector<TExpectedFrame> expected;
+    std::vector<uint64_t> dirtyRows(SELF_TEST_ROWS, 0);
+    int visibleRows = 16;
+    int visibleCols = 30;
+    for (int frame = 0; frame < SELF_TEST_FRAMES; frame++)
+    {
+        std::fill(dirtyRows.begin(), dirtyRows.end(), 0);
+        if (frame == SELF_TEST_LAYOUT_CHANGE_FRAME)
+        {
+            visibleRows = SELF_TEST_ROWS;
+            visibleCols = SELF_TEST_COLS;
+            for (int i = 0; i < 20; i++)
+            {
+                screen[row(random) * SELF_TEST_COLS + col(random)] = static_cast<uint16_t>(cell(random));
+            }
+        }
+        else if (frame > 0)
+        {
+            const int changes = frame % 10 == 0 ? 0 : 1 + frame % 7;
+            for (int i = 0; i < changes; i++)
+            {
+                const int r = row(random);
+                const int c = col(random);
+                screen[r * SELF_TEST_COLS + c] = (i % 3 == 0) ? 0 : static_cast<uint16_t>(cell(random));
+                dirtyRows[r] |= 1ULL << c;
+            }
+            dirtyRows[row(random)] |= 1ULL << col(random);
+        }
+
+        const int64_t timeUs = 1000000 + frame * SELF_TEST_FRAME_US;
+        writer.addFrame(timeUs, 0, visibleRows, visibleCols, screen.data(), dirtyRows.data());
+        expected.push_back({timeUs - 1000000, visibleRows, visibleCols, screen});
+    }
+    writer.close();
+
+    OsdRecordingReader reader;
+    if (!reader.open(fileName))
+    {
+        printf("Unable to read %s\n", fileName.c_str());
+        return 1;
+    }
+
+    auto matches = [&](const TExpectedFrame &frame)
+    {
+        return reader.getGrid() == frame.cells && reader.getVisibleRows() == frame.visibleRows && reader.getVisibleCols() == frame.visibleCols;
+    };
+
+    int failures = 0;
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+        reader.advanceTo(expected[i].timeUs);
+        if (!matches(expected[i]))
+        {
+            printf("Frame %zu differs when played in order\n", i);
+            failures++;
+        }
+    }
+    for (size_t i = expected.size(); i-- > 0;)
+    {
+        reader.seek(expected[i].timeUs);
+        if (!matches(expected[i]))
+        {
+            printf("Frame %zu differs after a seek\n", i);
+            failures++;
+        }
+    }
+
+    printf("Self test: %zu frames, %zu keyframes, %zu bytes, %s\n", expected.size(), reader.getKeyframeCount(), reader.getFileSize(),
+           failures == 0 ? "passed" : "FAILED");
+    reader.close();
+    std::filesystem::remove(fileName);
+    return failures == 0 ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+    using namespace OsdPlayerConstants;
+
+    if (argc < 2)
+    {
+        printf("Usage: %s recording.xosd [--at s] [--to s] [--every s] [--seeks n]\n       %s --self-test\n", argv[0], argv[0]);
+        return 1;
+    }
+
+    if (!strcmp(argv[1], "--self-test"))
+    {
+        return selfTest();
+    }
+
+    double at = -1.0;
+    double to = -1.0;
+    double every = 1.0;
+    int seeks = 0;
+    for (int i = 2; i < argc; i++)
+    {
+        const bool hasValue = i + 1 < argc;
+        if (!strcmp(argv[i], "--at") && hasValue)
+        {
+            at = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--to") && hasValue)
+        {
+            to = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--every") && hasValue)
+        {
+            every = std::max(0.01, atof(argv[++i]));
+        }
+        else if (!strcmp(argv[i], "--seeks") && hasValue)
+        {
+            seeks = std::max(0, atoi(argv[++i]));
+        }
+        else if (!strcmp(argv[i], "--seeks"))
+        {
+            seeks = DEFAULT_SEEKS;
+        }
+        else
+        {
+            printf("Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    OsdRecordingReader reader;
+    const auto openStart = std::chrono::steady_clock::now();
+    if (!reader.open(argv[1]))
+    {
+        printf("Unable to read %s\n", argv[1]);
+        return 1;
+    }
+    const double openMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - openStart).count();
+
+    if (at < 0.0)
+    {
+        int records = 0;
+        while (reader.next())
+        {
+            records++;
+        }
+        const double minutes = reader.getDurationUs() / 60e6;
+        printf("%s: %.1f min, %zu bytes (%.1f kB/min), %zu keyframes, %d records, %dx%d grid, opened in %.2f ms\n", argv[1], minutes,
+               reader.getFileSize(), minutes > 0.0 ? reader.getFileSize() / 1024.0 / minutes : 0.0, reader.getKeyframeCount(), records + 1,
+               reader.getGridCols(), reader.getGridRows(), openMs);
+    }
+    else
+    {
+        const int64_t endUs = static_cast<int64_t>((to >= at ? to : at) * 1e6);
+        for (int64_t timeUs = static_cast<int64_t>(at * 1e6); timeUs <= endUs; timeUs += static_cast<int64_t>(every * 1e6))
+        {
+            reader.advanceTo(timeUs);
+            printScreen(reader);
+        }
+    }
+
+    if (seeks > 0)
+    {
+        std::mt19937 random(0);
+        std::uniform_int_distribution<int64_t> time(0, reader.getDurationUs());
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < seeks; i++)
+        {
+            reader.seek(time(random));
+        }
+        const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        printf("%d random seeks, %.1f us per seek\n", seeks, us / seeks);
+    }
+    return 0;
+}
@@ -0,0 +1,313 @@
+// Plays a trace recorded with "Record Trace" into a flight controller or INAV SITL, without X-Plane.
+// Build with -DBUILD_TOOLS=ON, run ./trace_player trace.xtrace <serial device | host:port> [--realtime] [--timeout ms] [--threshold n]
+// Every packet waits for the reply (lockstep), the control outputs are compared with the recorded ones.
+// The exit code is 1 if any output differs by more than the threshold, to bisect firmware changes.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "SimTrace.h"
+
+namespace TracePlayerConstants
+{
+    static constexpr int DEFAULT_TIMEOUT_MS = 100;
+    // Control outputs are -500..500
+    static constexpr int DEFAULT_THRESHOLD = 20;
+    static constexpr int OUTPUT_AXES = 4;
+}
+
+static int64_t nowUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static int openConnection(const std::string &target)
+{
+    const size_t colon = target.rfind(':');
+    if (target[0] != '/' && colon != std::string::npos)
+    {
+        addrinfo hints = {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo *result = nullptr;
+        if (getaddrinfo(target.substr(0, colon).c_str(), target.substr(colon + 1).c_str(), &hints, &result) != 0)
+        {
+            return -1;
+        }
+
+        int fd = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+        if (fd >= 0 && connect(fd, result->ai_addr, result->ai_addrlen) != 0)
+        {
+            close(fd);
+            fd = -1;
+        }
+        freeaddrinfo(result);
+        return fd;
+    }
+
+    const int fd = open(target.c_str(), O_RDWR | O_NOCTTY);
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    termios tty = {};
+    tcgetattr(fd, &tty);
+    cfmakeraw(&tty);
+    cfsetispeed(&tty, B115200);
+    cfsetospeed(&tty, B115200);
+    tty.c_cflag |= CLOCAL | CREAD;
+    tcsetattr(fd, TCSANOW, &tty);
+    tcflush(fd, TCIOFLUSH);
+    return fd;
+}
+
+static uint8_t crc8_dvb_s2(uint8_t crc, uint8_t a)
+{
+    crc ^= a;
+    for (int i = 0; i < 8; i++)
+    {
+        crc = (crc & 0x80) ? (crc << 1) ^ 0xD5 : crc << 1;
+    }
+    return crc;
+}
+
+static bool sendMspV2(int fd, uint16_t code, const uint8_t *payload, uint16_t length)
+{
+    std::vector<uint8_t> frame = {'$', 'X', '<', 0, static_cast<uint8_t>(code & 0xFF), static_cast<uint8_t>(code >> 8), static_cast<uint8_t>(length & 0xFF), static_cast<uint8_t>(length >> 8)};
+    frame.insert(frame.end(), payload, payload + length);
+
+    uint8_t crc = 0;
+    for (size_t i = 3; i < frame.size(); i++)
+    {
+        crc = crc8_dvb_s2(crc, frame[i]);
+    }
+    frame.push_back(crc);
+
+    return write(fd, frame.data(), frame.size()) == static_cast<ssize_t>(frame.size());
+}
+
+// Reads until a valid MSP V2 reply with the given code arrived, other frames are skipped
+static bool receiveMspV2(int fd, uint16_t code, int64_t deadlineUs, std::vector<uint8_t> &buffer, std::vector<uint8_t> &payload)
+{
+    while (true)
+    {
+        // Parse what's buffered
+        size_t start = 0;
+        while (start + 9 <= buffer.size())
+        {
+            if (buffer[start] != '$' || buffer[start + 1] != 'X' || (buffer[start + 2] != '>' && buffer[start + 2] != '!'))
+            {
+                start++;
+                continue;
+            }
+
+            const uint16_t frameCode = buffer[start + 4] | (buffer[start + 5] << 8);
+            const uint16_t length = buffer[start + 6] | (buffer[start + 7] << 8);
+            if (start + 9 + length > buffer.size())
+            {
+                break;
+            }
+
+            uint8_t crc = 0;
+            for (size_t i = start + 3; i < start + 8 + length; i++)
+            {
+                crc = crc8_dvb_s2(crc, buffer[i]);
+            }
+
+            const bool valid = crc == buffer[start + 8 + length] && buffer[start + 2] == '>';
+            if (valid && frameCode == code)
+            {
+                payload.assign(buffer.begin() + start + 8, buffer.begin() + start + 8 + length);
+                buffer.erase(buffer.begin(), buffer.begin() + start + 9 + length);
+                return true;
+            }
+            start += valid ? 9 + length : 1;
+        }
+        buffer.erase(buffer.begin(), buffer.begin() + start);
+
+        const int64_t remainingUs = deadlineUs - nowUs();
+        if (remainingUs <= 0)
+        {
+            return false;
+        }
+
+        pollfd pfd = {fd, POLLIN, 0};
+        if (poll(&pfd, 1, static_cast<int>((remainingUs + 999) / 1000)) <= 0)
+        {
+            return false;
+        }
+
+        uint8_t chunk[512];
+        const ssize_t received = read(fd, chunk, sizeof(chunk));
+        if (received <= 0)
+        {
+            return false;
+        }
+        buffer.insert(buffer.end(), chunk, chunk + received);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        printf("Usage: %s trace.xtrace <serial device | host:port> [--realtime] [--timeout ms] [--threshold n]\n", argv[0]);
+        return 2;
+    }
+
+    bool realtime = false;
+    int timeoutMs = TracePlayerConstants::DEFAULT_TIMEOUT_MS;
+    int threshold = TracePlayerConstants::DEFAULT_THRESHOLD;
+    for (int i = 3; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--realtime") == 0)
+        {
+            realtime = true;
+        }
+        else if (strcmp(argv[i], "--timeout") == 0 && i + 1 < argc)
+        {
+            timeoutMs = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc)
+        {
+            threshold = atoi(argv[++i]);
+        }
+    }
+
+    SimTraceReader reader;
+    if (!reader.open(argv[1]))
+    {
+        printf("Unable to read trace %s\n", argv[1]);
+        return 2;
+    }
+    for (const std::string &column : reader.getUnknownColumns())
+    {
+        printf("Skipping unknown column %s\n", column.c_str());
+    }
+
+    const int fd = openConnection(argv[2]);
+    if (fd < 0)
+    {
+        printf("Unable to connect to %s\n", argv[2]);
+        return 2;
+    }
+
+    static const char *AXIS_NAMES[TracePlayerConstants::OUTPUT_AXES] = {"roll", "pitch", "yaw", "throttle"};
+    double squaredError[TracePlayerConstants::OUTPUT_AXES] = {};
+    int maxError[TracePlayerConstants::OUTPUT_AXES] = {};
+    int compared = 0;
+    int firstDivergence = -1;
+
+    int packets = 0;
+    int timeouts = 0;
+    int64_t latencySumUs = 0;
+    int64_t latencyMaxUs = 0;
+
+    std::vector<uint8_t> receiveBuffer;
+    std::vector<uint8_t> payload;
+    uint32_t lastGpsSequence = 0;
+    int64_t traceStartUs = 0;
+    const int64_t playStartUs = nowUs();
+
+    TTraceRow row;
+    while (reader.read(row))
+    {
+        if (packets == 0)
+        {
+            traceStartUs = row.timeUs;
+            lastGpsSequence = row.snapshot.gpsSequence - 1;
+        }
+        if (realtime)
+        {
+            const int64_t waitUs = (row.timeUs - traceStartUs) - (nowUs() - playStartUs);
+            if (waitUs > 0)
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(waitUs));
+            }
+        }
+
+        const bool hasNewGpsData = row.snapshot.gpsSequence != lastGpsSequence;
+        lastGpsSequence = row.snapshot.gpsSequence;
+        const TMSPSimulatorToINAV packet = SensorPacket::encode(row.snapshot, hasNewGpsData);
+
+        const int64_t sentUs = nowUs();
+        if (!sendMspV2(fd, MSP_SIMULATOR, reinterpret_cast<const uint8_t *>(&packet), sizeof(packet)))
+        {
+            printf("Connection lost after %d packets\n", packets);
+            break;
+        }
+        packets++;
+
+        if (!receiveMspV2(fd, MSP_SIMULATOR, sentUs + timeoutMs * 1000LL, receiveBuffer, payload) ||
+            payload.size() < MSPConstants::MSP_SIMULATOR_RESPOSE_MIN_LENGTH)
+        {
+            timeouts++;
+            continue;
+        }
+
+        const int64_t latencyUs = nowUs() - sentUs;
+        latencySumUs += latencyUs;
+        latencyMaxUs = std::max(latencyMaxUs, latencyUs);
+
+        TMSPSimulatorFromINAV reply = {};
+        std::memcpy(&reply, payload.data(), std::min(payload.size(), sizeof(reply)));
+
+        // Rows without a recorded reply have nothing to compare with
+        if (row.replyTimeUs == 0)
+        {
+            continue;
+        }
+
+        const int errors[TracePlayerConstants::OUTPUT_AXES] = {
+            reply.roll - row.outputRoll,
+            reply.pitch - row.outputPitch,
+            reply.yaw - row.outputYaw,
+            reply.throttle - row.outputThrottle};
+        for (int axis = 0; axis < TracePlayerConstants::OUTPUT_AXES; axis++)
+        {
+            squaredError[axis] += static_cast<double>(errors[axis]) * errors[axis];
+            maxError[axis] = std::max(maxError[axis], abs(errors[axis]));
+            if (firstDivergence < 0 && abs(errors[axis]) > threshold)
+            {
+                firstDivergence = packets - 1;
+            }
+        }
+        compared++;
+    }
+    close(fd);
+
+    const int replies = packets - timeouts;
+    printf("%d packets, %d replies, %d timeouts\n", packets, replies, timeouts);
+    if (replies > 0)
+    {
+        printf("Reply latency: mean %.2f ms, max %.2f ms\n", latencySumUs / 1000.0 / replies, latencyMaxUs / 1000.0);
+    }
+    if (compared > 0)
+    {
+        for (int axis = 0; axis < TracePlayerConstants::OUTPUT_AXES; axis++)
+        {
+            printf("Output %-8s RMS difference %7.2f, max %4d\n", AXIS_NAMES[axis], sqrt(squaredError[axis] / compared), maxError[axis]);
+        }
+    }
+    if (firstDivergence >= 0)
+    {
+        printf("First difference above %d at packet %d\n", threshold, firstDivergence);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,47 @@
+// Precomputes the magnetic field grid used for the simulated magnetometer from a WMM coefficient file.
+// Build with -DBUILD_TOOLS=ON, run ./wmm_grid_generator WMM.COF assets/wmm_grid.bin [year] [step degrees]
+// WMM.COF is available from https://www.ncei.noaa.gov/products/world-magnetic-model
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "MagneticModel.h"
+
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        printf("Usage: %s WMM.COF output.bin [year] [step degrees]\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<TMagneticCoefficient> coefficients;
+    float epoch = 0.0f;
+    if (!MagneticModel::parseCoefficientFile(argv[1], coefficients, epoch))
+    {
+        printf("Unable to read coefficients from %s\n", argv[1]);
+        return 1;
+    }
+
+    const float year = argc > 3 ? static_cast<float>(atof(argv[3])) : MagneticModel::currentDecimalYear();
+    const float step = argc > 4 ? static_cast<float>(atof(argv[4])) : MagneticModelConstants::DEFAULT_GRID_STEP_DEG;
+    if (step <= 0.0f || step > 90.0f)
+    {
+        printf("Invalid grid step %.2f\n", step);
+        return 1;
+    }
+
+    MagneticModel model;
+    model.build(coefficients, epoch, year, step);
+    if (!model.save(argv[2]))
+    {
+        printf("Unable to write %s\n", argv[2]);
+        return 1;
+    }
+
+    printf("%zu coefficients, epoch %.1f, year %.2f, step %.2f deg -> %s\n", coefficients.size(), epoch, year, step, argv[2]);
+
+    const TMagneticField field = model.lookup(48.1, 11.6);
+    printf("Check 48.1N 11.6E: declination %.2f, inclination %.2f, intensity %.0f nT\n", field.declination, field.inclination, field.intensity);
+    return 0;
+}